@@ -40,7 +40,9 @@
 #include <memory>
 
 #include "executor/Executor.hxx"
+#include "executor/ExecutorPool.hxx"
 #include "executor/Service.hxx"
+#include "openmrn_features.h"
 #include "os/os.h"
 #include "utils/ClientConnection.hxx"
 #include "utils/GcTcpHub.hxx"
@@ -49,6 +51,12 @@
 #include "utils/SocketCan.hxx"
 #include "utils/constants.hxx"
 
+#if OPENMRN_HAVE_EXECUTOR_PROFILE
+#include "console/Console.hxx"
+#include "console/ExecutorCommands.hxx"
+#include "executor/ExecutorProfile.hxx"
+#endif
+
 Executor<1> g_executor("g_executor", 0, 1024);
 Service g_service(&g_executor);
 CanHubFlow can_hub0(&g_service);
@@ -74,6 +82,11 @@ bool timestamped = false;
 bool export_mdns = false;
 const char* mdns_name = "openmrn_hub";
 bool printpackets = false;
+unsigned num_threads = 0;
+#if OPENMRN_HAVE_EXECUTOR_PROFILE
+int console_port = -1;
+unsigned profile_log_sec = 0;
+#endif
 
 void usage(const char *e)
 {
@@ -83,7 +96,11 @@ void usage(const char *e)
 #if defined(__linux__)
         "[-s socketcan_interface] "
 #endif
-        "[-t] [-l]\n\n",
+        "[-t] [-l] [-j threads] "
+#if OPENMRN_HAVE_EXECUTOR_PROFILE
+        "[-c console_port] [-P seconds]"
+#endif
+        "\n\n",
         e);
     fprintf(stderr,
         "GridConnect CAN HUB.\nListens to a specific TCP port, "
@@ -108,6 +125,19 @@ void usage(const char *e)
             "\t-t prints timestamps for each packet.\n");
     fprintf(stderr,
             "\t-l print all packets.\n");
+    fprintf(stderr,
+            "\t-j threads   distributes the TCP clients' gridconnect "
+            "processing to this many worker threads. The default is to do "
+            "everything on the main executor thread.\n");
+#if OPENMRN_HAVE_EXECUTOR_PROFILE
+    fprintf(stderr,
+            "\t-c console_port   opens a telnet console on this port. The "
+            "'profile' command prints the run times of the main executor's "
+            "flows.\n");
+    fprintf(stderr,
+            "\t-P seconds   logs the run times of the main executor's flows "
+            "this often.\n");
+#endif
 #ifdef HAVE_AVAHI_CLIENT
     fprintf(stderr,
             "\t-m exports the current service on mDNS.\n");
@@ -120,7 +150,7 @@ void usage(const char *e)
 void parse_args(int argc, char *argv[])
 {
     int opt;
-    while ((opt = getopt(argc, argv, "hp:d:s:u:q:tlmn:")) >= 0)
+    while ((opt = getopt(argc, argv, "hp:d:s:u:q:tlmn:j:c:P:")) >= 0)
     {
         switch (opt)
         {
@@ -157,6 +187,17 @@ void parse_args(int argc, char *argv[])
             case 'l':
                 printpackets = true;
                 break;
+            case 'j':
+                num_threads = atoi(optarg);
+                break;
+#if OPENMRN_HAVE_EXECUTOR_PROFILE
+            case 'c':
+                console_port = atoi(optarg);
+                break;
+            case 'P':
+                profile_log_sec = atoi(optarg);
+                break;
+#endif
             default:
                 fprintf(stderr, "Unknown option %c\n", opt);
                 usage(argv[0]);
@@ -178,9 +219,30 @@ int appl_main(int argc, char *argv[])
         packet_printer = new GcPacketPrinter(&can_hub0, timestamped);
     }
     fprintf(stderr,"packet_printer points to %p\n",packet_printer);
-    GcTcpHub hub(&can_hub0, port);
+    std::unique_ptr<ExecutorPool> pool;
+    if (num_threads)
+    {
+        pool.reset(new ExecutorPool("hub_pool", num_threads, 0, 1024));
+    }
+    GcTcpHub hub(&can_hub0, port, pool.get());
     vector<std::unique_ptr<ConnectionClient>> connections;
 
+#if OPENMRN_HAVE_EXECUTOR_PROFILE
+    if (console_port >= 0)
+    {
+        // The console runs on its own thread, so that it does not show up in
+        // the profile of the main executor.
+        ExecutorBase *console_executor =
+            new Executor<1>("console", 0, 1024);
+        Console *console = new Console(console_executor, console_port);
+        new ExecutorCommands(console, &g_executor);
+    }
+    if (profile_log_sec)
+    {
+        new ExecutorProfileLog(&g_service, SEC_TO_NSEC(profile_log_sec));
+    }
+#endif
+
 #ifdef HAVE_AVAHI_CLIENT
     void mdns_client_start();
     void mdns_publish(const char *name, uint16_t port);
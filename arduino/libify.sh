@@ -194,7 +194,7 @@ copy_file src/dcc src/dcc/*.hxx src/dcc/*.h src/dcc/{Defs,dcc_constants,DccDebug
 copy_file src/dcc src/dcc/{RailCom,RailcomBroadcastDecoder,RailcomDebug}.cxx
 
 # Command Station DCC related files
-copy_file src/dcc src/dcc/{Loco,SimpleUpdateLoop,UpdateLoop}.cxx
+copy_file src/dcc src/dcc/{Loco,PriorityUpdateLoop,SimpleUpdateLoop,UpdateLoop}.cxx
 
 # remove test framework related file
 rm -f ${TARGET_LIB_DIR}/src/dcc/dcc_test_utils.hxx
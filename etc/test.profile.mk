@@ -0,0 +1,9 @@
+# Host test target with the opt-in executor profiling compiled in
+# (OPENMRN_EXECUTOR_PROFILE, see include/openmrn_features.h). The define
+# changes the layout of Executable, so the libraries are built separately
+# from targets/test.
+
+include $(OPENMRNPATH)/etc/test.mk
+
+CFLAGS += -DOPENMRN_EXECUTOR_PROFILE
+CXXFLAGS += -DOPENMRN_EXECUTOR_PROFILE
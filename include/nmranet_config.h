@@ -71,6 +71,24 @@ DECLARE_CONST(main_thread_stack_size);
  */
 DECLARE_CONST(executor_select_prescaler);
 
+/** Which facility the executors use for waiting on file descriptors. 0:
+ * select, 1: level-triggered epoll, 2: edge-triggered epoll. Values other
+ * than 0 are only honored on Linux. See ExecutorBase::SelectBackend.
+ */
+DECLARE_CONST(executor_select_backend);
+
+/** Set to 1 to make the executors keep their timers in a hierarchical timing
+ * wheel instead of a sorted list. Only honored on host platforms. See
+ * ActiveTimers::set_timer_wheel().
+ */
+DECLARE_CONST(executor_timer_wheel);
+
+/** Set to 1 to make the executors record the run count and run time of every
+ * Executable class. Only honored on host platforms. See
+ * ExecutorBase::set_profile().
+ */
+DECLARE_CONST(executor_profile);
+
 /** Max select sleep time (in msec).
  *
  * Executors will sleep at most this much time before checking that something
@@ -78,6 +96,12 @@ DECLARE_CONST(executor_select_prescaler);
  */
 DECLARE_CONST(executor_max_sleep_msec);
 
+/** If nonzero, the main buffer pool keeps per-thread caches of free buffers,
+ * with at most this many buffers per size bucket in each thread. Only
+ * honored on Linux and Mac. See DynamicPool::enable_thread_cache().
+ */
+DECLARE_CONST(buffer_thread_cache_size);
+
 /** Number of packets to queue in the CANbus device driver for send. Each packet
  * takes 16 bytes of RAM. */
 DECLARE_CONST(can_tx_buffer_size);
@@ -136,6 +160,16 @@ DECLARE_CONST(directhub_port_max_incoming_packets);
 /// will allocate at least this many bytes dedicated for each input port.
 DECLARE_CONST(directhub_port_incoming_buffer_size);
 
+/// Number of bytes that a single source may send to a DirectHub in one turn of
+/// the admission controller. After this the source has to yield and wait for
+/// the other sources to have their turn. 0 = unlimited.
+DECLARE_CONST(directhub_source_byte_budget);
+
+/// Number of packets that a single source may send to a DirectHub in one turn
+/// of the admission controller. After this the source has to yield and wait
+/// for the other sources to have their turn. 0 = unlimited.
+DECLARE_CONST(directhub_source_packet_budget);
+
 /** Number of entries in the remote alias cache */
 DECLARE_CONST(remote_alias_cache_size);
 
@@ -157,6 +191,12 @@ DECLARE_CONST(num_datagram_registry_entries);
  * happen concurrently. */
 DECLARE_CONST(num_datagram_clients);
 
+/** If non-zero, the datagram clients of the CAN stack are proxies of a
+ * DatagramClientPool, which sends datagrams to different destinations in
+ * parallel. Each client then costs only a few bytes, so num_datagram_clients
+ * can be set to the number of remote nodes talked to concurrently. */
+DECLARE_CONST(datagram_client_pool);
+
 /** Number of stream senders. This is how many stream send operations can
  * happen concurrently. */
 DECLARE_CONST(num_stream_senders);
@@ -182,6 +222,16 @@ DECLARE_CONST(bulk_alias_num_can_frames);
  * StreamReceiver }. */
 DECLARE_CONST(stream_receiver_default_window_size);
 
+/** Percentage of the stream window that has to arrive before { @ref
+ * StreamReceiver } grants the next window with a Stream Proceed message. 100
+ * waits for the entire window to arrive (stop-and-wait). */
+DECLARE_CONST(stream_receiver_early_proceed_percent);
+
+/** Largest config file (in bytes) that { @ref ConfigFileSnapshot } copies to
+ * the heap on platforms where the file cannot be mapped into memory. 0
+ * disables the heap copy; config reads then go to the file system. */
+DECLARE_CONST(snapshot_max_heap_size);
+
 /** Stack size for @ref SocketListener threads. */
 DECLARE_CONST(socket_listener_stack_size);
 
@@ -81,6 +81,54 @@
 #define OPENMRN_HAVE_PSELECT 1
 #endif
 
+#if defined(__linux__) && defined(OPENMRN_HAVE_PSELECT) &&                   \
+    !defined(__EMSCRIPTEN__)
+/// Compiles the ::epoll_pwait based backend for the Executor's Selectable
+/// registry (see ExecutorBase::set_select_backend()).
+#define OPENMRN_HAVE_EPOLL 1
+#endif
+
+#if defined(__linux__) || defined(__MACH__)
+/// Compiles the per-thread free buffer caches of DynamicPool (see
+/// DynamicPool::enable_thread_cache()).
+#define OPENMRN_HAVE_BUFFER_THREAD_CACHE 1
+#endif
+
+#if defined(__linux__) || defined(__MACH__)
+/// Maps the configuration file into memory for the duration of a config
+/// update pass (see ConfigFileSnapshot).
+#define OPENMRN_HAVE_MMAP 1
+#endif
+
+#if defined(__linux__) || defined(__MACH__) || defined(__WINNT__)
+/// Compiles the hierarchical timing wheel backend for the executor's timers
+/// (see ActiveTimers::set_timer_wheel()).
+#define OPENMRN_HAVE_TIMER_WHEEL 1
+#endif
+
+#if defined(OPENMRN_FLAT_EVENT_REGISTRY)
+/// EventService keeps the event handlers in a FlatEventHandlers registry
+/// instead of TreeEventHandlers.
+#define OPENMRN_HAVE_FLAT_EVENT_REGISTRY 1
+#endif
+
+#if defined(OPENMRN_HASH_REMOTE_ALIAS_CACHE)
+/// IfCan uses the constant time HashAliasCache for the remote aliases, for
+/// gateways that track thousands of remote nodes. This changes the layout of
+/// IfCan, so OPENMRN_HASH_REMOTE_ALIAS_CACHE has to be defined for the entire
+/// build (in the compiler flags), never in individual source files.
+#define OPENMRN_HAVE_HASH_REMOTE_ALIAS_CACHE 1
+#endif
+
+#if defined(OPENMRN_EXECUTOR_PROFILE) &&                                       \
+    (defined(__linux__) || defined(__MACH__)) && !defined(__EMSCRIPTEN__)
+/// Compiles the per-Executable run time accounting of the executors (see
+/// ExecutorBase::set_profile()). This adds an enqueue timestamp to every
+/// Executable, so OPENMRN_EXECUTOR_PROFILE has to be defined for the entire
+/// build (in the compiler flags), never in individual source files.
+#define OPENMRN_HAVE_EXECUTOR_PROFILE 1
+#endif
+
 #if defined(__WINNT__) || defined(ESP_PLATFORM) || defined(ESP_NONOS)
 /// Uses ::select in the executor to sleep (unsure how wakeup is handled)
 #define OPENMRN_HAVE_SELECT 1
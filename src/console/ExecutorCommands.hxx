@@ -0,0 +1,115 @@
+/** @copyright
+ * Copyright (c) 2026, Balazs Racz
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  - Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  - Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file ExecutorCommands.hxx
+ * Console commands to inspect the run time of an executor's Executables.
+ *
+ * @author Balazs Racz
+ * @date 17 Oct 2026
+ */
+
+#ifndef _CONSOLE_EXECUTORCOMMANDS_HXX_
+#define _CONSOLE_EXECUTORCOMMANDS_HXX_
+
+#include "console/Console.hxx"
+#include "executor/ExecutorProfile.hxx"
+
+#if OPENMRN_HAVE_EXECUTOR_PROFILE
+
+/// Container for the executor commands.
+/// This class can be used by intantiating an instance of ExecutorCommands and
+/// passing to the constructor a @ref Console instance pointer and the executor
+/// to inspect. The command "profile" will be added to the @ref Console
+/// instance.
+class ExecutorCommands
+{
+public:
+    /// Constructor.
+    /// @param console console instance to add the commands to
+    /// @param executor the executor whose Executables to report on
+    ExecutorCommands(Console *console, ExecutorBase *executor)
+    {
+        console->add_command("profile", profile_command, executor);
+    }
+
+private:
+    /// Prints, turns on/off or clears the per-Executable run times.
+    /// @param fp file pointer to console
+    /// @param argc number of arguments including the command itself
+    /// @param argv array of arguments starting with the command itself
+    /// @param context the ExecutorBase to inspect
+    /// @return COMMAND_OK, or COMMAND_ERROR for an unknown argument
+    static Console::CommandStatus profile_command(
+        FILE *fp, int argc, const char *argv[], void *context)
+    {
+        if (argc == 0)
+        {
+            fprintf(fp,
+                "print executable run times; 'profile on|off|reset' "
+                "controls recording\n");
+            return Console::COMMAND_OK;
+        }
+        ExecutorBase *executor = static_cast<ExecutorBase *>(context);
+        string arg = argc > 1 ? argv[1] : "";
+        if (argc > 2 ||
+            (argc == 2 && arg != "on" && arg != "off" && arg != "reset"))
+        {
+            fprintf(fp, "usage: %s [on|off|reset]\n", argv[0]);
+            return Console::COMMAND_ERROR;
+        }
+        string output;
+        // The table may only be touched on the executor's thread.
+        executor->sync_run([executor, &arg, &output]() {
+            if (arg == "on" || arg == "off")
+            {
+                executor->set_profile(arg == "on");
+                return;
+            }
+            ExecutorProfile *p = executor->profile();
+            if (!p)
+            {
+                output = "profiling is off\n";
+                return;
+            }
+            if (arg == "reset")
+            {
+                p->clear();
+                return;
+            }
+            std::vector<ExecutorProfile::Entry> entries;
+            p->snapshot(&entries);
+            output = ExecutorProfile::format(entries, 1000);
+        });
+        fputs(output.c_str(), fp);
+        return Console::COMMAND_OK;
+    }
+
+    DISALLOW_COPY_AND_ASSIGN(ExecutorCommands);
+};
+
+#endif // OPENMRN_HAVE_EXECUTOR_PROFILE
+
+#endif // _CONSOLE_EXECUTORCOMMANDS_HXX_
@@ -44,6 +44,8 @@ namespace dcc
 {
 
 /// StateFlow that accepts dcc::Packet structures and drops them to the floor.
+/// Every packet occupies the fake track for a given time, which makes this
+/// usable as a simulated track when testing update loops.
 class FakeTrackIf : public StateFlow<Buffer<dcc::Packet>, QList<1>>
 {
 public:
@@ -51,9 +53,12 @@ public:
     ///
     /// @param service defines which executor *this should be running on.
     /// @param pool_size how many packets we should generate ahead of time.
-    FakeTrackIf(Service *service, int pool_size)
+    /// @param packet_time_nsec how long each packet takes to send.
+    FakeTrackIf(Service *service, int pool_size,
+        long long packet_time_nsec = MSEC_TO_NSEC(10))
         : StateFlow<Buffer<dcc::Packet>, QList<1>>(service)
         , pool_(sizeof(Buffer<dcc::Packet>), pool_size)
+        , packetTimeNsec_(packet_time_nsec)
     {
     }
 
@@ -65,7 +70,15 @@ public:
 protected:
     Action entry() OVERRIDE
     {
-        return sleep_and_call(&timer_, MSEC_TO_NSEC(10), STATE(finish));
+        packet_sent(message()->data());
+        return sleep_and_call(&timer_, packetTimeNsec_, STATE(finish));
+    }
+
+    /// Called when a packet starts to be sent to the track. Simulations
+    /// override this to look at the outgoing packets.
+    /// @param pkt the packet.
+    virtual void packet_sent(dcc::Packet *pkt)
+    {
     }
 
     /// Do nothing. @return next action.
@@ -78,6 +91,8 @@ protected:
     FixedPool pool_;
     /// Helper object for timing.
     StateFlowTimer timer_{this};
+    /// How long a packet takes on the track.
+    long long packetTimeNsec_;
 };
 
 } // namespace dcc
@@ -97,6 +97,10 @@ void DccTrain<Payload>::get_next_packet(unsigned code, Packet *packet)
             this->p.nextRefresh_ = 0;
         }
     }
+    else if (code == SPEED_REFRESH)
+    {
+        code = SPEED;
+    }
     else
     {
         // User action. Up repeat count.
@@ -195,7 +199,7 @@ void MMOldTrain::get_next_packet(unsigned code, Packet *packet)
     else
     {
         packet->add_mm_speed(p.speed_);
-        if (code != REFRESH)
+        if (code != REFRESH && code != SPEED_REFRESH)
         {
             packet->packet_header.rept_count = 2;
         }
@@ -237,6 +241,10 @@ void MMNewTrain::get_next_packet(unsigned code, Packet *packet)
             ++p.nextRefresh_;
         }
     }
+    else if (code == SPEED_REFRESH)
+    {
+        code = SPEED;
+    }
     else
     {
         packet->packet_header.rept_count = 2;
@@ -85,6 +85,9 @@ enum DccTrainUpdateCode
     MAX_REFRESH = FUNCTION9,
     MM_MAX_REFRESH = 7,
     ESTOP = 16,
+    /// Background refresh of the speed only. Unlike SPEED, this is not a user
+    /// action, so the packet is not repeated.
+    SPEED_REFRESH = 17,
 };
 
 /// AbstractTrain is a templated class for train implementations in a command
@@ -0,0 +1,231 @@
+/** \copyright
+ * Copyright (c) 2026, Balazs Racz
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are  permitted provided that the following conditions are met:
+ *
+ *  - Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  - Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file PriorityUpdateLoop.cxx
+ *
+ * Command station update loop that sends the packets of recently changed
+ * trains first and refreshes moving trains more often than stopped ones.
+ *
+ * @author Balazs Racz
+ * @date 17 Oct 2026
+ */
+
+#include "dcc/PriorityUpdateLoop.hxx"
+
+#include "dcc/Loco.hxx"
+#include "dcc/Packet.hxx"
+#include "dcc/PacketSource.hxx"
+
+namespace dcc
+{
+
+PriorityUpdateLoop::PriorityUpdateLoop(Service *service, TrackIf *track_send)
+    : StateFlow(service)
+    , trackSend_(track_send)
+{
+}
+
+PriorityUpdateLoop::~PriorityUpdateLoop()
+{
+}
+
+bool PriorityUpdateLoop::add_refresh_source(
+    dcc::PacketSource *source, unsigned priority)
+{
+    AtomicHolder h(this);
+    if (priority < EXCLUSIVE_MIN_PRIORITY)
+    {
+        refreshSources_.emplace_back(source);
+        return exclusiveSources_.empty();
+    }
+    auto it = exclusiveSources_.begin();
+    while (it != exclusiveSources_.end() && it->priority >= priority)
+    {
+        ++it;
+    }
+    bool is_first = true;
+    if (it != exclusiveSources_.begin() && (it - 1)->priority > priority)
+    {
+        is_first = false;
+    }
+    exclusiveSources_.insert(it, {source, priority});
+    return is_first;
+}
+
+void PriorityUpdateLoop::remove_refresh_source(dcc::PacketSource *source)
+{
+    AtomicHolder h(this);
+    refreshSources_.erase(std::remove_if(refreshSources_.begin(),
+                              refreshSources_.end(),
+                              [source](const RefreshEntry &e) {
+                                  return e.source == source;
+                              }),
+        refreshSources_.end());
+    exclusiveSources_.erase(std::remove_if(exclusiveSources_.begin(),
+                                exclusiveSources_.end(),
+                                [source](const ExclusiveEntry &e) {
+                                    return e.source == source;
+                                }),
+        exclusiveSources_.end());
+    urgent_.erase(std::remove_if(urgent_.begin(), urgent_.end(),
+                      [source](const UrgentEntry &e) {
+                          return e.source == source;
+                      }),
+        urgent_.end());
+    if (lastSource_ == source)
+    {
+        lastSource_ = nullptr;
+    }
+    if (nextRefreshIndex_ >= refreshSources_.size())
+    {
+        nextRefreshIndex_ = 0;
+    }
+}
+
+void PriorityUpdateLoop::notify_update(PacketSource *source, unsigned code)
+{
+    AtomicHolder h(this);
+    for (auto &e : urgent_)
+    {
+        if (e.source == source && e.code == code)
+        {
+            // Already pending. The source will generate the packet from its
+            // latest state, so we only need to restart the repeats.
+            e.repeatsLeft = URGENT_REPEAT_COUNT;
+            return;
+        }
+    }
+    urgent_.push_back({source, code, URGENT_REPEAT_COUNT});
+}
+
+bool PriorityUpdateLoop::pick_urgent(PacketSource **source, unsigned *code)
+{
+    for (auto it = urgent_.begin(); it != urgent_.end(); ++it)
+    {
+        if (it->source == lastSource_)
+        {
+            continue;
+        }
+        UrgentEntry e = *it;
+        urgent_.erase(it);
+        if (--e.repeatsLeft)
+        {
+            // Goes to the back so that the other pending updates get their
+            // first packet before our repeat.
+            urgent_.push_back(e);
+        }
+        *source = e.source;
+        *code = e.code;
+        return true;
+    }
+    return false;
+}
+
+bool PriorityUpdateLoop::pick_refresh(PacketSource **source, unsigned *code)
+{
+    size_t n = refreshSources_.size();
+    // Stopped source that we skipped in this round, if there was nothing
+    // better to send.
+    size_t fallback = n;
+    for (size_t i = 0; i < n; ++i)
+    {
+        size_t idx = (nextRefreshIndex_ + i) % n;
+        RefreshEntry &e = refreshSources_[idx];
+        if (e.source == lastSource_)
+        {
+            continue;
+        }
+        if (e.source->get_speed().speed() > 0)
+        {
+            // Moving train.
+            nextRefreshIndex_ = idx + 1;
+            *source = e.source;
+            if (++e.speedRefreshCount >= FUNCTION_REFRESH_DIVIDER)
+            {
+                e.speedRefreshCount = 0;
+                *code = REFRESH;
+            }
+            else
+            {
+                *code = SPEED_REFRESH;
+            }
+            return true;
+        }
+        if (e.skipCount)
+        {
+            --e.skipCount;
+            if (fallback == n)
+            {
+                fallback = idx;
+            }
+            continue;
+        }
+        fallback = idx;
+        break;
+    }
+    if (fallback == n)
+    {
+        return false;
+    }
+    RefreshEntry &e = refreshSources_[fallback];
+    e.skipCount = STOPPED_REFRESH_DIVIDER - 1;
+    nextRefreshIndex_ = fallback + 1;
+    *source = e.source;
+    *code = REFRESH;
+    return true;
+}
+
+StateFlowBase::Action PriorityUpdateLoop::entry()
+{
+    PacketSource *source = nullptr;
+    unsigned code = REFRESH;
+    {
+        AtomicHolder h(this);
+        if (!exclusiveSources_.empty())
+        {
+            source = exclusiveSources_[0].source;
+        }
+        else if (!pick_urgent(&source, &code))
+        {
+            pick_refresh(&source, &code);
+        }
+        lastSource_ = source;
+    }
+    if (source)
+    {
+        source->get_next_packet(code, message()->data());
+    }
+    else
+    {
+        // Nothing to send, or the only candidate just got the previous slot.
+        message()->data()->set_dcc_idle();
+    }
+    // We pass on the filled packet to the track processor.
+    trackSend_->send(transfer_message());
+    return exit();
+}
+
+} // namespace dcc
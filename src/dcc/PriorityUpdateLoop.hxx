@@ -0,0 +1,173 @@
+/** \copyright
+ * Copyright (c) 2026, Balazs Racz
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are  permitted provided that the following conditions are met:
+ *
+ *  - Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  - Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file PriorityUpdateLoop.hxx
+ *
+ * Command station update loop that sends the packets of recently changed
+ * trains first and refreshes moving trains more often than stopped ones.
+ *
+ * @author Balazs Racz
+ * @date 17 Oct 2026
+ */
+
+#ifndef _DCC_PRIORITYUPDATELOOP_HXX_
+#define _DCC_PRIORITYUPDATELOOP_HXX_
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include "dcc/UpdateLoop.hxx"
+#include "executor/StateFlow.hxx"
+
+namespace dcc
+{
+
+/// Implementation of a command station update loop with prioritization. Every
+/// outgoing packet slot is assigned in the following order:
+///
+/// - if there is an exclusive source (priority at least
+///   EXCLUSIVE_MIN_PRIORITY), the one with the largest priority gets all
+///   slots.
+///
+/// - sources that called packet_processor_notify_update() are served from an
+///   urgent lane. Each notification is sent URGENT_REPEAT_COUNT times,
+///   interleaved with the other pending notifications.
+///
+/// - the remaining slots are background refresh. Stopped sources are visited
+///   only every STOPPED_REFRESH_DIVIDER'th round. Moving sources get a speed
+///   refresh (code SPEED_REFRESH) in most of their slots, and a full refresh
+///   (code REFRESH, which cycles through the functions) only in every
+///   FUNCTION_REFRESH_DIVIDER'th slot.
+///
+/// Apart from exclusive sources, the same source never gets two slots right
+/// after each other; an idle packet is sent instead if there is nothing else
+/// to do.
+///
+/// Moving sources have to understand the SPEED_REFRESH code; the trains in
+/// dcc/Loco.hxx all do.
+///
+/// Usage is the same as for SimpleUpdateLoop.
+class PriorityUpdateLoop : public StateFlow<Buffer<dcc::Packet>, QList<1>>,
+                           private UpdateLoopBase
+{
+public:
+    /// Constructor.
+    ///
+    /// @param service defines the executor to run on.
+    /// @param track_send where to forward the filled packets.
+    PriorityUpdateLoop(Service *service, TrackIf *track_send);
+    ~PriorityUpdateLoop();
+
+    /// How many times a notified update is sent to the track.
+    static constexpr unsigned URGENT_REPEAT_COUNT = 2;
+    /// A stopped source is refreshed in every this many background rounds.
+    static constexpr unsigned STOPPED_REFRESH_DIVIDER = 4;
+    /// A moving source gets a full refresh (including functions) in every
+    /// this many background slots; the others are speed refresh.
+    static constexpr unsigned FUNCTION_REFRESH_DIVIDER = 4;
+
+    /** Adds a new refresh source to the background refresh packets. */
+    bool add_refresh_source(
+        dcc::PacketSource *source, unsigned priority) override;
+
+    /** Deletes a packet refresh source. */
+    void remove_refresh_source(dcc::PacketSource *source) override;
+
+    /** Puts the source onto the urgent lane. */
+    void notify_update(PacketSource *source, unsigned code) override;
+
+    // Entry to the state flow -- when a new packet needs to be sent.
+    Action entry() override;
+
+private:
+    /// Background refresh state of a source.
+    struct RefreshEntry
+    {
+        RefreshEntry(PacketSource *s)
+            : source(s)
+        {
+        }
+        /// The packet source.
+        PacketSource *source;
+        /// How many more background rounds to skip if the source is stopped.
+        uint8_t skipCount {0};
+        /// Counts the speed refreshes since the last full refresh.
+        uint8_t speedRefreshCount {0};
+    };
+
+    /// A pending notification on the urgent lane.
+    struct UrgentEntry
+    {
+        /// The packet source.
+        PacketSource *source;
+        /// Code to give to the source.
+        unsigned code;
+        /// How many more times this entry will be sent.
+        unsigned repeatsLeft;
+    };
+
+    /// An exclusive source.
+    struct ExclusiveEntry
+    {
+        /// The packet source.
+        PacketSource *source;
+        /// Priority given at registration.
+        unsigned priority;
+    };
+
+    /// Chooses the next entry from the urgent lane. Must be called with the
+    /// lock held.
+    /// @param source will be set to the chosen packet source.
+    /// @param code will be set to the code to pass to the source.
+    /// @return true if an entry was chosen.
+    bool pick_urgent(PacketSource **source, unsigned *code);
+
+    /// Chooses the next source for background refresh. Must be called with
+    /// the lock held.
+    /// @param source will be set to the chosen packet source.
+    /// @param code will be set to the code to pass to the source.
+    /// @return true if a source was chosen.
+    bool pick_refresh(PacketSource **source, unsigned *code);
+
+    /// Place where we forward the packets filled in.
+    TrackIf *trackSend_;
+    /// Packet sources to ask about refreshing data periodically.
+    std::vector<RefreshEntry> refreshSources_;
+    /// Notified updates that have not yet been sent enough times.
+    std::deque<UrgentEntry> urgent_;
+    /// Exclusive sources, sorted by decreasing priority.
+    std::vector<ExclusiveEntry> exclusiveSources_;
+    /// Offset in the refreshSources_ vector for the next loco to send.
+    size_t nextRefreshIndex_ {0};
+    /// The source that got the previous packet slot. Nullptr if that was an
+    /// idle packet.
+    PacketSource *lastSource_ {nullptr};
+};
+
+} // namespace dcc
+
+#endif // _DCC_PRIORITYUPDATELOOP_HXX_
@@ -46,7 +46,8 @@ namespace dcc
 
 /// Implementation of a command station update loop. This loop iterates over
 /// all locomotive implementations and polls them for the next packet in a
-/// strict round-robin behavior (no prioritization).
+/// strict round-robin behavior (no prioritization). See PriorityUpdateLoop for
+/// an implementation that sends the user's changes first.
 ///
 /// Usage:
 ///
@@ -69,7 +70,6 @@ public:
     bool add_refresh_source(
         dcc::PacketSource *source, unsigned priority) OVERRIDE
     {
-        /// @todo implement priority refresh.
         AtomicHolder h(this);
         refreshSources_.push_back(source);
         return true;
@@ -35,6 +35,7 @@
 #ifndef _EXECUTOR_DISPATCHER_HXX_
 #define _EXECUTOR_DISPATCHER_HXX_
 
+#include <algorithm>
 #include <vector>
 
 #include "executor/Notifiable.hxx"
@@ -46,6 +47,12 @@
    invoked.
 
    Handlers are called in no particular order.
+
+   By default the handlers are stored in a list, and every incoming message is
+   matched against every registered handler. Dispatchers with many handlers
+   should call enable_index(), which groups the handlers by mask, and uses a
+   binary search in each group. This makes the cost of a message proportional
+   to the number of distinct masks and the number of matching handlers.
  */
 template <int NUM_PRIO>
 class DispatchFlowBase : public UntypedStateFlow<QList<NUM_PRIO>>
@@ -65,6 +72,13 @@ public:
     /** @returns the number of handlers registered. */
     size_t size();
 
+    /** Switches the dispatcher to indexed lookup of the handlers. Handlers
+     * that are already registered are moved to the index. Must not be used
+     * with negated matching (in that case every handler matches nearly every
+     * message, so there is nothing to gain). Must be called while no message
+     * is being dispatched, typically right after construction. */
+    void enable_index();
+
 protected:
     /// Proxy the identifier type for customers to use.
     typedef uint32_t ID;
@@ -181,15 +195,47 @@ private:
         }
     };
 
-    /// Registered handlers.
+    /// @return the list of handlers that iterate() shall walk for the current
+    /// message.
+    vector<HandlerInfo> &candidates()
+    {
+        return indexed_ ? matches_ : handlers_;
+    }
+
+    /// Looks up the handlers that match the current message from the index
+    /// and stores them in matches_.
+    void collect_matches();
+
+    /// Registered handlers (when not indexed).
     vector<HandlerInfo> handlers_;
 
+    /// Handlers that are registered with the same mask. Used in indexed mode.
+    struct MaskGroup
+    {
+        /// Common mask of the handlers in this group.
+        ID mask;
+        /// Handlers, sorted by id & mask.
+        vector<HandlerInfo> handlers;
+    };
+
+    /// Registered handlers, grouped by mask (when indexed).
+    vector<MaskGroup> index_;
+
+    /// When indexed: the handlers that matched the current message. Handlers
+    /// that get unregistered during the iteration are nulled out.
+    vector<HandlerInfo> matches_;
+
+    /// true if the handlers are stored in index_ instead of handlers_.
+    bool indexed_{false};
+
     /// Index of the next handler to look at.
     size_t currentIndex_;
 
 protected:
     /// If non-NULL we still need to call this handler.
     UntypedHandler *lastHandlerToCall_{nullptr};
+    /// True if a copy of the current message was already sent to a handler.
+    bool cloned_{false};
     /// Handler to give all messages that were not matched by any other handler
     /// registration.
     UntypedHandler *fallbackHandler_{nullptr};
@@ -311,6 +357,7 @@ protected:
         copy->set_done(this->message()->new_child());
         *copy->data() = *this->message()->data();
         h->send(copy);
+        this->cloned_ = true;
         return call_immediately(STATE(clone_done));
     }
 
@@ -351,14 +398,65 @@ size_t DispatchFlowBase<NUM_PRIO>::size()
             ++ret;
         }
     }
+    for (auto &g : index_)
+    {
+        ret += g.handlers.size();
+    }
     return ret;
 }
 
+template<int NUM_PRIO>
+void DispatchFlowBase<NUM_PRIO>::enable_index()
+{
+    HASSERT(!negateMatch_);
+    vector<HandlerInfo> old;
+    {
+        OSMutexLock h(&lock_);
+        if (indexed_)
+        {
+            return;
+        }
+        old.swap(handlers_);
+        indexed_ = true;
+    }
+    for (auto &h : old)
+    {
+        if (h.handler)
+        {
+            register_handler(h.handler, h.id, h.mask);
+        }
+    }
+}
+
 template<int NUM_PRIO>
 void DispatchFlowBase<NUM_PRIO>::register_handler(UntypedHandler *handler,
                                                   ID id, ID mask)
 {
     OSMutexLock h(&lock_);
+    if (indexed_)
+    {
+        auto g = index_.begin();
+        while (g != index_.end() && g->mask != mask)
+        {
+            ++g;
+        }
+        if (g == index_.end())
+        {
+            index_.emplace_back();
+            g = index_.end() - 1;
+            g->mask = mask;
+        }
+        HandlerInfo info;
+        info.id = id;
+        info.mask = mask;
+        info.handler = handler;
+        auto it = std::upper_bound(g->handlers.begin(), g->handlers.end(),
+            id & mask, [mask](ID key, const HandlerInfo &h) {
+                return key < (h.id & mask);
+            });
+        g->handlers.insert(it, info);
+        return;
+    }
     size_t idx = 0;
     while (idx < handlers_.size() && handlers_[idx].handler)
     {
@@ -379,6 +477,45 @@ DispatchFlowBase<NUM_PRIO>::unregister_handler(UntypedHandler *handler,
                                                ID id, ID mask)
 {
     OSMutexLock h(&lock_);
+    if (indexed_)
+    {
+        bool found = false;
+        for (auto g = index_.begin(); g != index_.end(); ++g)
+        {
+            if (g->mask != mask)
+            {
+                continue;
+            }
+            for (auto it = g->handlers.begin(); it != g->handlers.end(); ++it)
+            {
+                if (it->Equals(id, mask, handler))
+                {
+                    g->handlers.erase(it);
+                    found = true;
+                    break;
+                }
+            }
+            if (g->handlers.empty())
+            {
+                index_.erase(g);
+            }
+            break;
+        }
+        HASSERT(found &&
+            "Tried to unregister a handler not previously registered.");
+        for (auto &m : matches_)
+        {
+            if (m.Equals(id, mask, handler))
+            {
+                m.handler = nullptr;
+            }
+        }
+        if (lastHandlerToCall_ == handler)
+        {
+            lastHandlerToCall_ = nullptr;
+        }
+        return;
+    }
     /// @todo(balazs.racz) optimize by looking at the current index - 1.
     size_t idx = 0;
     while (idx < handlers_.size() && !handlers_[idx].Equals(id, mask, handler))
@@ -403,6 +540,34 @@ void DispatchFlowBase<NUM_PRIO>::unregister_handler_all(
     UntypedHandler *handler)
 {
     OSMutexLock h(&lock_);
+    for (auto g = index_.begin(); g != index_.end();)
+    {
+        g->handlers.erase(std::remove_if(g->handlers.begin(),
+                              g->handlers.end(),
+                              [handler](const HandlerInfo &h) {
+                                  return h.handler == handler;
+                              }),
+            g->handlers.end());
+        if (g->handlers.empty())
+        {
+            g = index_.erase(g);
+        }
+        else
+        {
+            ++g;
+        }
+    }
+    for (auto &m : matches_)
+    {
+        if (m.handler == handler)
+        {
+            m.handler = nullptr;
+        }
+    }
+    if (lastHandlerToCall_ == handler)
+    {
+        lastHandlerToCall_ = nullptr;
+    }
     for (size_t i = 0; i < handlers_.size(); ++i)
     {
         if (handlers_[i].handler == handler)
@@ -421,9 +586,35 @@ StateFlowBase::Action DispatchFlowBase<NUM_PRIO>::entry()
 {
     currentIndex_ = 0;
     lastHandlerToCall_ = nullptr;
+    cloned_ = false;
+    if (indexed_)
+    {
+        collect_matches();
+    }
     return call_immediately(STATE(iterate));
 }
 
+template<int NUM_PRIO>
+void DispatchFlowBase<NUM_PRIO>::collect_matches()
+{
+    ID id = get_message_id();
+    OSMutexLock l(&lock_);
+    matches_.clear();
+    for (auto &g : index_)
+    {
+        ID key = id & g.mask;
+        ID mask = g.mask;
+        auto it = std::lower_bound(g.handlers.begin(), g.handlers.end(), key,
+            [mask](const HandlerInfo &h, ID key) {
+                return (h.id & mask) < key;
+            });
+        for (; it != g.handlers.end() && (it->id & mask) == key; ++it)
+        {
+            matches_.push_back(*it);
+        }
+    }
+}
+
 template<int NUM_PRIO>
 StateFlowBase::Action DispatchFlowBase<NUM_PRIO>::iterate()
 {
@@ -432,9 +623,10 @@ StateFlowBase::Action DispatchFlowBase<NUM_PRIO>::iterate()
         // @todo(balazs.racz) make the registered handlers structure for the
         // dispatcher lock-free. This mutex here is very expensive.
         OSMutexLock l(&lock_);
-        for (; currentIndex_ < handlers_.size(); ++currentIndex_)
+        vector<HandlerInfo> &handlers = candidates();
+        for (; currentIndex_ < handlers.size(); ++currentIndex_)
         {
-            auto &h = handlers_[currentIndex_];
+            auto &h = handlers[currentIndex_];
             if (!h.handler)
             {
                 continue;
@@ -451,13 +643,13 @@ StateFlowBase::Action DispatchFlowBase<NUM_PRIO>::iterate()
             if (!lastHandlerToCall_)
             {
                 // This was the first we found.
-                lastHandlerToCall_ = handlers_[currentIndex_].handler;
+                lastHandlerToCall_ = handlers[currentIndex_].handler;
                 continue;
             }            
             break;
         }
     }
-    if (currentIndex_ >= handlers_.size())
+    if (currentIndex_ >= candidates().size())
     {
         return iteration_done();
     }
@@ -469,7 +661,10 @@ StateFlowBase::Action DispatchFlowBase<NUM_PRIO>::iterate()
 template<int NUM_PRIO>
 StateFlowBase::Action DispatchFlowBase<NUM_PRIO>::clone_done()
 {
-    lastHandlerToCall_ = handlers_[currentIndex_].handler;
+    // The handler list may have shrunk while the clone was being allocated.
+    lastHandlerToCall_ = currentIndex_ < candidates().size()
+        ? candidates()[currentIndex_].handler
+        : nullptr;
     ++currentIndex_;
     return call_immediately(STATE(iterate));
 }
@@ -481,7 +676,7 @@ StateFlowBase::Action DispatchFlowBase<NUM_PRIO>::iteration_done()
     {
         send_transfer();
     }
-    else if (fallbackHandler_)
+    else if (fallbackHandler_ && !cloned_)
     {
         // Nothing handled this message, and we have a fallbac handler
         // registered. Gives the message to the fallback handler.
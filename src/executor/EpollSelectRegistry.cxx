@@ -0,0 +1,225 @@
+/** \copyright
+ * Copyright (c) 2026, Balazs Racz
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  - Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  - Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file EpollSelectRegistry.cxx
+ *
+ * Linux epoll based storage of the Selectables that an Executor is waiting
+ * upon.
+ *
+ * @author Balazs Racz
+ * @date 17 Oct 2026
+ */
+
+#include "executor/EpollSelectRegistry.hxx"
+
+#if OPENMRN_HAVE_EPOLL
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "executor/Executor.hxx"
+
+/// Kernel event bits that we register for each select type (indexed by
+/// SelectType - 1).
+static const uint32_t WATCH_BITS[3] = {EPOLLIN, EPOLLOUT, EPOLLPRI};
+
+/// Kernel event bits that trigger each select type (indexed by SelectType -
+/// 1). These mirror which fd_set ::select would report an error or hangup in.
+static const uint32_t TRIGGER_BITS[3] = {
+    EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR, EPOLLOUT | EPOLLHUP | EPOLLERR,
+    EPOLLPRI};
+
+EpollSelectRegistry::EpollSelectRegistry(
+    ExecutorBase *executor, bool edge_triggered)
+    : executor_(executor)
+    , edgeTriggered_(edge_triggered)
+{
+    epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd_ < 0)
+    {
+        LOG(FATAL, "Failed to create epoll instance: %s", strerror(errno));
+    }
+}
+
+EpollSelectRegistry::~EpollSelectRegistry()
+{
+    ::close(epollFd_);
+}
+
+EpollSelectRegistry::FdEntry *EpollSelectRegistry::entry(int fd)
+{
+    if ((unsigned)fd >= fds_.size())
+    {
+        fds_.resize(fd + 1);
+    }
+    return &fds_[fd];
+}
+
+uint32_t EpollSelectRegistry::wanted_events(FdEntry *e)
+{
+    uint32_t ret = 0;
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        if (e->jobs[i])
+        {
+            ret |= WATCH_BITS[i];
+        }
+    }
+    return ret;
+}
+
+void EpollSelectRegistry::insert(Selectable *job)
+{
+    int fd = job->fd();
+    unsigned idx = job->type() - 1;
+    FdEntry *e = entry(fd);
+    if (e->jobs[idx])
+    {
+        LOG(FATAL,
+            "Multiple Selectables are waiting for the same fd %d type %u", fd,
+            job->type());
+    }
+    e->jobs[idx] = job;
+    ++numWaiting_;
+    update_kernel(fd, e);
+}
+
+bool EpollSelectRegistry::is_selected(Selectable *job)
+{
+    unsigned fd = job->fd();
+    return fd < fds_.size() && fds_[fd].jobs[job->type() - 1] != nullptr;
+}
+
+void EpollSelectRegistry::remove(Selectable *job)
+{
+    int fd = job->fd();
+    unsigned idx = job->type() - 1;
+    if (!is_selected(job))
+    {
+        LOG(FATAL, "Tried to remove a non-active selectable: fd %d type %u",
+            fd, job->type());
+    }
+    FdEntry *e = &fds_[fd];
+    e->jobs[idx] = nullptr;
+    --numWaiting_;
+    if (!edgeTriggered_)
+    {
+        update_kernel(fd, e);
+    }
+}
+
+void EpollSelectRegistry::trigger(FdEntry *e, unsigned idx)
+{
+    Selectable *job = e->jobs[idx];
+    e->jobs[idx] = nullptr;
+    --numWaiting_;
+    executor_->add(job->parent(), job->priority());
+}
+
+void EpollSelectRegistry::update_kernel(int fd, FdEntry *e)
+{
+    uint32_t wanted = wanted_events(e);
+    if (!edgeTriggered_ && wanted == e->registered)
+    {
+        return;
+    }
+    int ret;
+    if (!wanted)
+    {
+        // Errors are ignored here; the fd might have been closed already,
+        // which removes it from the epoll set.
+        ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+        e->registered = 0;
+        return;
+    }
+    struct epoll_event ev;
+    ev.events = wanted | (edgeTriggered_ ? EPOLLET : 0);
+    ev.data.fd = fd;
+    if (e->registered)
+    {
+        ret = ::epoll_ctl(epollFd_, EPOLL_CTL_MOD, fd, &ev);
+        if (ret < 0 && errno == ENOENT)
+        {
+            // The fd was closed and reopened since we last saw it.
+            ret = ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev);
+        }
+    }
+    else
+    {
+        ret = ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev);
+        if (ret < 0 && errno == EEXIST)
+        {
+            ret = ::epoll_ctl(epollFd_, EPOLL_CTL_MOD, fd, &ev);
+        }
+    }
+    if (ret == 0)
+    {
+        e->registered = wanted;
+        return;
+    }
+    e->registered = 0;
+    if (errno != EPERM)
+    {
+        LOG_ERROR("epoll_ctl failed for fd %d: %s", fd, strerror(errno));
+    }
+    // EPERM means the fd does not support polling (e.g. a regular file). The
+    // select() backend reports these as always ready, and so do we. Any other
+    // error will be reported to the caller by the next read or write call.
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        if (e->jobs[i])
+        {
+            trigger(e, i);
+        }
+    }
+}
+
+void EpollSelectRegistry::wait(OSSelectWakeup *helper, long long wait_length)
+{
+    int ret = helper->epoll_wait(epollFd_, events_, MAX_EVENTS, wait_length);
+    for (int i = 0; i < ret; ++i)
+    {
+        int fd = events_[i].data.fd;
+        uint32_t ev = events_[i].events;
+        FdEntry *e = entry(fd);
+        bool changed = false;
+        for (unsigned idx = 0; idx < 3; ++idx)
+        {
+            if (e->jobs[idx] && (ev & TRIGGER_BITS[idx]))
+            {
+                trigger(e, idx);
+                changed = true;
+            }
+        }
+        if (changed && !edgeTriggered_)
+        {
+            update_kernel(fd, e);
+        }
+    }
+}
+
+#endif // OPENMRN_HAVE_EPOLL
@@ -0,0 +1,169 @@
+/** \copyright
+ * Copyright (c) 2026, Balazs Racz
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  - Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  - Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file EpollSelectRegistry.hxx
+ *
+ * Linux epoll based storage of the Selectables that an Executor is waiting
+ * upon.
+ *
+ * @author Balazs Racz
+ * @date 17 Oct 2026
+ */
+
+#ifndef _EXECUTOR_EPOLLSELECTREGISTRY_HXX_
+#define _EXECUTOR_EPOLLSELECTREGISTRY_HXX_
+
+#include "openmrn_features.h"
+
+#if OPENMRN_HAVE_EPOLL
+
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <vector>
+
+#include "utils/macros.h"
+
+class ExecutorBase;
+class OSSelectWakeup;
+class Selectable;
+
+/// Keeps track of the Selectables of an executor using a kernel epoll
+/// instance. Replaces the fd_sets and the linked list of ExecutorBase when
+/// the executor is switched to one of the epoll backends. The cost of a wakeup
+/// is proportional to the number of ready file descriptors, not the number of
+/// watched ones (or the largest fd number), and there is no FD_SETSIZE limit.
+///
+/// The semantics towards the Selectables are the same as the select() based
+/// implementation: each Selectable is one-shot; once its condition is met it
+/// is removed from the registry and its wakeup executable is scheduled.
+///
+/// In level-triggered mode the kernel interest set always exactly matches the
+/// set of waiting Selectables; an fd is removed from the epoll set when
+/// nothing waits for it anymore. In edge-triggered mode the fd remains
+/// registered after the Selectable triggered, and re-selecting it costs one
+/// EPOLL_CTL_MOD (which re-evaluates the current readiness) instead of an
+/// ADD/DEL pair. Edge mode assumes that the file descriptor is not dup()-ed
+/// by the application, since the kernel keys registrations on the open file
+/// and not the fd number.
+///
+/// All functions must be called on the executor thread.
+class EpollSelectRegistry
+{
+public:
+    /// @param executor is the executor on which the triggered Selectables
+    /// will be scheduled.
+    /// @param edge_triggered if true, uses EPOLLET, otherwise the default
+    /// level triggered epoll.
+    EpollSelectRegistry(ExecutorBase *executor, bool edge_triggered);
+
+    ~EpollSelectRegistry();
+
+    /// Adds a Selectable to watch. Crashes if the same fd is already watched
+    /// for the same select type.
+    /// @param job describes the file descriptor and condition to watch.
+    void insert(Selectable *job);
+
+    /// @param job is the selectable to query.
+    /// @return true if there is a Selectable waiting for the job's fd and
+    /// select type.
+    bool is_selected(Selectable *job);
+
+    /// Stops watching a selectable. Crashes if the job was not inserted.
+    /// @param job is a previously inserted Selectable.
+    void remove(Selectable *job);
+
+    /// @return true if there are no Selectables waiting.
+    bool empty()
+    {
+        return numWaiting_ == 0;
+    }
+
+    /// @return true if the registrations use EPOLLET.
+    bool edge_triggered()
+    {
+        return edgeTriggered_;
+    }
+
+    /// Sleeps on the epoll set, and schedules the Selectables that became
+    /// ready on the executor.
+    ///
+    /// @param helper is the wakeup helper of the executor; it will be used to
+    /// perform the sleep.
+    /// @param wait_length is the maximum time to sleep in nanoseconds.
+    void wait(OSSelectWakeup *helper, long long wait_length);
+
+private:
+    /// How many events we fetch from the kernel in one go. Any further ready
+    /// fds will be returned by the next call.
+    static constexpr unsigned MAX_EVENTS = 64;
+
+    /// Bookkeeping for one file descriptor number.
+    struct FdEntry
+    {
+        /// Waiting Selectables, indexed by SelectType - 1.
+        Selectable *jobs[3] = {nullptr, nullptr, nullptr};
+        /// Event mask that is currently registered in the kernel. Zero if the
+        /// fd is not in the epoll set.
+        uint32_t registered = 0;
+    };
+
+    /// @param fd file descriptor number.
+    /// @return the bookkeeping entry for fd, allocating it if needed.
+    FdEntry *entry(int fd);
+
+    /// @param e an entry.
+    /// @return the event mask that the waiting jobs of e need.
+    static uint32_t wanted_events(FdEntry *e);
+
+    /// Updates the kernel's epoll set after the jobs of an fd have changed.
+    /// @param fd file descriptor number.
+    /// @param e the entry for fd.
+    void update_kernel(int fd, FdEntry *e);
+
+    /// Removes the job of a given type and schedules it on the executor.
+    /// @param e the entry.
+    /// @param idx SelectType - 1.
+    void trigger(FdEntry *e, unsigned idx);
+
+    /// Where to schedule the triggered Selectables.
+    ExecutorBase *executor_;
+    /// Kernel epoll instance.
+    int epollFd_;
+    /// true if EPOLLET is set on the registrations.
+    bool edgeTriggered_;
+    /// How many Selectables are waiting in total.
+    unsigned numWaiting_ = 0;
+    /// Bookkeeping entries, indexed by fd.
+    std::vector<FdEntry> fds_;
+    /// Output buffer for epoll_wait.
+    struct epoll_event events_[MAX_EVENTS];
+
+    DISALLOW_COPY_AND_ASSIGN(EpollSelectRegistry);
+};
+
+#endif // OPENMRN_HAVE_EPOLL
+
+#endif // _EXECUTOR_EPOLLSELECTREGISTRY_HXX_
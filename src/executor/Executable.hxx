@@ -36,6 +36,7 @@
 #define _EXECUTOR_EXECUTABLE_HXX_
 
 #include "executor/Notifiable.hxx"
+#include "openmrn_features.h"
 #include "utils/QMember.hxx"
 
 /// An object that can be scheduled on an executor to run.
@@ -64,6 +65,12 @@ public:
     {
         HASSERT(0 && "unexpected call to alloc_result");
     }
+
+#if OPENMRN_HAVE_EXECUTOR_PROFILE
+    /// When *this was added to the executor's queue, or zero if it was not
+    /// recorded. Used by ExecutorProfile.
+    long long enqueueTime_ {0};
+#endif
 };
 
 /** A notifiable class that calls a particular function object once when it is
@@ -58,6 +58,8 @@ extern "C" {
 }
 #endif
 
+#include "executor/EpollSelectRegistry.hxx"
+#include "executor/ExecutorProfile.hxx"
 #include "executor/Service.hxx"
 #include "nmranet_config.h"
 
@@ -81,6 +83,21 @@ ExecutorBase::ExecutorBase()
     FD_ZERO(&selectWrite_);
     FD_ZERO(&selectExcept_);
     selectNFds_ = 0;
+#if OPENMRN_HAVE_EPOLL
+    set_select_backend((SelectBackend)config_executor_select_backend());
+#endif
+#if OPENMRN_HAVE_TIMER_WHEEL
+    if (config_executor_timer_wheel())
+    {
+        activeTimers_.set_timer_wheel(true);
+    }
+#endif
+#if OPENMRN_HAVE_EXECUTOR_PROFILE
+    if (config_executor_profile())
+    {
+        set_profile(true);
+    }
+#endif
 }
 
 /** Lookup an executor by its name.
@@ -162,6 +179,44 @@ void ExecutorBase::sync_run(std::function<void()> fn)
     }
 }
 
+void ExecutorBase::run_one(Executable *msg)
+{
+    current_ = msg;
+#if OPENMRN_HAVE_EXECUTOR_PROFILE
+    if (profile_.load(std::memory_order_relaxed))
+    {
+        ExecutorProfile::Sample s;
+        s.start(msg);
+        msg->run();
+        // run() might have turned off profiling.
+        ExecutorProfile *p = profile_.load(std::memory_order_relaxed);
+        if (p)
+        {
+            p->record(s);
+        }
+        current_ = nullptr;
+        return;
+    }
+#endif
+    msg->run();
+    current_ = nullptr;
+}
+
+#if OPENMRN_HAVE_EXECUTOR_PROFILE
+void ExecutorBase::set_profile(bool enabled)
+{
+    if (enabled && !profile_.load(std::memory_order_relaxed))
+    {
+        profile_.store(new ExecutorProfile(), std::memory_order_relaxed);
+    }
+    else if (!enabled)
+    {
+        // add() only checks the pointer for null, never dereferences it.
+        delete profile_.exchange(nullptr, std::memory_order_relaxed);
+    }
+}
+#endif
+
 bool ExecutorBase::loop_once()
 {
     ScopedSetThreadHandle h(this);
@@ -178,9 +233,7 @@ bool ExecutorBase::loop_once()
         done_ = 1;
         return false;
     }
-    current_ = msg;
-    msg->run();
-    current_ = nullptr;
+    run_one(msg);
     return true;
 }
 
@@ -202,9 +255,7 @@ long long ICACHE_FLASH_ATTR  ExecutorBase::loop_some() {
         }
         if (msg != NULL)
         {
-            current_ = msg;
-            msg->run();
-            current_ = nullptr;
+            run_one(msg);
         }
     }
     // Still stuff pending to run.
@@ -320,17 +371,59 @@ void *ExecutorBase::entry()
         if (msg != NULL)
         {
             ++sequence_;
-            current_ = msg;
-            msg->run();
-            current_ = nullptr;
+            run_one(msg);
         }
     }
 
     return NULL;
 }
 
+void ExecutorBase::set_select_backend(SelectBackend backend)
+{
+    HASSERT(selectables_.empty());
+#if OPENMRN_HAVE_EPOLL
+    HASSERT(!epoll_ || epoll_->empty());
+    switch (backend)
+    {
+        case SELECT_BACKEND_EPOLL_LEVEL:
+            epoll_.reset(new EpollSelectRegistry(this, false));
+            return;
+        case SELECT_BACKEND_EPOLL_EDGE:
+            epoll_.reset(new EpollSelectRegistry(this, true));
+            return;
+        default:
+            epoll_.reset();
+            return;
+    }
+#else
+    if (backend != SELECT_BACKEND_SELECT)
+    {
+        LOG(WARNING, "Executor: epoll is not available, using select.");
+    }
+#endif
+}
+
+ExecutorBase::SelectBackend ExecutorBase::select_backend()
+{
+#if OPENMRN_HAVE_EPOLL
+    if (epoll_)
+    {
+        return epoll_->edge_triggered() ? SELECT_BACKEND_EPOLL_EDGE
+                                        : SELECT_BACKEND_EPOLL_LEVEL;
+    }
+#endif
+    return SELECT_BACKEND_SELECT;
+}
+
 void ExecutorBase::select(Selectable *job)
 {
+#if OPENMRN_HAVE_EPOLL
+    if (epoll_)
+    {
+        epoll_->insert(job);
+        return;
+    }
+#endif
     fd_set *s = get_select_set(job->type());
     int fd = job->fd_;
     if (FD_ISSET(fd, s))
@@ -351,6 +444,12 @@ void ExecutorBase::select(Selectable *job)
 
 bool ExecutorBase::is_selected(Selectable *job)
 {
+#if OPENMRN_HAVE_EPOLL
+    if (epoll_)
+    {
+        return epoll_->is_selected(job);
+    }
+#endif
     fd_set *s = get_select_set(job->type());
     int fd = job->fd_;
     return FD_ISSET(fd, s);
@@ -358,6 +457,13 @@ bool ExecutorBase::is_selected(Selectable *job)
 
 void ExecutorBase::unselect(Selectable *job)
 {
+#if OPENMRN_HAVE_EPOLL
+    if (epoll_)
+    {
+        epoll_->remove(job);
+        return;
+    }
+#endif
     fd_set *s = get_select_set(job->type());
     int fd = job->fd_;
     if (!FD_ISSET(fd, s))
@@ -383,14 +489,15 @@ void ExecutorBase::unselect(Selectable *job)
 
 void ExecutorBase::wait_with_select(long long wait_length)
 {
-    fd_set fd_r(selectRead_);
-    fd_set fd_w(selectWrite_);
-    fd_set fd_x(selectExcept_);
     // We will check the queue for any prior wakeups after this call. If we
     // already processed the executables, the wakeup is not necessary. Without
     // this clear, there would always be two select() iterations happening when
     // we are done with work and can go to sleep.
     selectHelper_.clear_wakeup();
+    // Lock-free producers only wake us up when they see this flag. The
+    // fence orders the flag before the empty() check; see Executor::add().
+    sleeping_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
     if (!empty())
     {
         wait_length = 0;
@@ -400,6 +507,22 @@ void ExecutorBase::wait_with_select(long long wait_length)
     {
         wait_length = max_sleep;
     }
+    select_and_dispatch(wait_length);
+    sleeping_.store(false, std::memory_order_relaxed);
+}
+
+void ExecutorBase::select_and_dispatch(long long wait_length)
+{
+#if OPENMRN_HAVE_EPOLL
+    if (epoll_)
+    {
+        epoll_->wait(&selectHelper_, wait_length);
+        return;
+    }
+#endif
+    fd_set fd_r(selectRead_);
+    fd_set fd_w(selectWrite_);
+    fd_set fd_x(selectExcept_);
     int ret = selectHelper_.select(selectNFds_, &fd_r, &fd_w, &fd_x, wait_length);
     if (ret <= 0) {
         return; // nothing to do
@@ -458,4 +581,7 @@ ExecutorBase::~ExecutorBase()
     {
         shutdown();
     }
+#if OPENMRN_HAVE_EXECUTOR_PROFILE
+    set_profile(false);
+#endif
 }
@@ -38,7 +38,9 @@
 
 #include <functional>
 #include <atomic>
+#include <memory>
 
+#include "openmrn_features.h"
 #include "executor/Executable.hxx"
 #include "executor/Notifiable.hxx"
 #include "executor/Selectable.hxx"
@@ -57,6 +59,8 @@ extern "C" {
 #endif
 
 class ActiveTimers;
+class EpollSelectRegistry;
+class ExecutorProfile;
 
 /** This class implements an execution of tasks pulled off an input queue.
  */
@@ -116,6 +120,54 @@ public:
      * @param job is the selectable to query. */
     bool is_selected(Selectable* job);
 
+    /// Which kernel facility the executor uses to wait for the Selectables.
+    enum SelectBackend
+    {
+        /// Portable ::select() with fd_sets. The cost of each wakeup is
+        /// proportional to the largest fd and the number of waiting
+        /// Selectables, and fds are limited to FD_SETSIZE.
+        SELECT_BACKEND_SELECT = 0,
+        /// Level-triggered epoll. Only available on Linux.
+        SELECT_BACKEND_EPOLL_LEVEL = 1,
+        /// Edge-triggered epoll. Only available on Linux. Saves an epoll_ctl
+        /// call per wakeup compared to level-triggered mode.
+        SELECT_BACKEND_EPOLL_EDGE = 2,
+    };
+
+    /** Changes how the Selectables are waited upon. The default comes from
+     * the executor_select_backend constant. The Selectable API is the same
+     * for all backends.
+     *
+     * Must be called on the executor thread, or before the executor thread
+     * is started (see NO_THREAD), when no Selectables are registered.
+     *
+     * @param backend is the new backend to use. If epoll is not available on
+     * this platform, the select backend stays in use. */
+    void set_select_backend(SelectBackend backend);
+
+    /// @return the select backend currently in use.
+    SelectBackend select_backend();
+
+#if OPENMRN_HAVE_EXECUTOR_PROFILE
+    /** Turns on or off recording the run count, wall and CPU time, queue wait
+     * time and longest run of every Executable class that runs on this
+     * executor. The default comes from the executor_profile constant. Turning
+     * it off discards the recorded data.
+     *
+     * Must be called on the executor thread, or before the executor thread
+     * is started (see NO_THREAD).
+     *
+     * @param enabled true to turn on recording. */
+    void set_profile(bool enabled);
+
+    /// @return the recorded run times, or nullptr if recording is off. Must
+    /// be accessed on the executor thread (see sync_run()).
+    ExecutorProfile *profile()
+    {
+        return profile_.load(std::memory_order_relaxed);
+    }
+#endif
+
     /** Removes a job from the select loop.
      *
      * This stops watching the given file descriptor. The job must have been
@@ -178,6 +230,18 @@ protected:
     /** Helper object for interruptible select calls. */
     OSSelectWakeup selectHelper_;
 
+    /** True while the executor thread is about to go, or went to sleep in
+     * select. Producers of a lock-free run queue skip the wakeup when this is
+     * false; see wait_with_select(). */
+    std::atomic<bool> sleeping_ {false};
+
+#if OPENMRN_HAVE_EXECUTOR_PROFILE
+    /** If non-null, the cost of every Executable is recorded here. Owned by
+     * the executor. Written only on the executor thread, but add() reads it
+     * from any thread. */
+    std::atomic<ExecutorProfile *> profile_ {nullptr};
+#endif
+
 private:
     /** Retrieve an item from the front of the queue.
      * @param priority pass back the priority of the queue pulled from
@@ -185,6 +249,10 @@ private:
      */
     virtual Executable *next(unsigned *priority) = 0;
 
+    /** Runs an Executable taken from the queue.
+     * @param msg the executable to run. */
+    void run_one(Executable *msg);
+
     /** Executes a select call, and schedules any necessary executables based
      * on the return. Will not sleep at all if not empty, otherwise sleeps at
      * most next_timer_nsec nanoseconds (from now).
@@ -192,6 +260,11 @@ private:
      * @param next_timer_nsec is the maximum time to sleep in nanoseconds. */
     void wait_with_select(long long next_timer_nsec);
 
+    /** Sleeps in select (or epoll) and schedules the executables of the
+     * selectables that became ready.
+     * @param wait_length is the maximum time to sleep in nanoseconds. */
+    void select_and_dispatch(long long wait_length);
+
     /// Helper function.
     ///
     /// @param type a select type: READ, WRITE or EXCEPT
@@ -229,6 +302,11 @@ private:
     int selectNFds_;
     /** Head of the linked list for the select calls. */
     TypedQueue<Selectable> selectables_;
+#if OPENMRN_HAVE_EPOLL
+    /** If non-null, this registry holds the Selectables instead of the
+     * fd_sets and selectables_. */
+    std::unique_ptr<EpollSelectRegistry> epoll_;
+#endif
 
     /** Set to 1 when the executor thread has exited and it is safe to delete
      * *this. */
@@ -258,10 +336,27 @@ public:
     NO_THREAD() {}
 };
 
+/// Whether the run queue type Q inserts without taking a lock (declares
+/// LOCK_FREE_INSERT = true). Used by Executor::add().
+template <class Q, class = void> struct LockFreeInsert : std::false_type
+{
+};
+
+/// Specialization for run queues that declare LOCK_FREE_INSERT.
+template <class Q>
+struct LockFreeInsert<Q, decltype(void(Q::LOCK_FREE_INSERT))>
+    : std::integral_constant<bool, Q::LOCK_FREE_INSERT>
+{
+};
+
 /// Implementation the ExecutorBase with a specific number of priority
 /// bands. The memory usage and scheduling cost is proportional to the number
 /// of priority bands, so it should be kept pretty low.
-template <unsigned NUM_PRIO>
+///
+/// The run queue implementation can be overridden with the QUEUE template
+/// argument. QListLockFree<NUM_PRIO> avoids taking a lock in add(), which is
+/// useful when many threads notify flows on the same executor.
+template <unsigned NUM_PRIO, class QUEUE = QListProtected<NUM_PRIO>>
 class Executor : public ExecutorBase
 {
 public:
@@ -305,12 +400,30 @@ public:
      */
     void add(Executable *msg, unsigned priority = UINT_MAX) OVERRIDE
     {
+#if OPENMRN_HAVE_EXECUTOR_PROFILE
+        if (profile_.load(std::memory_order_relaxed))
+        {
+            msg->enqueueTime_ = os_get_time_monotonic();
+        }
+#endif
         queue_.insert(
             msg, priority >= NUM_PRIO ? NUM_PRIO - 1 : priority);
 #ifdef ESP_NONOS
         extern void wakeup_executor(ExecutorBase* executor);
         wakeup_executor(this);
 #else
+        if (LockFreeInsert<QUEUE>::value)
+        {
+            // The wakeup takes a lock. It is only needed if the executor
+            // might be sleeping. Pairs with the fence in wait_with_select():
+            // either we see sleeping_ set, or the executor sees our entry
+            // before going to sleep.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!sleeping_.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+        }
         selectHelper_.wakeup();
 #endif
     }
@@ -373,7 +486,7 @@ private:
     DISALLOW_COPY_AND_ASSIGN(Executor);
 
     /// Internal queue of executables waiting to be scheduled.
-    QListProtected<NUM_PRIO> queue_;
+    QUEUE queue_;
 };
 
 /** This class can be given an executor, and will notify itself when that
@@ -406,9 +519,9 @@ private:
     ExecutorBase* executor_;
 };
 
-template <unsigned NUM_PRIO>
+template <unsigned NUM_PRIO, class QUEUE>
 /** Destructs the executor. Waits for the executor to run out of work first. */
-Executor<NUM_PRIO>::~Executor()
+Executor<NUM_PRIO, QUEUE>::~Executor()
 {
     shutdown();
 }
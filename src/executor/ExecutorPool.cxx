@@ -0,0 +1,288 @@
+/** \copyright
+ * Copyright (c) 2026, Balazs Racz
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  - Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  - Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file ExecutorPool.cxx
+ *
+ * A set of executor threads with work stealing, for spreading the load of a
+ * Linux hub or gateway across multiple CPU cores.
+ *
+ * @author Balazs Racz
+ * @date 17 Oct 2026
+ */
+
+#include "executor/ExecutorPool.hxx"
+
+/// One worker thread of the pool. The Worker itself is an Executable that is
+/// scheduled on its own executor whenever there is something in its run queue
+/// (or when it should try to steal from the others). The executor interleaves
+/// it with the Services assigned to this worker.
+class ExecutorPool::Worker : public Executable, private Atomic
+{
+public:
+    /// Constructor. Does not start the thread.
+    /// @param parent the owning pool.
+    /// @param index index of this worker in the parent.
+    /// @param name thread name.
+    Worker(ExecutorPool *parent, unsigned index, std::string name)
+        : parent_(parent)
+        , index_(index)
+        , name_(std::move(name))
+        , executor_(NO_THREAD())
+        , service_(&executor_)
+    {
+    }
+
+    /// Starts the worker thread.
+    /// @param priority thread priority
+    /// @param stack_size thread stack size
+    void start(int priority, size_t stack_size)
+    {
+        executor_.start_thread(name_.c_str(), priority, stack_size);
+    }
+
+    /// Adds an executable to the end of the run queue. Thread-safe.
+    /// @param action the executable to queue.
+    /// @return true if this worker was already busy with the run queue, in
+    /// which case another worker could help.
+    bool push(Executable *action)
+    {
+        bool was_scheduled;
+        {
+            AtomicHolder h(this);
+            queue_.push_back(action);
+            was_scheduled = scheduled_;
+            scheduled_ = true;
+        }
+        if (!was_scheduled)
+        {
+            executor_.add(this);
+        }
+        return was_scheduled;
+    }
+
+    /// Schedules this worker to look for work if it has nothing to do right
+    /// now. Thread-safe.
+    /// @return true if the worker was idle and got scheduled.
+    bool wake_if_idle()
+    {
+        if (!executor_.empty())
+        {
+            return false;
+        }
+        {
+            AtomicHolder h(this);
+            if (scheduled_)
+            {
+                return false;
+            }
+            scheduled_ = true;
+        }
+        executor_.add(this);
+        return true;
+    }
+
+    /// Takes the oldest executable from the run queue. Thread-safe.
+    /// @return nullptr if the queue is empty.
+    Executable *pop_front()
+    {
+        AtomicHolder h(this);
+        if (queue_.empty())
+        {
+            return nullptr;
+        }
+        Executable *e = queue_.front();
+        queue_.pop_front();
+        return e;
+    }
+
+    /// Takes the newest executable from the run queue (used by the other
+    /// workers for stealing). Thread-safe.
+    /// @return nullptr if the queue is empty.
+    Executable *pop_back()
+    {
+        AtomicHolder h(this);
+        if (queue_.empty())
+        {
+            return nullptr;
+        }
+        Executable *e = queue_.back();
+        queue_.pop_back();
+        return e;
+    }
+
+    /// Called on the worker's executor. Runs a batch of executables from the
+    /// own queue, or stolen from the other workers.
+    void run() override
+    {
+        for (unsigned i = 0; i < BATCH_SIZE;)
+        {
+            Executable *e = pop_front();
+            if (!e)
+            {
+                e = parent_->steal(this);
+            }
+            if (!e)
+            {
+                AtomicHolder h(this);
+                if (queue_.empty())
+                {
+                    // A push() coming after this will schedule us again.
+                    scheduled_ = false;
+                    return;
+                }
+                // Raced with a push().
+                continue;
+            }
+            e->run();
+            ++i;
+        }
+        // Yields to the other work on this executor.
+        executor_.add(this);
+    }
+
+    /// Owning pool.
+    ExecutorPool *parent_;
+    /// Index of this worker in the parent's workers_.
+    unsigned index_;
+    /// Name of the thread.
+    std::string name_;
+    /// Executables waiting to be run. Protected by the Atomic lock.
+    std::deque<Executable *> queue_;
+    /// True if *this is queued on the executor or running. Protected by the
+    /// Atomic lock.
+    bool scheduled_ {false};
+    /// The executor running this worker thread.
+    Executor<1> executor_;
+    /// Service for the flows that have affinity to this worker.
+    Service service_;
+};
+
+ExecutorPool::ExecutorPool(
+    const char *name, unsigned num_threads, int priority, size_t stack_size)
+{
+    HASSERT(num_threads >= 1);
+    for (unsigned i = 0; i < num_threads; ++i)
+    {
+        workers_.emplace_back(
+            new Worker(this, i, std::string(name) + "." + std::to_string(i)));
+    }
+    // All workers have to exist before any thread is started, because the
+    // threads look at each other's run queues.
+    for (auto &w : workers_)
+    {
+        w->start(priority, stack_size);
+    }
+    // Executor::shutdown() is a no-op on a thread that did not get to run
+    // yet, so the destructor must not be able to overtake the thread start.
+    for (auto &w : workers_)
+    {
+        SyncNotifiable n;
+        w->executor_.add(new CallbackExecutable([&n]() { n.notify(); }));
+        n.wait_for_notification();
+    }
+}
+
+ExecutorPool::~ExecutorPool()
+{
+    HASSERT(!current_worker());
+    for (auto &w : workers_)
+    {
+        w->executor_.shutdown();
+    }
+    workers_.clear();
+}
+
+Service *ExecutorPool::service(unsigned index)
+{
+    HASSERT(index < workers_.size());
+    return &workers_[index]->service_;
+}
+
+Service *ExecutorPool::service_for(uintptr_t affinity_key)
+{
+    // Finalizer of MurmurHash3. Object addresses are aligned and file
+    // descriptors are sequential, so the low bits alone would pile up on a
+    // few workers.
+    uint64_t h = affinity_key;
+    h ^= h >> 33;
+    h *= UINT64_C(0xff51afd7ed558ccd);
+    h ^= h >> 33;
+    h *= UINT64_C(0xc4ceb9fe1a85ec53);
+    h ^= h >> 33;
+    return service(h % workers_.size());
+}
+
+ExecutorPool::Worker *ExecutorPool::current_worker()
+{
+    os_thread_t self = os_thread_self();
+    for (auto &w : workers_)
+    {
+        if (w->executor_.thread_handle() == self)
+        {
+            return w.get();
+        }
+    }
+    return nullptr;
+}
+
+void ExecutorPool::add(Executable *action)
+{
+    Worker *w = current_worker();
+    if (!w)
+    {
+        w = workers_[nextWorker_++ % workers_.size()].get();
+    }
+    if (w->push(action))
+    {
+        wake_idle_worker(w);
+    }
+}
+
+Executable *ExecutorPool::steal(Worker *thief)
+{
+    unsigned n = workers_.size();
+    for (unsigned i = 1; i < n; ++i)
+    {
+        Executable *e = workers_[(thief->index_ + i) % n]->pop_back();
+        if (e)
+        {
+            ++stealCount_;
+            return e;
+        }
+    }
+    return nullptr;
+}
+
+void ExecutorPool::wake_idle_worker(Worker *busy)
+{
+    for (auto &w : workers_)
+    {
+        if (w.get() != busy && w->wake_if_idle())
+        {
+            return;
+        }
+    }
+}
@@ -0,0 +1,164 @@
+/** \copyright
+ * Copyright (c) 2026, Balazs Racz
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  - Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  - Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file ExecutorPool.hxx
+ *
+ * A set of executor threads with work stealing, for spreading the load of a
+ * Linux hub or gateway across multiple CPU cores.
+ *
+ * @author Balazs Racz
+ * @date 17 Oct 2026
+ */
+
+#ifndef _EXECUTOR_EXECUTORPOOL_HXX_
+#define _EXECUTOR_EXECUTORPOOL_HXX_
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "executor/Executor.hxx"
+#include "executor/Service.hxx"
+#include "utils/Atomic.hxx"
+
+/// A set of worker threads, each running its own Executor. This is how a
+/// Linux hub or gateway process can use more than one CPU core.
+///
+/// There are two ways to put work on the pool:
+///
+/// - Services (and therefore all StateFlows and Timers using them) are
+/// assigned to one of the worker threads by an affinity key, see
+/// service_for(). All flows of a given Service run on the same thread, which
+/// keeps the usual guarantee that a StateFlow is never run concurrently with
+/// itself or with other flows of the same Service. Flows of different
+/// Services may run in parallel. Communication between flows of different
+/// Services has to go through thread-safe interfaces (e.g. Hubs, Buffers,
+/// Notifiables), the same way as between two separate Executors.
+///
+/// - Standalone Executables can be submitted with add(). These go to a
+/// per-thread run queue, and idle worker threads steal work from the queues
+/// of busy ones. Such an Executable may be run on any worker thread, so it
+/// must not touch state that belongs to a particular executor (Timers,
+/// Selectables, StateFlows of a Service).
+///
+/// Usage example:
+///
+///   ExecutorPool pool("hub_pool", 4);
+///   GcTcpHub hub(&can_hub, 12021, &pool);
+class ExecutorPool
+{
+public:
+    /// Creates the pool and starts the worker threads.
+    ///
+    /// @param name prefix of the thread (and executor) names. The workers
+    /// will be called name.0, name.1 etc.
+    /// @param num_threads how many worker threads to start. Must be >= 1.
+    /// @param priority thread priority (0 == default prio)
+    /// @param stack_size stack size of each worker thread in bytes.
+    ExecutorPool(const char *name, unsigned num_threads, int priority = 0,
+        size_t stack_size = 2048);
+
+    /// Stops all worker threads. Executables still waiting in the run queues
+    /// will not be run. Must not be called on one of the worker threads.
+    ~ExecutorPool();
+
+    /// @return the number of worker threads.
+    unsigned size()
+    {
+        return workers_.size();
+    }
+
+    /// @param index is the worker index, 0 <= index < size().
+    /// @return the Service that runs on that worker thread.
+    Service *service(unsigned index);
+
+    /// Looks up which worker thread should run a given piece of work. The
+    /// same key always results in the same Service.
+    ///
+    /// @param affinity_key is an arbitrary number identifying the work (e.g.
+    /// a file descriptor number or an object address).
+    /// @return the Service running on the worker that was chosen for the
+    /// key.
+    Service *service_for(uintptr_t affinity_key);
+
+    /// @return the executor of service_for(affinity_key).
+    ExecutorBase *executor_for(uintptr_t affinity_key)
+    {
+        return service_for(affinity_key)->executor();
+    }
+
+    /// Schedules an Executable to be run on any of the worker threads. If
+    /// called from a worker thread, the Executable is queued on the calling
+    /// thread's run queue, otherwise the workers are used in a round robin
+    /// fashion. If the chosen worker is busy, an idle worker will steal the
+    /// work. Thread-safe. Must not be called from an interrupt.
+    ///
+    /// @param action the Executable to run. Will be run exactly once.
+    void add(Executable *action);
+
+    /// @return how many times an Executable was run on a different worker
+    /// than it was queued to. Only for statistics and testing.
+    unsigned steal_count()
+    {
+        return stealCount_;
+    }
+
+private:
+    class Worker;
+
+    /// How many executables a worker runs from the run queues before yielding
+    /// to the other work of its executor (e.g. Selectables and flows).
+    static constexpr unsigned BATCH_SIZE = 16;
+
+    /// @return the worker object whose thread is calling this function, or
+    /// nullptr if called from a different thread.
+    Worker *current_worker();
+
+    /// Takes one Executable from the run queue of another worker.
+    /// @param thief the worker that is looking for work.
+    /// @return the stolen executable, or nullptr if all run queues are
+    /// empty.
+    Executable *steal(Worker *thief);
+
+    /// Schedules an idle worker (one that has nothing to run right now) to
+    /// come and steal some work.
+    /// @param busy the worker that has the excess work; this will not be
+    /// woken up.
+    void wake_idle_worker(Worker *busy);
+
+    /// All the worker threads.
+    std::vector<std::unique_ptr<Worker>> workers_;
+    /// Round robin counter for add() calls from outside the pool.
+    std::atomic<unsigned> nextWorker_ {0};
+    /// Statistics: number of Executables stolen.
+    std::atomic<unsigned> stealCount_ {0};
+
+    DISALLOW_COPY_AND_ASSIGN(ExecutorPool);
+};
+
+#endif // _EXECUTOR_EXECUTORPOOL_HXX_
@@ -0,0 +1,204 @@
+/** \copyright
+ * Copyright (c) 2026, Balazs Racz
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  - Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  - Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file ExecutorProfile.cxx
+ * Per-Executable run time accounting for host executors.
+ *
+ * @author Balazs Racz
+ * @date 17 Oct 2026
+ */
+
+#include "executor/ExecutorProfile.hxx"
+
+#if OPENMRN_HAVE_EXECUTOR_PROFILE
+
+#include <algorithm>
+#include <cxxabi.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "utils/StringPrintf.hxx"
+
+constexpr unsigned ExecutorProfile::TABLE_SIZE;
+
+string ExecutorProfile::Entry::name() const
+{
+    if (!type_)
+    {
+        return "(other)";
+    }
+    int status = 0;
+    char *d = abi::__cxa_demangle(type_->name(), nullptr, nullptr, &status);
+    if (!d)
+    {
+        return type_->name();
+    }
+    string ret(d);
+    free(d);
+    return ret;
+}
+
+ExecutorProfile::ExecutorProfile()
+{
+}
+
+long long ExecutorProfile::thread_cpu_time()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void ExecutorProfile::Sample::start(Executable *e)
+{
+    type_ = &typeid(*e);
+    queued_ = e->enqueueTime_;
+    e->enqueueTime_ = 0;
+    start_ = os_get_time_monotonic();
+    cpuStart_ = thread_cpu_time();
+}
+
+void ExecutorProfile::record(const Sample &s)
+{
+    long long cpu = thread_cpu_time() - s.cpuStart_;
+    long long wall = os_get_time_monotonic() - s.start_;
+    Entry *entry = lookup(s.type_);
+    ++entry->runs_;
+    entry->wallNsec_ += wall;
+    entry->cpuNsec_ += cpu;
+    if (s.queued_)
+    {
+        entry->waitNsec_ += s.start_ - s.queued_;
+    }
+    entry->maxRunNsec_ = std::max(entry->maxRunNsec_, wall);
+}
+
+ExecutorProfile::Entry *ExecutorProfile::lookup(const std::type_info *type)
+{
+    unsigned idx = (reinterpret_cast<uintptr_t>(type) >> 4) % TABLE_SIZE;
+    for (unsigned i = 0; i < TABLE_SIZE; ++i)
+    {
+        Entry *e = &table_[idx];
+        if (e->type_ == type)
+        {
+            return e;
+        }
+        if (!e->type_)
+        {
+            if (size_ >= TABLE_SIZE * 3 / 4)
+            {
+                // Keeps the probe sequences short.
+                break;
+            }
+            e->type_ = type;
+            ++size_;
+            return e;
+        }
+        idx = (idx + 1) % TABLE_SIZE;
+    }
+    return &table_[TABLE_SIZE];
+}
+
+void ExecutorProfile::clear()
+{
+    for (Entry &e : table_)
+    {
+        e = Entry();
+    }
+    size_ = 0;
+}
+
+void ExecutorProfile::snapshot(std::vector<Entry> *out)
+{
+    out->clear();
+    for (const Entry &e : table_)
+    {
+        if (e.runs_)
+        {
+            out->push_back(e);
+        }
+    }
+    std::sort(out->begin(), out->end(), [](const Entry &a, const Entry &b) {
+        return a.cpuNsec_ > b.cpuNsec_;
+    });
+}
+
+string ExecutorProfile::format(
+    const std::vector<Entry> &entries, unsigned max_lines)
+{
+    string ret = StringPrintf("%10s %10s %10s %10s %10s  %s\n", "runs",
+        "cpu_ms", "wall_ms", "avg_wait_us", "max_run_us", "executable");
+    for (unsigned i = 0; i < entries.size() && i < max_lines; ++i)
+    {
+        const Entry &e = entries[i];
+        ret += StringPrintf("%10" PRIu64 " %10.3f %10.3f %10.1f %10.1f  %s\n",
+            e.runs_, e.cpuNsec_ / 1e6, e.wallNsec_ / 1e6,
+            e.waitNsec_ / 1e3 / e.runs_, e.maxRunNsec_ / 1e3,
+            e.name().c_str());
+    }
+    return ret;
+}
+
+void ExecutorProfileLog::shutdown()
+{
+    bool done = false;
+    while (!done)
+    {
+        service()->executor()->sync_run([this, &done]() {
+            stop_ = true;
+            timer_.ensure_triggered();
+            done = is_terminated();
+        });
+    }
+}
+
+StateFlowBase::Action ExecutorProfileLog::log_and_wait()
+{
+    if (stop_)
+    {
+        return exit();
+    }
+    ExecutorProfile *p = service()->executor()->profile();
+    if (p)
+    {
+        std::vector<ExecutorProfile::Entry> entries;
+        p->snapshot(&entries);
+        p->clear();
+        string table = ExecutorProfile::format(entries, maxLines_);
+        LOG(INFO, "Executor profile:");
+        // One line at a time, so that a long table does not get truncated.
+        size_t start = 0;
+        size_t end;
+        while ((end = table.find('\n', start)) != string::npos)
+        {
+            LOG(INFO, "%s", table.substr(start, end - start).c_str());
+            start = end + 1;
+        }
+    }
+    return sleep_and_call(&timer_, period_, STATE(log_and_wait));
+}
+
+#endif // OPENMRN_HAVE_EXECUTOR_PROFILE
@@ -0,0 +1,182 @@
+/** \copyright
+ * Copyright (c) 2026, Balazs Racz
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  - Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  - Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file ExecutorProfile.hxx
+ * Per-Executable run time accounting for host executors.
+ *
+ * @author Balazs Racz
+ * @date 17 Oct 2026
+ */
+
+#ifndef _EXECUTOR_EXECUTORPROFILE_HXX_
+#define _EXECUTOR_EXECUTORPROFILE_HXX_
+
+#include "openmrn_features.h"
+
+#if OPENMRN_HAVE_EXECUTOR_PROFILE
+
+#include <typeinfo>
+#include <vector>
+
+#include "executor/StateFlow.hxx"
+#include "utils/macros.h"
+
+/// Records how much time the Executables of an executor take, aggregated by
+/// the class of the Executable (StateFlows, Timers, CallbackExecutables,
+/// etc). Owned by the executor, see ExecutorBase::set_profile().
+///
+/// The table has a fixed size; once it is full, new classes are added up in
+/// a single overflow entry. All functions must be called on the executor
+/// thread.
+class ExecutorProfile
+{
+public:
+    /// Accumulated cost of one Executable class.
+    struct Entry
+    {
+        /// Class of the Executable. nullptr for the overflow entry.
+        const std::type_info *type_ {nullptr};
+        /// Number of times run() was called.
+        uint64_t runs_ {0};
+        /// Total wall time spent in run(), nsec.
+        long long wallNsec_ {0};
+        /// Total thread CPU time spent in run(), nsec.
+        long long cpuNsec_ {0};
+        /// Total time between being added to the executor and run(),
+        /// nsec.
+        long long waitNsec_ {0};
+        /// Longest wall time of a single run(), nsec.
+        long long maxRunNsec_ {0};
+
+        /// @return human-readable (demangled) class name.
+        string name() const;
+    };
+
+    /// Measurement of a single run of an Executable.
+    class Sample
+    {
+    public:
+        /// Starts the measurement. Call just before running the executable.
+        /// @param e the executable, taken off the executor's queue.
+        void start(Executable *e);
+
+    private:
+        friend class ExecutorProfile;
+        /// Class of the executable. Taken before run(), because the
+        /// executable may delete itself.
+        const std::type_info *type_;
+        /// When the executable was added to the queue, or zero.
+        long long queued_;
+        /// Wall time at the start of run().
+        long long start_;
+        /// Thread CPU time at the start of run().
+        long long cpuStart_;
+    };
+
+    /// Number of Executable classes that can be told apart.
+    static constexpr unsigned TABLE_SIZE = 256;
+
+    ExecutorProfile();
+
+    /// Finishes a measurement and adds it to the table. Call just after the
+    /// executable's run() returned.
+    /// @param s the measurement started before run().
+    void record(const Sample &s);
+
+    /// Forgets all recorded data.
+    void clear();
+
+    /// Copies out the recorded entries, most CPU time first.
+    /// @param out will be filled with the non-empty entries.
+    void snapshot(std::vector<Entry> *out);
+
+    /// Formats recorded entries as a text table.
+    /// @param entries output of snapshot()
+    /// @param max_lines how many entries to print at most
+    /// @return the table, one line per entry with a header line.
+    static string format(const std::vector<Entry> &entries, unsigned max_lines);
+
+    /// @return current thread CPU time in nsec.
+    static long long thread_cpu_time();
+
+private:
+    /// Finds or creates the entry of a class.
+    /// @param type class of an Executable
+    /// @return entry in the table (maybe the overflow entry).
+    Entry *lookup(const std::type_info *type);
+
+    /// Open addressing hash table, with the overflow entry at the end.
+    Entry table_[TABLE_SIZE + 1];
+    /// Number of classes in table_.
+    unsigned size_ {0};
+
+    DISALLOW_COPY_AND_ASSIGN(ExecutorProfile);
+};
+
+/// State flow that periodically logs the Executables that took the most CPU
+/// time on an executor since the last log, then clears the recorded data.
+/// Turns on recording on the executor if it was off.
+class ExecutorProfileLog : public StateFlowBase
+{
+public:
+    /// Constructor.
+    /// @param service defines the executor to watch.
+    /// @param period_nsec how often to log.
+    /// @param max_lines how many Executable classes to print.
+    ExecutorProfileLog(Service *service,
+        long long period_nsec = SEC_TO_NSEC(10), unsigned max_lines = 10)
+        : StateFlowBase(service)
+        , period_(period_nsec)
+        , maxLines_(max_lines)
+    {
+        start_flow(STATE(start));
+    }
+
+    /// Stops logging. Must be called before destroying *this, and not on the
+    /// executor thread.
+    void shutdown();
+
+private:
+    Action start()
+    {
+        service()->executor()->set_profile(true);
+        return sleep_and_call(&timer_, period_, STATE(log_and_wait));
+    }
+
+    Action log_and_wait();
+
+    StateFlowTimer timer_ {this};
+    /// How often to log.
+    long long period_;
+    /// How many lines to log.
+    unsigned maxLines_;
+    /// Set by shutdown().
+    bool stop_ {false};
+};
+
+#endif // OPENMRN_HAVE_EXECUTOR_PROFILE
+
+#endif // _EXECUTOR_EXECUTORPROFILE_HXX_
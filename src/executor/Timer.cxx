@@ -34,6 +34,7 @@
 
 #include "executor/Timer.hxx"
 #include "executor/Executor.hxx"
+#include "executor/TimerWheel.hxx"
 #include "os/os.h"
 
 Timer::~Timer()
@@ -81,13 +82,51 @@ void ActiveTimers::run()
     // call.
 }
 
+#if OPENMRN_HAVE_TIMER_WHEEL
+void ActiveTimers::set_timer_wheel(bool enabled)
+{
+    OSMutexLock l(&lock_);
+    HASSERT(activeTimers_.next == nullptr);
+    HASSERT(!wheel_ || wheel_->empty());
+    if (enabled)
+    {
+        wheel_.reset(new TimerWheel());
+    }
+    else
+    {
+        wheel_.reset();
+    }
+}
+#endif
+
+void ActiveTimers::expire_locked(Timer *timer)
+{
+    timer->isActive_ = 0;
+    timer->isExpired_ = 1;
+    // Puts it on the executor.
+    executor_->add(timer, timer->priority_);
+}
+
 long long ActiveTimers::get_next_timeout()
 {
     OSMutexLock l(&lock_);
 
+    long long now = OSTime::get_monotonic();
+#if OPENMRN_HAVE_TIMER_WHEEL
+    if (wheel_)
+    {
+        wheel_->expire(now);
+        bool found_timer = false;
+        while (Timer *t = wheel_->next_expired())
+        {
+            found_timer = true;
+            expire_locked(t);
+        }
+        return found_timer ? 0 : wheel_->get_next_timeout(now);
+    }
+#endif
     QMember **last = &activeTimers_.next;
     Timer *current_timer = static_cast<Timer *>(*last);
-    long long now = OSTime::get_monotonic();
     bool found_timer = false;
     while (current_timer && current_timer->when_ <= now)
     {
@@ -95,11 +134,7 @@ long long ActiveTimers::get_next_timeout()
         found_timer = true;
         *last = current_timer->next;
         current_timer->next = nullptr;
-
-        current_timer->isActive_ = 0;
-        current_timer->isExpired_ = 1;
-        // Puts it on the executor.
-        executor_->add(current_timer, current_timer->priority_);
+        expire_locked(current_timer);
         // Takes the next timer.
         current_timer = static_cast<Timer *>(*last);
     }
@@ -123,6 +158,12 @@ long long ActiveTimers::get_next_timeout()
 
 bool ActiveTimers::empty() {
     OSMutexLock l(&lock_);
+#if OPENMRN_HAVE_TIMER_WHEEL
+    if (wheel_)
+    {
+        return wheel_->empty();
+    }
+#endif
 
     QMember **last = &activeTimers_.next;
     Timer *current_timer = static_cast<Timer *>(*last);
@@ -139,6 +180,14 @@ void ActiveTimers::insert_locked(Timer *timer)
 {
     HASSERT(timer);
     HASSERT(timer->next == nullptr);
+#if OPENMRN_HAVE_TIMER_WHEEL
+    if (wheel_)
+    {
+        wheel_->insert(timer);
+        notify();
+        return;
+    }
+#endif
 
     QMember **last = &activeTimers_.next;
     Timer *current_timer = static_cast<Timer *>(*last);
@@ -159,6 +208,13 @@ void ActiveTimers::insert_locked(Timer *timer)
 void ActiveTimers::remove_locked(Timer *timer)
 {
     HASSERT(timer);
+#if OPENMRN_HAVE_TIMER_WHEEL
+    if (wheel_)
+    {
+        wheel_->remove(timer);
+        return;
+    }
+#endif
     // Removes the timer from the queue.
     QMember **last = &activeTimers_.next;
     while (*last && *last != timer)
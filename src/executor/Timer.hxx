@@ -35,7 +35,11 @@
 #ifndef _EXECUTOR_TIMER_HXX_
 #define _EXECUTOR_TIMER_HXX_
 
+#include <memory>
+
+#include "openmrn_features.h"
 #include "executor/Notifiable.hxx"
+#include "executor/TimerWheel.hxx"
 #include "utils/Buffer.hxx"
 #include "utils/QMember.hxx"
 #include "os/OS.hxx"
@@ -77,7 +81,7 @@ public:
 
     /** Updates the expiration time of an already scheduled timer. This call is
      * somewhat expensive, because it needs to walk the entire queue of active
-     * timers. May wake up the executor.
+     * timers (constant time with the timer wheel). May wake up the executor.
      *
      * @param timer is the timer whose next execution time has been updated. It
      * must already be scheduled. */
@@ -85,7 +89,8 @@ public:
 
     /** Deletes an already scheduled but not yet expired timer. This call is
      * somewhat expensive, because it needs to walk the entire queue of active
-     * timers. Asserts that the timer is in fact not yet expired.
+     * timers (constant time with the timer wheel). Asserts that the timer is
+     * in fact not yet expired.
      *
      * @param timer is the timer to delete. */
     void remove_timer(::Timer *timer);
@@ -96,6 +101,24 @@ public:
         return executor_;
     }
 
+#if OPENMRN_HAVE_TIMER_WHEEL
+    /** Switches between the sorted list and the hierarchical timing wheel
+     * for storing the active timers. The list is cheaper for a few timers;
+     * the wheel has constant time schedule, update and remove, which matters
+     * with thousands of timers. The initial setting comes from the
+     * executor_timer_wheel constant. Must be called when there are no
+     * active timers.
+     * @param enabled true to use the timing wheel.
+     */
+    void set_timer_wheel(bool enabled);
+
+    /** @return true if the timing wheel is in use. */
+    bool timer_wheel()
+    {
+        return wheel_.get() != nullptr;
+    }
+#endif
+
     /** Notification callback from the timer. Schedules *this on the
      * executor. */
     void notify() override;
@@ -113,12 +136,20 @@ private:
      * @param timer what to insert into the active list. */
     void insert_locked(::Timer *timer);
 
+    /** Moves an expired timer to the executor. Caller must hold the lock.
+     * @param timer the timer that was taken out of the active list. */
+    void expire_locked(::Timer *timer);
+
     /// Parent.
     ExecutorBase *executor_;
     /// Protects the timer list.
     OSMutex lock_;
     /// List of timers that are scheduled.
     QMember activeTimers_;
+#if OPENMRN_HAVE_TIMER_WHEEL
+    /// If not null, the timers are scheduled here instead of activeTimers_.
+    std::unique_ptr<TimerWheel> wheel_;
+#endif
     /// 1 if we in the executor's queue.
     std::atomic_uint_least8_t isPending_;
 
@@ -292,6 +323,7 @@ protected:
 
 private:
     friend class ActiveTimers;  // for scheduling an expiring timers
+    friend class TimerWheel;    // for scheduling an expiring timers
     friend class CountingTimer; // for testing
 
     /** Points to the executor's timer structure. Not owned. */
@@ -302,6 +334,10 @@ private:
     long long when_;
     /** period in nanoseconds for timer */
     long long period_;
+#if OPENMRN_HAVE_TIMER_WHEEL
+    /** Points to the link that points to this timer in the TimerWheel. */
+    QMember **pprev_ {nullptr};
+#endif
     /** true when the timer is in the active timers list */
     unsigned isActive_ : 1;
     /** True when the timer is in the pending executables list of the
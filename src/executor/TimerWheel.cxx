@@ -0,0 +1,306 @@
+/** \copyright
+ * Copyright (c) 2026, Balazs Racz
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  - Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  - Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file TimerWheel.cxx
+ * Hierarchical timing wheel for the executor's timers.
+ *
+ * @author Balazs Racz
+ * @date 17 Oct 2026
+ */
+
+#include "executor/TimerWheel.hxx"
+
+#if OPENMRN_HAVE_TIMER_WHEEL
+
+#include "executor/Timer.hxx"
+#include "os/os.h"
+
+/// Rotates a bitmask right.
+/// @param m bitmask @param k by how many bits (0..63).
+/// @return rotated value.
+static inline uint64_t rotate_right(uint64_t m, unsigned k)
+{
+    return (m >> k) | (m << ((64 - k) & 63));
+}
+
+TimerWheel::TimerWheel()
+    : curTick_(to_tick(OSTime::get_monotonic()))
+{
+    for (unsigned l = 0; l < LEVELS; ++l)
+    {
+        occupied_[l] = 0;
+        for (unsigned i = 0; i < SLOTS; ++i)
+        {
+            slots_[l][i] = nullptr;
+        }
+    }
+}
+
+void TimerWheel::insert(Timer *timer)
+{
+    HASSERT(timer->next == nullptr);
+    link(timer);
+    ++size_;
+}
+
+void TimerWheel::link(Timer *timer)
+{
+    long long tick = to_tick(timer->when_);
+    long long delta = tick - curTick_;
+    unsigned level = 0;
+    unsigned idx;
+    if (delta <= 0)
+    {
+        // Expired or expiring in the current tick.
+        idx = curTick_ & SLOT_MASK;
+    }
+    else
+    {
+        static constexpr long long MAX_DELTA = 1LL << (LEVEL_BITS * LEVELS);
+        if (delta >= MAX_DELTA)
+        {
+            // Will be re-inserted when the top level slot gets cascaded.
+            delta = MAX_DELTA - 1;
+            tick = curTick_ + delta;
+        }
+        while (delta >= (1LL << (LEVEL_BITS * (level + 1))))
+        {
+            ++level;
+        }
+        idx = (tick >> (LEVEL_BITS * level)) & SLOT_MASK;
+    }
+    QMember **head = &slots_[level][idx];
+    timer->next = *head;
+    if (*head)
+    {
+        static_cast<Timer *>(*head)->pprev_ = &timer->next;
+    }
+    *head = timer;
+    timer->pprev_ = head;
+    occupied_[level] |= UINT64_C(1) << idx;
+}
+
+void TimerWheel::remove(Timer *timer)
+{
+    QMember **pprev = timer->pprev_;
+    HASSERT(pprev && *pprev == timer);
+    *pprev = timer->next;
+    if (timer->next)
+    {
+        static_cast<Timer *>(timer->next)->pprev_ = pprev;
+    }
+    else if (pprev >= &slots_[0][0] && pprev < &slots_[0][0] + LEVELS * SLOTS &&
+        !*pprev)
+    {
+        // Slot became empty.
+        unsigned ofs = pprev - &slots_[0][0];
+        occupied_[ofs / SLOTS] &= ~(UINT64_C(1) << (ofs % SLOTS));
+    }
+    timer->next = nullptr;
+    timer->pprev_ = nullptr;
+    --size_;
+}
+
+QMember *TimerWheel::take_slot(unsigned level, unsigned idx)
+{
+    QMember *list = slots_[level][idx];
+    slots_[level][idx] = nullptr;
+    occupied_[level] &= ~(UINT64_C(1) << idx);
+    return list;
+}
+
+void TimerWheel::add_expired(QMember *list)
+{
+    while (list)
+    {
+        Timer *timer = static_cast<Timer *>(list);
+        list = list->next;
+        timer->pprev_ = nullptr;
+        timer->next = expired_;
+        expired_ = timer;
+        --size_;
+    }
+}
+
+void TimerWheel::cascade(unsigned level)
+{
+    unsigned idx = (curTick_ >> (LEVEL_BITS * level)) & SLOT_MASK;
+    QMember *list = take_slot(level, idx);
+    while (list)
+    {
+        Timer *timer = static_cast<Timer *>(list);
+        list = list->next;
+        timer->next = nullptr;
+        link(timer);
+    }
+    if (idx == 0 && level + 1 < LEVELS)
+    {
+        cascade(level + 1);
+    }
+}
+
+void TimerWheel::rebuild(long long now_tick)
+{
+    QMember *all = nullptr;
+    for (unsigned l = 0; l < LEVELS; ++l)
+    {
+        while (occupied_[l])
+        {
+            QMember *list = take_slot(l, __builtin_ctzll(occupied_[l]));
+            while (list)
+            {
+                QMember *n = list->next;
+                list->next = all;
+                all = list;
+                list = n;
+            }
+        }
+    }
+    curTick_ = now_tick;
+    while (all)
+    {
+        Timer *timer = static_cast<Timer *>(all);
+        all = all->next;
+        timer->next = nullptr;
+        link(timer);
+    }
+}
+
+void TimerWheel::advance(long long now_tick)
+{
+    if (size_ == 0)
+    {
+        if (now_tick > curTick_)
+        {
+            curTick_ = now_tick;
+        }
+        return;
+    }
+    if (now_tick - curTick_ > REBUILD_TICKS)
+    {
+        rebuild(now_tick);
+        return;
+    }
+    while (curTick_ < now_tick)
+    {
+        // Everything in the current slot is in the past.
+        unsigned idx = curTick_ & SLOT_MASK;
+        if (occupied_[0] & (UINT64_C(1) << idx))
+        {
+            add_expired(take_slot(0, idx));
+        }
+        // Skips to the next non-empty slot, but stops at the end of the
+        // level 0 round to perform the cascade.
+        long long limit = (curTick_ | SLOT_MASK) + 1;
+        if (limit > now_tick)
+        {
+            limit = now_tick;
+        }
+        uint64_t later = idx == SLOT_MASK ? 0 : occupied_[0] >> (idx + 1);
+        long long next =
+            later ? curTick_ + 1 + __builtin_ctzll(later) : limit;
+        curTick_ = next < limit ? next : limit;
+        if ((curTick_ & SLOT_MASK) == 0)
+        {
+            cascade(1);
+        }
+    }
+}
+
+void TimerWheel::expire(long long now)
+{
+    advance(to_tick(now));
+    QMember *t = slots_[0][curTick_ & SLOT_MASK];
+    while (t)
+    {
+        Timer *timer = static_cast<Timer *>(t);
+        t = t->next;
+        if (timer->when_ <= now)
+        {
+            remove(timer);
+            timer->next = expired_;
+            expired_ = timer;
+        }
+    }
+}
+
+Timer *TimerWheel::next_expired()
+{
+    if (!expired_)
+    {
+        return nullptr;
+    }
+    Timer *timer = static_cast<Timer *>(expired_);
+    expired_ = timer->next;
+    timer->next = nullptr;
+    return timer;
+}
+
+long long TimerWheel::get_next_timeout(long long now)
+{
+    if (size_ == 0)
+    {
+        return SEC_TO_NSEC(3600);
+    }
+    long long best = INT64_MAX;
+    if (occupied_[0])
+    {
+        // The first non-empty slot on level 0 has the earliest timers; we
+        // compute the exact expiration time.
+        unsigned c = curTick_ & SLOT_MASK;
+        unsigned d = __builtin_ctzll(rotate_right(occupied_[0], c));
+        for (QMember *t = slots_[0][(c + d) & SLOT_MASK]; t; t = t->next)
+        {
+            long long w = static_cast<Timer *>(t)->when_;
+            if (w < best)
+            {
+                best = w;
+            }
+        }
+    }
+    for (unsigned level = 1; level < LEVELS; ++level)
+    {
+        if (!occupied_[level])
+        {
+            continue;
+        }
+        // On the higher levels we wake up at the beginning of the first
+        // non-empty slot, to cascade it.
+        unsigned shift = LEVEL_BITS * level;
+        long long base = curTick_ >> shift;
+        unsigned c = (base + 1) & SLOT_MASK;
+        long long d = 1 + __builtin_ctzll(rotate_right(occupied_[level], c));
+        long long start = ((base + d) << shift) << TICK_SHIFT;
+        if (start < best)
+        {
+            best = start;
+        }
+    }
+    long long ret = best - now;
+    return ret < 0 ? 0 : ret;
+}
+
+#endif // OPENMRN_HAVE_TIMER_WHEEL
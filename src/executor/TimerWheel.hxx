@@ -0,0 +1,164 @@
+/** \copyright
+ * Copyright (c) 2026, Balazs Racz
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  - Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  - Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file TimerWheel.hxx
+ * Hierarchical timing wheel for the executor's timers.
+ *
+ * @author Balazs Racz
+ * @date 17 Oct 2026
+ */
+
+#ifndef _EXECUTOR_TIMERWHEEL_HXX_
+#define _EXECUTOR_TIMERWHEEL_HXX_
+
+#include "openmrn_features.h"
+
+#if OPENMRN_HAVE_TIMER_WHEEL
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "utils/QMember.hxx"
+#include "utils/macros.h"
+
+class Timer;
+
+/// Keeps a set of scheduled timers in a hierarchical timing wheel (Varghese
+/// and Lauck). Inserting and removing a timer is constant time; expiring
+/// timers is amortized constant time per timer. Used by ActiveTimers instead
+/// of the sorted list when the executor has many timers.
+///
+/// Time is counted in ticks of 2^TICK_SHIFT nanoseconds (about 1 msec). Level
+/// 0 has one slot per tick for the next SLOTS ticks; each further level has
+/// SLOTS times coarser slots. Timers on the higher levels are moved (cascaded)
+/// to the lower levels when the current time reaches their slot. Timers in the
+/// current tick are compared to the exact expiration time, so timers never
+/// fire early. The order in which timers expiring in the same tick are
+/// returned is unspecified.
+///
+/// Each slot is a doubly linked list through Timer::next and Timer::pprev_, so
+/// removal does not need to find the slot. There is no locking; the caller
+/// (ActiveTimers) holds the lock.
+class TimerWheel
+{
+public:
+    TimerWheel();
+
+    /// Adds a timer. @param timer the timer to schedule, with when_ already
+    /// set. Must not be scheduled.
+    void insert(Timer *timer);
+
+    /// Removes a scheduled timer that has not yet expired. @param timer what
+    /// to remove.
+    void remove(Timer *timer);
+
+    /// @return true if there are no timers scheduled.
+    bool empty()
+    {
+        return size_ == 0 && !expired_;
+    }
+
+    /// Takes out all timers that are expired at a given time. They have to be
+    /// fetched with next_expired() afterwards.
+    /// @param now current time (nsec).
+    void expire(long long now);
+
+    /// @return the next timer that was taken out by expire(), or nullptr if
+    /// there are no more.
+    Timer *next_expired();
+
+    /// Computes how long the executor may sleep. Must be called right after
+    /// expire() with the same time.
+    /// @param now current time (nsec).
+    /// @return time until the next timer expires, or a shorter time when the
+    /// next timer is on a higher level of the wheel. If there are no timers,
+    /// returns one hour.
+    long long get_next_timeout(long long now);
+
+private:
+    /// Ticks are this many nanoseconds (as a power of two).
+    static constexpr unsigned TICK_SHIFT = 20;
+    /// Number of slots per level is 2^LEVEL_BITS.
+    static constexpr unsigned LEVEL_BITS = 6;
+    /// Number of slots per level.
+    static constexpr unsigned SLOTS = 1u << LEVEL_BITS;
+    /// Mask to compute the slot index on a level.
+    static constexpr unsigned SLOT_MASK = SLOTS - 1;
+    /// Number of levels. The wheel covers 2^36 ticks (about two years);
+    /// timers further out wait on the top level.
+    static constexpr unsigned LEVELS = 6;
+    /// If the time jumped forward by more than this many ticks, we rebuild
+    /// the wheel instead of walking through the slots.
+    static constexpr long long REBUILD_TICKS = SLOTS * SLOTS;
+
+    /// @param nsec a timestamp @return the tick number of that timestamp.
+    static long long to_tick(long long nsec)
+    {
+        return nsec < 0 ? 0 : nsec >> TICK_SHIFT;
+    }
+
+    /// Inserts a timer into the appropriate slot relative to curTick_, without
+    /// updating size_. @param timer the timer to insert.
+    void link(Timer *timer);
+
+    /// Moves the current time forward, collecting all timers in the ticks
+    /// passed into expired_. @param now_tick current time (ticks).
+    void advance(long long now_tick);
+
+    /// Prepends a list of timers to expired_. @param list timers linked by
+    /// next.
+    void add_expired(QMember *list);
+
+    /// Re-inserts the timers of the current slot on a given level into the
+    /// lower levels. @param level which level, 1 or more.
+    void cascade(unsigned level);
+
+    /// Takes out all timers from the wheel and re-inserts them relative to a
+    /// new current time. @param now_tick the new current tick.
+    void rebuild(long long now_tick);
+
+    /// Removes all timers from a slot. @param level level of the slot
+    /// @param idx index of the slot. @return the removed timers in a list
+    /// linked by next.
+    QMember *take_slot(unsigned level, unsigned idx);
+
+    /// Heads of the doubly linked lists for each slot.
+    QMember *slots_[LEVELS][SLOTS];
+    /// Bit i is set if slots_[level][i] is not empty.
+    uint64_t occupied_[LEVELS];
+    /// Timers that were collected in advance() but not yet handed out.
+    QMember *expired_ {nullptr};
+    /// The tick where the wheel's current time is.
+    long long curTick_;
+    /// How many timers are in the slots of the wheel.
+    size_t size_ {0};
+
+    DISALLOW_COPY_AND_ASSIGN(TimerWheel);
+};
+
+#endif // OPENMRN_HAVE_TIMER_WHEEL
+
+#endif // _EXECUTOR_TIMERWHEEL_HXX_
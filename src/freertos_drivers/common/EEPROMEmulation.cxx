@@ -33,6 +33,7 @@
 
 #include "EEPROMEmulation.hxx"
 
+#include <algorithm>
 #include <cstring>
 
 const size_t EEPROMEmulation::HEADER_BLOCK_COUNT = 3;
@@ -104,6 +105,15 @@ void EEPROMEmulation::mount()
         }
     }
 
+    /* do we keep an index of the latest slots in RAM to speed up reads */
+    if (!SHADOW_IN_RAM && RAM_INDEX_GROUP_SIZE)
+    {
+        HASSERT((RAM_INDEX_GROUP_SIZE % BYTES_PER_BLOCK) == 0);
+        indexGroupBlocks_ = RAM_INDEX_GROUP_SIZE / BYTES_PER_BLOCK;
+        index_ = new uint16_t[index_group_count()];
+        rebuild_index();
+    }
+
     /* do we shadow_ the data in RAM to speed up reads */
     if (SHADOW_IN_RAM)
     {
@@ -130,9 +140,6 @@ void EEPROMEmulation::write(unsigned int index, const void *buf, size_t len)
     HASSERT((index + len) <= file_size());
 
     uint8_t* byte_data = (uint8_t*)buf;
-    uint8_t* shadow_data = (uint8_t*)buf;
-    unsigned shadow_index = index;
-    size_t shadow_len = len;
 
     while (len)
     {
@@ -191,11 +198,6 @@ void EEPROMEmulation::write(unsigned int index, const void *buf, size_t len)
         }
     }
 
-    if (shadowInRam_)
-    {
-        memcpy(shadow_ + shadow_index, shadow_data, shadow_len);
-    }
-
     updated_notification();
 }
 
@@ -205,6 +207,15 @@ void EEPROMEmulation::write(unsigned int index, const void *buf, size_t len)
  */
 void EEPROMEmulation::write_fblock(unsigned int index, const uint8_t data[])
 {
+    if (shadowInRam_)
+    {
+        /* Updates the shadow before a potential sector overflow copies the
+         * data from it. */
+        size_t len = std::min(
+            BYTES_PER_BLOCK, file_size() - (index * BYTES_PER_BLOCK));
+        memcpy(shadow_ + (index * BYTES_PER_BLOCK), data, len);
+    }
+
     if (availableSlots_)
     {
         /* still have room in this sector for at least one more write */
@@ -215,8 +226,10 @@ void EEPROMEmulation::write_fblock(unsigned int index, const uint8_t data[])
                            (data[(i * 2) + 1] << 8) |
                            (data[(i * 2) + 0] << 0);
         }
-        flash_program(activeSector_, rawBlockCount_ - availableSlots_, slot_data, BLOCK_SIZE);
+        unsigned slot = rawBlockCount_ - availableSlots_;
+        flash_program(activeSector_, slot, slot_data, BLOCK_SIZE);
         --availableSlots_;
+        update_index(index, slot);
     }
     else
     {
@@ -271,6 +284,10 @@ void EEPROMEmulation::write_fblock(unsigned int index, const uint8_t data[])
         flash_program(activeSector_, MAGIC_USED_INDEX, magic, BLOCK_SIZE);
         activeSector_ = new_sector;
         availableSlots_ = available_slots;
+        if (index_)
+        {
+            rebuild_index();
+        }
     }
 }
 
@@ -290,6 +307,23 @@ void EEPROMEmulation::read(unsigned int offset, void *buf, size_t len)
     }
 
     uint8_t *byte_data = (uint8_t *)buf;
+    if (index_)
+    {
+        // Looks up each block separately via the index.
+        while (len)
+        {
+            unsigned lsa = offset & (BYTES_PER_BLOCK - 1);
+            size_t copylen = std::min(len, BYTES_PER_BLOCK - lsa);
+            uint8_t data[MAX_BLOCK_SIZE];
+            read_fblock(offset / BYTES_PER_BLOCK, data);
+            memcpy(byte_data, data + lsa, copylen);
+            offset += copylen;
+            len -= copylen;
+            byte_data += copylen;
+        }
+        return;
+    }
+
     memset(byte_data, 0xff, len); // default if data not found
 
     for (unsigned block_index = slot_first();
@@ -309,11 +343,7 @@ void EEPROMEmulation::read(unsigned int offset, void *buf, size_t len)
         }
         // Reads the block
         uint8_t data[MAX_BLOCK_SIZE];
-        for (unsigned int i = 0; i < BLOCK_SIZE / sizeof(uint32_t); ++i)
-        {
-            data[(i * 2) + 0] = (address[i] >> 0) & 0xFF;
-            data[(i * 2) + 1] = (address[i] >> 8) & 0xFF;
-        }
+        decode_slot(address, data);
         // Copies the right part into the output buffer.
         unsigned slotofs, bufofs;
         if (slot_offset < offset)
@@ -360,8 +390,21 @@ bool EEPROMEmulation::read_fblock(unsigned int index, uint8_t data[])
         /* default data value if not found */
         memset(data, 0xFF, BYTES_PER_BLOCK);
 
+        /* where to start looking: the latest slot of the group if we have
+         * an index, otherwise the end of the sector */
+        unsigned start = slot_last();
+        if (index_)
+        {
+            start = index_[index / indexGroupBlocks_];
+            if (start == 0)
+            {
+                /* nothing in this group was ever written */
+                return false;
+            }
+        }
+
         /* look for data */
-        for (unsigned raw_block = slot_last();
+        for (unsigned raw_block = start;
              raw_block >= slot_first();
              --raw_block)
         {
@@ -369,11 +412,7 @@ bool EEPROMEmulation::read_fblock(unsigned int index, uint8_t data[])
             if (index == (*address >> 16))
             {
                 /* found the data */
-                for (unsigned int i = 0; i < BLOCK_SIZE / sizeof(uint32_t); ++i)
-                {
-                    data[(i * 2) + 0] = (address[i] >> 0) & 0xFF;
-                    data[(i * 2) + 1] = (address[i] >> 8) & 0xFF;
-                }
+                decode_slot(address, data);
                 return true;
             }
         }
@@ -381,3 +420,30 @@ bool EEPROMEmulation::read_fblock(unsigned int index, uint8_t data[])
 
     return false;
 }
+
+/** Decodes the data payload of a slot.
+ * @param address pointer to the slot in flash
+ * @param data location to place the data, array size must be @ref
+ *           BYTES_PER_BLOCK large
+ */
+void EEPROMEmulation::decode_slot(const uint32_t *address, uint8_t data[])
+{
+    for (unsigned int i = 0; i < BLOCK_SIZE / sizeof(uint32_t); ++i)
+    {
+        data[(i * 2) + 0] = (address[i] >> 0) & 0xFF;
+        data[(i * 2) + 1] = (address[i] >> 8) & 0xFF;
+    }
+}
+
+/** Fills in the RAM index from the slots of the active sector.
+ */
+void EEPROMEmulation::rebuild_index()
+{
+    memset(index_, 0, index_group_count() * sizeof(index_[0]));
+    for (unsigned block_index = slot_first();
+         block_index < rawBlockCount_ - availableSlots_;
+         ++block_index)
+    {
+        update_index(*block(activeSector_, block_index) >> 16, block_index);
+    }
+}
@@ -99,6 +99,12 @@ extern const char __eeprom_end;
  *  be allocated in RAM that will be pre-filled with the entire eeprom
  *  data. Dramatically speeds up reads, because reads will not have to go
  *  through the log anymore.
+ *  @param RAM_INDEX_GROUP_SIZE: if nonzero (and SHADOW_IN_RAM is false), a
+ *  compact index is kept in RAM which stores for every group of this many
+ *  bytes of the address space which slot in the active sector holds the
+ *  latest write to that group. Reads then scan the log backwards starting
+ *  from that slot instead of scanning the entire sector. Costs 2 bytes of RAM
+ *  per group. Must be a multiple of BYTES_PER_BLOCK.
  *  @param file_size: The total number of bytes held by the emulated eeprom
  *  file. Reads from address 0 .. file_size - 1 will be valid. Must be smaller
  *  than half of one sector, but should be realistically about 35% of the
@@ -140,6 +146,7 @@ protected:
      */
     ~EEPROMEmulation()
     {
+        delete[] index_;
     }
 
     /** Mount the EEPROM file.  Should be called during construction of the
@@ -199,6 +206,11 @@ private:
      */
     static const bool SHADOW_IN_RAM;
 
+    /** Number of bytes of the EEPROM address space that share one entry in
+     * the RAM index of the latest slots. 0 disables the index.
+     */
+    static const unsigned RAM_INDEX_GROUP_SIZE;
+
 protected:
     /** magic marker for an intact block */
     static const uint32_t MAGIC_INTACT;
@@ -240,6 +252,36 @@ private:
      */
     bool read_fblock(unsigned int index, uint8_t data[]);
 
+    /** Decodes the data payload of a slot.
+     * @param address pointer to the slot in flash
+     * @param data location to place the data, array size must be @ref
+     *           BYTES_PER_BLOCK large
+     */
+    void decode_slot(const uint32_t *address, uint8_t data[]);
+
+    /** Fills in the RAM index from the slots of the active sector. */
+    void rebuild_index();
+
+    /** Records in the RAM index that the given slot of the active sector
+     * holds the latest data of a block.
+     * @param index block within EEPROM address space
+     * @param slot raw block index within the active sector
+     */
+    void update_index(unsigned index, unsigned slot)
+    {
+        if (index_ && index < index_group_count() * indexGroupBlocks_)
+        {
+            index_[index / indexGroupBlocks_] = slot;
+        }
+    }
+
+    /** @return the number of entries in the RAM index. */
+    unsigned index_group_count()
+    {
+        unsigned fblocks = (file_size() + BYTES_PER_BLOCK - 1) / BYTES_PER_BLOCK;
+        return (fblocks + indexGroupBlocks_ - 1) / indexGroupBlocks_;
+    }
+
     /** Get the next active sector pointer.
      * @return sector index for the next sector to use.
      */
@@ -327,6 +369,14 @@ protected:
     /** pointer to RAM for shadowing EEPROM. */
     uint8_t *shadow_{nullptr};
 
+    /** For each address group, the raw block index of the latest slot in the
+     * active sector holding data of that group, or 0 if there is no such
+     * slot. nullptr if the index is not in use. */
+    uint16_t *index_{nullptr};
+
+    /** How many blocks of the address space make up one group of index_. */
+    unsigned indexGroupBlocks_{1};
+
 
     /** Default constructor.
      */
@@ -33,6 +33,7 @@
  */
 
 #include "openlcb/AliasAllocator.hxx"
+#include "openlcb/AliasSnapshot.hxx"
 #include "nmranet_config.h"
 #include "openlcb/CanDefs.hxx"
 
@@ -168,6 +169,36 @@ NodeAlias AliasAllocator::get_allocated_alias(
     {
         found = (found_id == CanDefs::get_reserved_alias_node_id(found_alias));
     }
+    if (found && snapshot_)
+    {
+        NodeAlias a = snapshot_->lookup(destination_id);
+        if (a &&
+            if_can()->local_aliases()->lookup(a) ==
+                CanDefs::get_reserved_alias_node_id(a))
+        {
+            // This node's alias from before the restart is reserved.
+            found_alias = a;
+        }
+        else
+        {
+            // Prefers an alias that no other node from the snapshot is going
+            // to ask for.
+            NodeID next_id = found_id;
+            NodeAlias next_alias = found_alias;
+            while (snapshot_->has_alias(next_alias) &&
+                if_can()->local_aliases()->next_entry(
+                    next_id, &next_id, &next_alias) &&
+                CanDefs::is_reserved_alias_node_id(next_id))
+            {
+                if (!snapshot_->has_alias(next_alias))
+                {
+                    found_alias = next_alias;
+                    break;
+                }
+            }
+        }
+        snapshot_->set(destination_id, found_alias);
+    }
     if (found)
     {
         if_can()->local_aliases()->add(destination_id, found_alias);
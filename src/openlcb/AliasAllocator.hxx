@@ -42,6 +42,8 @@
 namespace openlcb
 {
 
+class AliasSnapshot;
+
 /** Counts the number of aliases that were given up because a conflict has
  * arisen during the allocation. */
 extern size_t g_alias_test_conflicts;
@@ -158,6 +160,23 @@ public:
      * @param alias a reserved node alias. */
     void add_allocated_alias(NodeAlias alias);
 
+    /** Sets the persistent record of alias assignments. When a node's alias
+     * from the snapshot is in the reserved aliases list,
+     * get_allocated_alias() will hand out that alias to the node. Every new
+     * assignment gets recorded in the snapshot.
+     * @param snapshot the snapshot to use, or nullptr to disable. Ownership
+     * is not transferred. */
+    void set_alias_snapshot(AliasSnapshot *snapshot)
+    {
+        snapshot_ = snapshot;
+    }
+
+    /** @return the persistent record of alias assignments, or nullptr. */
+    AliasSnapshot *alias_snapshot()
+    {
+        return snapshot_;
+    }
+
 #ifdef GTEST
     /** If there is a pending alias allocation waiting for the timer to expire,
      * finishes it immediately. Needed in test destructors. */
@@ -218,6 +237,9 @@ private:
     /// 48-bit nodeID that we will use for alias reservations.
     NodeID if_id_;
 
+    /// Persistent record of alias assignments, or nullptr.
+    AliasSnapshot *snapshot_ {nullptr};
+
     /** Physical interface for sending packets and assigning handlers to
      * received packets. */
     IfCan *if_can()
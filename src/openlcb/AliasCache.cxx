@@ -63,6 +63,10 @@ static NodeAlias resolve_notresponding(NodeAlias stored)
 #if defined(TEST_CONSISTENCY)
 extern volatile int consistency_result;
 volatile int consistency_result = 0;
+/// Tests (e.g. benchmarks) can set this to false to skip the consistency
+/// check after each change. Also used by HashAliasCache.
+extern bool alias_cache_check_consistency;
+bool alias_cache_check_consistency = true;
 
 int AliasCache::check_consistency()
 {
@@ -403,8 +407,11 @@ void AliasCache::add(NodeID id, NodeAlias alias)
     newest = n;
 
 #if defined(TEST_CONSISTENCY)
-    consistency_result = check_consistency();
-    HASSERT(0 == consistency_result);
+    if (alias_cache_check_consistency)
+    {
+        consistency_result = check_consistency();
+        HASSERT(0 == consistency_result);
+    }
 #endif
 }
 
@@ -449,8 +456,11 @@ void AliasCache::remove(NodeAlias alias)
     }
 
 #if defined(TEST_CONSISTENCY)
-    consistency_result = check_consistency();
-    HASSERT(0 == consistency_result);
+    if (alias_cache_check_consistency)
+    {
+        consistency_result = check_consistency();
+        HASSERT(0 == consistency_result);
+    }
 #endif
 }
 
@@ -602,8 +612,11 @@ void AliasCache::touch(Metadata* metadata)
         newest.idx_ = metadata - pool;
     }
 #if defined(TEST_CONSISTENCY)
-    consistency_result = check_consistency();
-    HASSERT(0 == consistency_result);
+    if (alias_cache_check_consistency)
+    {
+        consistency_result = check_consistency();
+        HASSERT(0 == consistency_result);
+    }
 #endif
 }
 
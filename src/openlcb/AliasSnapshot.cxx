@@ -0,0 +1,200 @@
+/** \copyright
+ * Copyright (c) 2026 Balazs Racz
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  - Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  - Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file AliasSnapshot.cxx
+ *
+ * Persistent record of which alias the local virtual nodes were using, to
+ * re-claim the same aliases after a restart.
+ *
+ * @author Balazs Racz
+ * @date 17 Oct 2026
+ */
+
+#include "openlcb/AliasSnapshot.hxx"
+
+#include <string.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "utils/logging.h"
+
+namespace openlcb
+{
+
+/// Reads a given number of bytes from an fd.
+/// @param fd file descriptor
+/// @param buf where to put the data
+/// @param size how many bytes to read
+/// @return true if all bytes were read.
+static bool read_all(int fd, void *buf, size_t size)
+{
+    uint8_t *p = static_cast<uint8_t *>(buf);
+    while (size)
+    {
+        ssize_t ret = ::read(fd, p, size);
+        if (ret <= 0)
+        {
+            return false;
+        }
+        p += ret;
+        size -= ret;
+    }
+    return true;
+}
+
+/// Writes a given number of bytes to an fd.
+/// @param fd file descriptor
+/// @param buf data to write
+/// @param size how many bytes to write
+/// @return true if all bytes were written.
+static bool write_all(int fd, const void *buf, size_t size)
+{
+    const uint8_t *p = static_cast<const uint8_t *>(buf);
+    while (size)
+    {
+        ssize_t ret = ::write(fd, p, size);
+        if (ret <= 0)
+        {
+            return false;
+        }
+        p += ret;
+        size -= ret;
+    }
+    return true;
+}
+
+void AliasSnapshot::clear()
+{
+    AtomicHolder h(this);
+    entries_.clear();
+    memset(aliasBits_, 0, sizeof(aliasBits_));
+    dirty_ = false;
+}
+
+bool AliasSnapshot::load(int fd)
+{
+    clear();
+    uint32_t hdr[2];
+    if (lseek(fd, 0, SEEK_SET) != 0 || !read_all(fd, hdr, sizeof(hdr)) ||
+        hdr[0] != MAGIC || hdr[1] > 4096)
+    {
+        return false;
+    }
+    std::vector<uint64_t> raw(hdr[1]);
+    if (!read_all(fd, raw.data(), raw.size() * sizeof(uint64_t)))
+    {
+        return false;
+    }
+    AtomicHolder h(this);
+    entries_.reserve(raw.size());
+    for (uint64_t r : raw)
+    {
+        NodeAlias alias = r & 0xfff;
+        if (!alias || has_alias(alias))
+        {
+            // Corrupted file.
+            clear();
+            return false;
+        }
+        set_alias_bit(alias, true);
+        entries_.insert(Entry {r >> 16, alias});
+    }
+    LOG(VERBOSE, "Loaded alias snapshot with %u entries.",
+        (unsigned)entries_.size());
+    return true;
+}
+
+bool AliasSnapshot::save(int fd)
+{
+    std::vector<uint64_t> raw;
+    {
+        AtomicHolder h(this);
+        raw.reserve(entries_.size());
+        for (auto it = entries_.begin(); it != entries_.end(); ++it)
+        {
+            raw.push_back((uint64_t(it->id_) << 16) | it->alias_);
+        }
+        // A set() during the write below will make this dirty again.
+        dirty_ = false;
+    }
+    uint32_t hdr[2] = {MAGIC, (uint32_t)raw.size()};
+    if (lseek(fd, 0, SEEK_SET) != 0 || !write_all(fd, hdr, sizeof(hdr)) ||
+        !write_all(fd, raw.data(), raw.size() * sizeof(uint64_t)))
+    {
+        AtomicHolder h(this);
+        dirty_ = true;
+        return false;
+    }
+    return true;
+}
+
+NodeAlias AliasSnapshot::lookup(NodeID id)
+{
+    AtomicHolder h(this);
+    auto it = entries_.find(id);
+    if (it == entries_.end())
+    {
+        return 0;
+    }
+    return it->alias_;
+}
+
+void AliasSnapshot::set(NodeID id, NodeAlias alias)
+{
+    AtomicHolder h(this);
+    auto it = entries_.find(id);
+    if (it != entries_.end() && it->alias_ == alias)
+    {
+        return;
+    }
+    dirty_ = true;
+    if (has_alias(alias))
+    {
+        // Some other node had this alias before.
+        for (auto jt = entries_.begin(); jt != entries_.end(); ++jt)
+        {
+            if (jt->alias_ == alias)
+            {
+                entries_.erase(jt);
+                break;
+            }
+        }
+        it = entries_.find(id);
+    }
+    if (it != entries_.end())
+    {
+        set_alias_bit(it->alias_, false);
+        it->alias_ = alias;
+    }
+    else
+    {
+        entries_.insert(Entry {id, alias});
+    }
+    set_alias_bit(alias, true);
+}
+
+} // namespace openlcb
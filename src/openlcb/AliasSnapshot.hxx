@@ -0,0 +1,184 @@
+/** \copyright
+ * Copyright (c) 2026 Balazs Racz
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  - Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  - Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file AliasSnapshot.hxx
+ *
+ * Persistent record of which alias the local virtual nodes were using, to
+ * re-claim the same aliases after a restart.
+ *
+ * @author Balazs Racz
+ * @date 17 Oct 2026
+ */
+
+#ifndef _OPENLCB_ALIASSNAPSHOT_HXX_
+#define _OPENLCB_ALIASSNAPSHOT_HXX_
+
+#include <stdint.h>
+
+#include "openlcb/Defs.hxx"
+#include "utils/Atomic.hxx"
+#include "utils/SortedListMap.hxx"
+
+namespace openlcb
+{
+
+/// Stores the last known NodeID -> alias assignments of the local virtual
+/// nodes, and saves/loads them to a file (or any file descriptor, such as an
+/// EEPROM emulation backed virtual file).
+///
+/// Usage: load the snapshot at startup, then hand it to the AliasAllocator
+/// with set_alias_snapshot() and to the bulk alias allocator in the
+/// BulkAliasRequest. The bulk allocator will try to reserve the aliases from
+/// the snapshot first; each virtual node that starts up will then get back
+/// its previous alias if that was reserved successfully. The AliasAllocator
+/// records every new assignment in the snapshot. The application is
+/// responsible for calling save() when is_dirty() is true, at an appropriate
+/// time (e.g. a few seconds after the startup completed).
+///
+/// All methods are thread-safe: the allocator updates the snapshot on its
+/// executor while the application may call save() from another thread. The
+/// file I/O in load() and save() happens without holding the lock.
+class AliasSnapshot : private Atomic
+{
+public:
+    AliasSnapshot()
+    {
+        clear();
+    }
+
+    /// Removes all entries.
+    void clear();
+
+    /// Loads the snapshot from a file. Previous entries are removed. The file
+    /// is read from offset 0.
+    /// @param fd file descriptor to read from.
+    /// @return true if the snapshot was loaded; false if the file was empty
+    /// or invalid, in which case the snapshot is left empty.
+    bool load(int fd);
+
+    /// Writes the snapshot to a file, from offset 0. Clears the dirty bit.
+    /// @param fd file descriptor to write to.
+    /// @return true on success.
+    bool save(int fd);
+
+    /// @param id a local virtual node's ID.
+    /// @return the alias this node was last using, or 0 if unknown.
+    NodeAlias lookup(NodeID id);
+
+    /// @param alias an alias.
+    /// @return true if some node in the snapshot was using this alias.
+    bool has_alias(NodeAlias alias)
+    {
+        AtomicHolder h(this);
+        return aliasBits_[alias >> 5] & (1u << (alias & 31));
+    }
+
+    /// Records that a node is using a given alias. Any other node that had the
+    /// same alias in the snapshot is removed.
+    /// @param id the node ID
+    /// @param alias the alias the node is using now.
+    void set(NodeID id, NodeAlias alias);
+
+    /// @return the number of nodes in the snapshot.
+    size_t size()
+    {
+        AtomicHolder h(this);
+        return entries_.size();
+    }
+
+    /// @param i index, 0 <= i < size().
+    /// @return the alias of the i-th entry (in the order of node IDs).
+    NodeAlias alias_at(unsigned i)
+    {
+        AtomicHolder h(this);
+        return (entries_.begin() + i)->alias_;
+    }
+
+    /// @return true if there were changes since the last save() or load().
+    bool is_dirty()
+    {
+        AtomicHolder h(this);
+        return dirty_;
+    }
+
+private:
+    /// Magic number at the beginning of the file.
+    static constexpr uint32_t MAGIC = 0x414c5331; // "ALS1"
+
+    /// One assignment in the snapshot.
+    struct Entry
+    {
+        /// Node ID of the virtual node.
+        NodeID id_ : 48;
+        /// The alias the node was using.
+        NodeID alias_ : 12;
+    };
+    static_assert(sizeof(Entry) == 8, "memory bloat");
+
+    /// Comparator for sorting entries by node ID.
+    struct EntryCmp
+    {
+        bool operator()(const Entry &a, const Entry &b) const
+        {
+            return a.id_ < b.id_;
+        }
+        bool operator()(const Entry &a, NodeID b) const
+        {
+            return a.id_ < b;
+        }
+        bool operator()(NodeID a, const Entry &b) const
+        {
+            return a < b.id_;
+        }
+    };
+
+    /// Sets or clears an alias in the aliasBits_.
+    /// @param alias which alias
+    /// @param value true to set, false to clear.
+    void set_alias_bit(NodeAlias alias, bool value)
+    {
+        if (value)
+        {
+            aliasBits_[alias >> 5] |= (1u << (alias & 31));
+        }
+        else
+        {
+            aliasBits_[alias >> 5] &= ~(1u << (alias & 31));
+        }
+    }
+
+    /// Assignments sorted by node ID. The members below are protected by the
+    /// Atomic lock.
+    SortedListSet<Entry, EntryCmp> entries_;
+    /// One bit for every possible alias, 1 if it is in entries_.
+    uint32_t aliasBits_[4096 / 32];
+    /// True if entries_ was modified since the last load or save.
+    bool dirty_;
+};
+
+} // namespace openlcb
+
+#endif // _OPENLCB_ALIASSNAPSHOT_HXX_
@@ -60,6 +60,7 @@ public:
         pendingAliasesByKey_.clear();
         nextToStampTime_ = 0;
         nextToClaim_ = 0;
+        nextPreferred_ = 0;
         if_can()->frame_dispatcher()->register_handler(&conflictHandler_, 0, 0);
         return call_immediately(STATE(send_cid_frames));
     }
@@ -76,7 +77,7 @@ public:
         bn_.reset(this);
         for (unsigned i = 0; i < needed; ++i)
         {
-            NodeAlias next_alias = if_can()->alias_allocator()->get_new_seed();
+            NodeAlias next_alias = next_alias_to_try();
             auto if_id = if_can()->alias_allocator()->if_node_id();
             send_can_frame(next_alias, (if_id >> 36) & 0xfff, 7);
             send_can_frame(next_alias, (if_id >> 24) & 0xfff, 6);
@@ -178,6 +179,41 @@ private:
         }
     }
 
+    /// Picks the next alias to send CID frames for. These come from the
+    /// preferred aliases first, then from the random sequence.
+    /// @return an alias that is not in use and not pending.
+    NodeAlias next_alias_to_try()
+    {
+        AliasSnapshot *pref = request()->preferred_;
+        while (pref && nextPreferred_ < pref->size())
+        {
+            NodeAlias a = pref->alias_at(nextPreferred_++);
+            if (if_can()->local_aliases()->lookup(a) ||
+                if_can()->remote_aliases()->lookup(a) || is_pending(a))
+            {
+                continue;
+            }
+            return a;
+        }
+        while (true)
+        {
+            NodeAlias a = if_can()->alias_allocator()->get_new_seed();
+            if (!is_pending(a))
+            {
+                return a;
+            }
+        }
+    }
+
+    /// @param alias an alias
+    /// @return true if we have already sent CID frames for this alias.
+    bool is_pending(NodeAlias alias)
+    {
+        // find() has to run before end(), because it sorts the set.
+        auto it = pendingAliasesByKey_.find(alias);
+        return it != pendingAliasesByKey_.end();
+    }
+
     /// Listens to incoming CAN frames and handles alias conflicts.
     IncomingFrameHandler::GenericHandler conflictHandler_ {
         this, &BulkAliasAllocator::handle_conflict};
@@ -275,6 +311,9 @@ private:
     /// Index into the pendingAliasesByTime_ vector where we need to send out
     /// the reserve frame.
     uint16_t nextToClaim_;
+    /// Index into the preferred aliases of the request that we need to try
+    /// next.
+    uint16_t nextPreferred_;
 };
 
 std::unique_ptr<BulkAliasAllocatorInterface> create_bulk_alias_allocator(
@@ -35,6 +35,7 @@
 #include "executor/CallableFlow.hxx"
 #include "openlcb/AliasAllocator.hxx"
 #include "openlcb/AliasCache.hxx"
+#include "openlcb/AliasSnapshot.hxx"
 #include "openlcb/CanDefs.hxx"
 
 namespace openlcb
@@ -44,14 +45,20 @@ namespace openlcb
 struct BulkAliasRequest : CallableFlowRequestBase
 {
     /// @param count how many aliases to allocate.
-    void reset(unsigned count)
+    /// @param preferred if not null, the aliases from this snapshot will be
+    /// tried first, before generating new ones. The aliases with a conflict
+    /// are replaced by new ones.
+    void reset(unsigned count, AliasSnapshot *preferred = nullptr)
     {
         reset_base();
         numAliases_ = count;
+        preferred_ = preferred;
     }
 
     /// How many aliases to allocate.
     unsigned numAliases_;
+    /// Aliases to try first. May be nullptr.
+    AliasSnapshot *preferred_;
 };
 
 using BulkAliasAllocatorInterface = FlowInterface<Buffer<BulkAliasRequest>>;
@@ -33,6 +33,7 @@
  */
 
 #include "openlcb/ConfigEntry.hxx"
+#include "openlcb/ConfigFileSnapshot.hxx"
 
 #include <sys/types.h>
 #include <unistd.h>
@@ -44,6 +45,10 @@ namespace openlcb
 
 void ConfigEntryBase::repeated_read(int fd, void *buf, size_t size) const
 {
+    if (ConfigFileSnapshot::read(fd, offset_, buf, size))
+    {
+        return;
+    }
     int ret = lseek(fd, offset_, SEEK_SET);
     ERRNOCHECK("seek_config", ret);
     FdUtils::repeated_read(fd, buf, size);
@@ -54,6 +59,7 @@ void ConfigEntryBase::repeated_write(int fd, const void *buf, size_t size) const
     int ret = lseek(fd, offset_, SEEK_SET);
     ERRNOCHECK("seek_config", ret);
     FdUtils::repeated_write(fd, buf, size);
+    ConfigFileSnapshot::write_through(fd, offset_, buf, size);
 }
 
 } // namespace openlcb
@@ -0,0 +1,203 @@
+/** \copyright
+ * Copyright (c) 2026, Balazs Racz
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are  permitted provided that the following conditions are met:
+ *
+ *  - Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  - Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file ConfigFileSnapshot.cxx
+ *
+ * In-memory image of the configuration file, used to serve ConfigEntry reads
+ * without a syscall per entry.
+ *
+ * @author Balazs Racz
+ * @date 17 Oct 2026
+ */
+
+#include "openlcb/ConfigFileSnapshot.hxx"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "nmranet_config.h"
+#include "openmrn_features.h"
+#include "utils/Atomic.hxx"
+#include "utils/logging.h"
+
+#if OPENMRN_HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
+namespace openlcb
+{
+
+/// Protects the list of registered snapshots and their contents.
+static Atomic snapshotLock;
+
+ConfigFileSnapshot *ConfigFileSnapshot::head_ = nullptr;
+
+ConfigFileSnapshot::ConfigFileSnapshot(int fd)
+    : next_(nullptr)
+    , data_(nullptr)
+    , size_(0)
+    , fd_(fd)
+    , isMapped_(false)
+{
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0 || st.st_size <= 0)
+    {
+        return;
+    }
+    size_t size = st.st_size;
+    uint8_t *data = nullptr;
+#if OPENMRN_HAVE_MMAP
+    void *m = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (m != MAP_FAILED)
+    {
+        data = static_cast<uint8_t *>(m);
+        isMapped_ = true;
+    }
+#endif
+    if (!data && size <= (size_t)config_snapshot_max_heap_size())
+    {
+        data = static_cast<uint8_t *>(malloc(size));
+        size_t have = 0;
+        if (data && lseek(fd, 0, SEEK_SET) == 0)
+        {
+            while (have < size)
+            {
+                ssize_t ret = ::read(fd, data + have, size - have);
+                if (ret <= 0)
+                {
+                    break;
+                }
+                have += ret;
+            }
+        }
+        if (have < size)
+        {
+            free(data);
+            data = nullptr;
+        }
+    }
+    if (!data)
+    {
+        LOG(VERBOSE, "Config snapshot of fd %d not available.", fd);
+        return;
+    }
+    AtomicHolder h(&snapshotLock);
+    data_ = data;
+    size_ = size;
+    next_ = head_;
+    head_ = this;
+}
+
+ConfigFileSnapshot::~ConfigFileSnapshot()
+{
+    AtomicHolder h(&snapshotLock);
+    for (ConfigFileSnapshot **p = &head_; *p; p = &(*p)->next_)
+    {
+        if (*p == this)
+        {
+            *p = next_;
+            break;
+        }
+    }
+    release();
+}
+
+void ConfigFileSnapshot::release()
+{
+    if (!data_)
+    {
+        return;
+    }
+#if OPENMRN_HAVE_MMAP
+    if (isMapped_)
+    {
+        munmap(data_, size_);
+    }
+    else
+#endif
+    {
+        free(data_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+}
+
+bool ConfigFileSnapshot::read(int fd, size_t offset, void *buf, size_t size)
+{
+    AtomicHolder h(&snapshotLock);
+    for (ConfigFileSnapshot *s = head_; s; s = s->next_)
+    {
+        if (s->fd_ != fd || !s->data_)
+        {
+            continue;
+        }
+        if (offset > s->size_ || size > s->size_ - offset)
+        {
+            return false;
+        }
+        memcpy(buf, s->data_ + offset, size);
+        return true;
+    }
+    return false;
+}
+
+void ConfigFileSnapshot::write_through(
+    int fd, size_t offset, const void *buf, size_t size)
+{
+    AtomicHolder h(&snapshotLock);
+    for (ConfigFileSnapshot *s = head_; s; s = s->next_)
+    {
+        if (s->fd_ != fd || !s->data_ || s->isMapped_)
+        {
+            // A shared mapping already sees the data written to the file.
+            continue;
+        }
+        if (offset > s->size_ || size > s->size_ - offset)
+        {
+            // The file grew past the image.
+            s->release();
+            continue;
+        }
+        memcpy(s->data_ + offset, buf, size);
+    }
+}
+
+void ConfigFileSnapshot::invalidate(int fd)
+{
+    AtomicHolder h(&snapshotLock);
+    for (ConfigFileSnapshot *s = head_; s; s = s->next_)
+    {
+        if (s->fd_ == fd)
+        {
+            s->release();
+        }
+    }
+}
+
+} // namespace openlcb
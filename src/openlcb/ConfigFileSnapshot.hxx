@@ -0,0 +1,129 @@
+/** \copyright
+ * Copyright (c) 2026, Balazs Racz
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are  permitted provided that the following conditions are met:
+ *
+ *  - Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  - Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file ConfigFileSnapshot.hxx
+ *
+ * In-memory image of the configuration file, used to serve ConfigEntry reads
+ * without a syscall per entry.
+ *
+ * @author Balazs Racz
+ * @date 17 Oct 2026
+ */
+
+#ifndef _OPENLCB_CONFIGFILESNAPSHOT_HXX_
+#define _OPENLCB_CONFIGFILESNAPSHOT_HXX_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "utils/macros.h"
+
+namespace openlcb
+{
+
+/// Read-through image of a configuration file. While an instance is alive,
+/// ConfigEntryBase reads from the given fd are served from memory instead of
+/// an lseek and a read each. On Linux and Mac the file is mapped with mmap;
+/// on other platforms it is copied to the heap if it is not larger than
+/// config_snapshot_max_heap_size.
+///
+/// Writes done via ConfigEntryBase are written through to the image. Any
+/// other writer to the same file (such as FileMemorySpace) must call
+/// invalidate(); from then on reads fall back to the file system until the
+/// snapshot is destroyed.
+///
+/// The ConfigUpdateFlow keeps a snapshot alive while it is calling the update
+/// listeners, which is where the bulk of the config reads happen.
+class ConfigFileSnapshot
+{
+public:
+    /// Loads the contents of a file into memory and registers the image for
+    /// the given fd. If the file cannot be loaded, the object is still valid,
+    /// but does not serve any reads.
+    ///
+    /// @param fd file descriptor of the config file.
+    ConfigFileSnapshot(int fd);
+
+    /// Unregisters and releases the image.
+    ~ConfigFileSnapshot();
+
+    /// @return true if this object is serving reads from memory.
+    bool is_loaded()
+    {
+        return data_ != nullptr;
+    }
+
+    /// Tries to serve a read from a registered snapshot.
+    ///
+    /// @param fd file descriptor to read from
+    /// @param offset offset in the file
+    /// @param buf where to put the data
+    /// @param size how many bytes to read
+    ///
+    /// @return true if the data was copied to buf; false if the caller has
+    /// to read the file itself.
+    static bool read(int fd, size_t offset, void *buf, size_t size);
+
+    /// Updates the snapshot of a file after the data was written to the
+    /// file. A no-op if there is no snapshot for this fd.
+    ///
+    /// @param fd file descriptor that was written to
+    /// @param offset offset in the file
+    /// @param buf the data that was written
+    /// @param size how many bytes were written
+    static void write_through(
+        int fd, size_t offset, const void *buf, size_t size);
+
+    /// Drops the image of the given fd. Must be called when the file was
+    /// written by some means other than ConfigEntryBase.
+    ///
+    /// @param fd file descriptor that was written to
+    static void invalidate(int fd);
+
+private:
+    /// Releases the memory of the image. Must be called with the lock held.
+    void release();
+
+    /// Next registered snapshot.
+    ConfigFileSnapshot *next_;
+    /// Contents of the file, or nullptr if not loaded or invalidated.
+    uint8_t *data_;
+    /// Number of bytes in data_.
+    size_t size_;
+    /// File descriptor this snapshot belongs to.
+    int fd_;
+    /// True if data_ is an mmap-ed region, false if it is a heap copy.
+    bool isMapped_;
+
+    /// Head of the linked list of registered snapshots.
+    static ConfigFileSnapshot *head_;
+
+    DISALLOW_COPY_AND_ASSIGN(ConfigFileSnapshot);
+};
+
+} // namespace openlcb
+
+#endif // _OPENLCB_CONFIGFILESNAPSHOT_HXX_
@@ -37,7 +37,10 @@
 #ifndef _OPENLCB_CONFIGUPDATEFLOW_HXX_
 #define _OPENLCB_CONFIGUPDATEFLOW_HXX_
 
+#include <memory>
+
 #include "openmrn_features.h"
+#include "openlcb/ConfigFileSnapshot.hxx"
 #include "utils/ConfigUpdateListener.hxx"
 #include "utils/ConfigUpdateService.hxx"
 #include "openlcb/NodeInitializeFlow.hxx"
@@ -56,7 +59,9 @@ namespace openlcb
 /// Implementation of the ConfigUpdateService: state flow issuing all the calls
 /// to the registered ConfigUpdateListener descendants. This flow also handles
 /// any necessary action such as reboot or factory reset. This flow keeps the
-/// file descriptor for the config file that's currently open.
+/// file descriptor for the config file that's currently open. While the
+/// listeners are being called, a ConfigFileSnapshot of the file is held, so
+/// that their config reads do not each turn into a syscall.
 class ConfigUpdateFlow : public StateFlowBase,
                          public ConfigUpdateService,
                          private Atomic
@@ -67,6 +72,7 @@ public:
         , nextRefresh_(listeners_.begin())
         , needsReboot_(0)
         , needsReInit_(0)
+        , useSnapshot_(1)
         , fd_(-1)
     {
     }
@@ -103,6 +109,10 @@ public:
     {
         return needsReInit_;
     }
+    void TEST_set_use_snapshot(bool use)
+    {
+        useSnapshot_ = use ? 1 : 0;
+    }
 #endif // GTEST
 
     void trigger_update() override
@@ -142,6 +152,10 @@ private:
             DIE("CONFIG_FILENAME not specified, or init() was not called, but "
                 "there are configuration listeners.");
         }
+        if (useSnapshot_ && !snapshot_)
+        {
+            snapshot_.reset(new ConfigFileSnapshot(fd_));
+        }
         ConfigUpdateListener::UpdateAction action =
             l->apply_configuration(fd_, is_initial, n_.reset(this));
         switch (action)
@@ -185,6 +199,7 @@ private:
     Action apply_action()
     {
         /// TODO(balazs.racz) apply the changes reported.
+        snapshot_.reset();
         if (needsReboot_)
         {
 #if OPENMRN_FEATURE_REBOOT
@@ -211,7 +226,12 @@ private:
     unsigned needsReboot_ : 1;
     /// did anybody request a node reinit to happen?
     unsigned needsReInit_ : 1;
+    /// Should we hold a snapshot of the config file while calling the
+    /// listeners.
+    unsigned useSnapshot_ : 1;
     int fd_;
+    /// In-memory image of the config file during an update pass.
+    std::unique_ptr<ConfigFileSnapshot> snapshot_;
     BarrierNotifiable n_;
 };
 
@@ -34,6 +34,7 @@
 
 #include "openlcb/DatagramCan.hxx"
 
+#include "openlcb/DatagramClientPool.hxx"
 #include "openlcb/DatagramDefs.hxx"
 #include "openlcb/DatagramImpl.hxx"
 #include "openlcb/IfCanImpl.hxx"
@@ -343,12 +344,23 @@ private:
 };
 CanDatagramService::CanDatagramService(IfCan *iface,
                                        int num_registry_entries,
-                                       int num_clients)
+                                       int num_clients,
+                                       bool use_pool)
     : DatagramService(iface, num_registry_entries)
 {
     if_can()->add_owned_flow(new CanDatagramParser(if_can()));
     auto* dg_send = new CanDatagramWriteFlow(if_can());
     if_can()->add_owned_flow(dg_send);
+    if (use_pool)
+    {
+        pool_ = new DatagramClientPool(if_can(), dg_send);
+        if_can()->add_owned_flow(pool_);
+        for (int i = 0; i < num_clients; ++i)
+        {
+            client_allocator()->insert(pool_->create_client());
+        }
+        return;
+    }
     for (int i = 0; i < num_clients; ++i)
     {
         auto *client_flow = new DatagramClientImpl(if_can(), dg_send);
@@ -41,6 +41,8 @@
 namespace openlcb
 {
 
+class DatagramClientPool;
+
 /// Implementation of the DatagramService with the CANbus-specific OpenLCB
 /// datagram protocol. This service is responsible for fragmenting outgoing
 /// datagram messages to the CANbus, assembling incoming datagram frames into
@@ -51,9 +53,13 @@ class CanDatagramService : public DatagramService
 public:
     /*
      * @param num_registry_entries is the size of the registry map (how
-     * many datagram handlers can be registered)*/
+     * many datagram handlers can be registered)
+     * @param num_clients is how many datagram clients to create.
+     * @param use_pool if true, the clients are lightweight proxies of a
+     * DatagramClientPool, which sends datagrams to different destinations in
+     * parallel. If false, every client is a separate state flow. */
     CanDatagramService(IfCan *iface, int num_registry_entries,
-                       int num_clients);
+                       int num_clients, bool use_pool = false);
 
     ~CanDatagramService();
 
@@ -61,6 +67,17 @@ public:
     {
         return static_cast<IfCan *>(iface());
     }
+
+    /// @return the pool that the clients belong to, or nullptr if the
+    /// service was created without a pool.
+    DatagramClientPool *client_pool()
+    {
+        return pool_;
+    }
+
+private:
+    /// Pool for the clients, or nullptr. Owned by the interface.
+    DatagramClientPool *pool_ {nullptr};
 };
 
 /// Creates a CAN datagram parser flow. Exposed for testing only.
@@ -0,0 +1,312 @@
+/** \copyright
+ * Copyright (c) 2026, Balazs Racz
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  - Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  - Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file DatagramClientPool.cxx
+ *
+ * Datagram client implementation that shares one response listener and one
+ * timer between many lightweight clients, and pipelines datagrams to
+ * different destinations.
+ *
+ * @author Balazs Racz
+ * @date 17 Oct 2026
+ */
+
+#include "openlcb/DatagramClientPool.hxx"
+
+#include "openlcb/DatagramImpl.hxx"
+
+namespace openlcb
+{
+
+/// DatagramClient handed out by the pool. Holds the state of one datagram
+/// transmission; the protocol is run by the pool.
+class DatagramClientPool::PoolClient : public DatagramClient, public Executable
+{
+public:
+    /// Constructor. @param parent the pool that owns this client.
+    PoolClient(DatagramClientPool *parent)
+        : parent_(parent)
+    {
+    }
+
+    void write_datagram(Buffer<GenMessage> *b, unsigned priority) override
+    {
+        if (!b->data()->mti)
+        {
+            b->data()->mti = Defs::MTI_DATAGRAM;
+        }
+        HASSERT(b->data()->mti == Defs::MTI_DATAGRAM);
+        result_ = OPERATION_PENDING;
+        message_ = b;
+        priority_ = std::min((unsigned)MAX_PRIORITY, priority);
+        // The pool's data structures are only touched on the executor.
+        parent_->service()->executor()->add(this, priority_);
+    }
+
+    void cancel() override
+    {
+        DIE("Canceling datagram send operation is not yet implemented.");
+    }
+
+    void run() override
+    {
+        parent_->start(this);
+    }
+
+private:
+    friend class DatagramClientPool;
+
+    /// Largest priority value that fits into priority_.
+    static constexpr unsigned MAX_PRIORITY = (1 << 24) - 1;
+
+    /// Pool that owns this client.
+    DatagramClientPool *parent_;
+    /// Datagram waiting to be sent. We own it.
+    Buffer<GenMessage> *message_ {nullptr};
+    /// Taken from the datagram buffer; notified when the transmission is
+    /// complete.
+    BarrierNotifiable *done_ {nullptr};
+    /// Source of the datagram we are sending.
+    NodeHandle src_;
+    /// Destination of the datagram we are sending.
+    NodeHandle dst_;
+    /// When to give up waiting for the response.
+    long long deadline_ {0};
+    /// Next client waiting to send to the same destination. The waiting
+    /// clients form a list that hangs off of the in-flight client.
+    PoolClient *nextWaiting_ {nullptr};
+    /// Valid for the in-flight client: last entry of the waiting list.
+    PoolClient *lastWaiting_ {nullptr};
+    /// Executor priority of the datagram.
+    unsigned priority_ : 24;
+};
+
+DatagramClientPool::DatagramClientPool(If *iface, MessageHandler *send_flow)
+    : StateFlowBase(iface)
+    , sendFlow_(send_flow)
+    , timerIdle_(1)
+    , isSleeping_(0)
+{
+    iface->dispatcher()->register_handler(&listener_,
+        Defs::MTI_TERMINATE_DUE_TO_ERROR,
+        ~(Defs::MTI_TERMINATE_DUE_TO_ERROR ^
+            Defs::MTI_OPTIONAL_INTERACTION_REJECTED));
+    iface->dispatcher()->register_handler(&listener_, Defs::MTI_DATAGRAM_OK,
+        ~(Defs::MTI_DATAGRAM_OK ^ Defs::MTI_DATAGRAM_REJECTED));
+    iface->dispatcher()->register_handler(
+        &listener_, Defs::MTI_INITIALIZATION_COMPLETE, Defs::MTI_EXACT);
+    reset_flow(STATE(check_timeouts));
+}
+
+DatagramClientPool::~DatagramClientPool()
+{
+    iface()->dispatcher()->unregister_handler_all(&listener_);
+}
+
+DatagramClient *DatagramClientPool::create_client()
+{
+    clients_.emplace_back(new PoolClient(this));
+    return clients_.back().get();
+}
+
+void DatagramClientPool::start(PoolClient *c)
+{
+    iface()->canonicalize_handle(&c->message_->data()->src);
+    iface()->canonicalize_handle(&c->message_->data()->dst);
+    c->src_ = c->message_->data()->src;
+    c->dst_ = c->message_->data()->dst;
+    for (PoolClient *p : inFlight_)
+    {
+        if (p->src_.id != c->src_.id ||
+            !iface()->matching_node(p->dst_, c->dst_))
+        {
+            continue;
+        }
+        // There is already a datagram in flight to this destination.
+        if (p->nextWaiting_)
+        {
+            p->lastWaiting_->nextWaiting_ = c;
+        }
+        else
+        {
+            p->nextWaiting_ = c;
+        }
+        p->lastWaiting_ = c;
+        ++numQueued_;
+        peakQueued_ = std::max(peakQueued_, numQueued_);
+        return;
+    }
+    send(c);
+}
+
+void DatagramClientPool::send(PoolClient *c)
+{
+    auto *b = c->message_;
+    c->message_ = nullptr;
+    // These two statements transfer the barrier's ownership from the
+    // BufferBase to the client.
+    c->done_ = b->new_child();
+    b->set_done(nullptr);
+    c->deadline_ = os_get_time_monotonic() + DATAGRAM_RESPONSE_TIMEOUT_NSEC;
+    inFlight_.push_back(c);
+    peakInFlight_ = std::max(peakInFlight_, (unsigned)inFlight_.size());
+    ++numSent_;
+    // Transfers ownership.
+    sendFlow_->send(b, c->priority_);
+
+    if (timerIdle_)
+    {
+        timerIdle_ = 0;
+        notify();
+    }
+    else if (isSleeping_ && c->deadline_ < wakeupTime_)
+    {
+        isSleeping_ = 0;
+        timer_.trigger();
+    }
+}
+
+void DatagramClientPool::finish(PoolClient *c)
+{
+    for (unsigned i = 0; i < inFlight_.size(); ++i)
+    {
+        if (inFlight_[i] == c)
+        {
+            inFlight_[i] = inFlight_.back();
+            inFlight_.pop_back();
+            break;
+        }
+    }
+    PoolClient *next = c->nextWaiting_;
+    if (next)
+    {
+        // Hands off the rest of the waiting list to the next client.
+        next->lastWaiting_ = c->lastWaiting_;
+        c->nextWaiting_ = nullptr;
+        --numQueued_;
+        send(next);
+    }
+    else if (inFlight_.empty() && isSleeping_)
+    {
+        // Nothing left to time out; lets the timer flow go idle.
+        isSleeping_ = 0;
+        timer_.trigger();
+    }
+    c->result_ &= ~DatagramClient::OPERATION_PENDING;
+    BarrierNotifiable *done = c->done_;
+    c->done_ = nullptr;
+    if (done)
+    {
+        done->notify();
+    }
+}
+
+void DatagramClientPool::handle_response(GenMessage *message)
+{
+    if (message->mti == Defs::MTI_INITIALIZATION_COMPLETE)
+    {
+        if (message->payload.size() != 6)
+        {
+            // Malformed message inbound.
+            return;
+        }
+        NodeHandle rebooted(message->src);
+        rebooted.id = buffer_to_node_id(message->payload);
+        // Destination node has rebooted. Kills the datagrams that were sent
+        // to it before the reboot. finish() sends the next queued datagram to
+        // the same destination, which has to wait for its own response, so
+        // the affected clients are collected first.
+        std::vector<PoolClient *> affected;
+        for (PoolClient *c : inFlight_)
+        {
+            if (iface()->matching_node(c->dst_, rebooted))
+            {
+                affected.push_back(c);
+            }
+        }
+        for (PoolClient *c : affected)
+        {
+            c->result_ |= DatagramClient::DST_REBOOT;
+            finish(c);
+        }
+        return;
+    }
+    for (PoolClient *c : inFlight_)
+    {
+        // The response has to come from our destination and be addressed to
+        // our source.
+        if (!iface()->matching_node(message->dst, c->src_) ||
+            !iface()->matching_node(message->src, c->dst_))
+        {
+            continue;
+        }
+        if (DatagramClientImpl::apply_response(message, &c->result_))
+        {
+            finish(c);
+        }
+        return;
+    }
+}
+
+StateFlowBase::Action DatagramClientPool::check_timeouts()
+{
+    isSleeping_ = 0;
+    long long now = os_get_time_monotonic();
+    long long next = 0;
+    bool have_next = false;
+    for (unsigned i = 0; i < inFlight_.size();)
+    {
+        PoolClient *c = inFlight_[i];
+        if (c->deadline_ <= now)
+        {
+            LOG(INFO,
+                "DatagramClientPool: No datagram response arrived from "
+                "destination %012" PRIx64 ".",
+                c->dst_.id);
+            c->result_ |= DatagramClient::PERMANENT_ERROR |
+                DatagramClient::TIMEOUT;
+            finish(c);
+            // finish() moved a different client to index i.
+            continue;
+        }
+        if (!have_next || c->deadline_ < next)
+        {
+            next = c->deadline_;
+            have_next = true;
+        }
+        ++i;
+    }
+    if (!have_next)
+    {
+        timerIdle_ = 1;
+        return wait_and_call(STATE(check_timeouts));
+    }
+    isSleeping_ = 1;
+    wakeupTime_ = next;
+    return sleep_and_call(&timer_, next - now, STATE(check_timeouts));
+}
+
+} // namespace openlcb
@@ -0,0 +1,192 @@
+/** \copyright
+ * Copyright (c) 2026, Balazs Racz
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  - Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  - Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file DatagramClientPool.hxx
+ *
+ * Datagram client implementation that shares one response listener and one
+ * timer between many lightweight clients, and pipelines datagrams to
+ * different destinations.
+ *
+ * @author Balazs Racz
+ * @date 17 Oct 2026
+ */
+
+#ifndef _OPENLCB_DATAGRAMCLIENTPOOL_HXX_
+#define _OPENLCB_DATAGRAMCLIENTPOOL_HXX_
+
+#include <memory>
+#include <vector>
+
+#include "executor/StateFlow.hxx"
+#include "openlcb/Datagram.hxx"
+
+namespace openlcb
+{
+
+/// Sends datagrams on behalf of many DatagramClient objects.
+///
+/// The clients created by this pool are small proxies; all the state of the
+/// transmission lives in the pool. Any number of datagrams to different
+/// destinations are in flight at the same time. Datagrams to a destination
+/// that already has a datagram in flight from the same source node are queued
+/// per destination, and sent in order when the previous one got its response,
+/// as required by the standard.
+///
+/// There is a single listener registered for the datagram response messages,
+/// and a single timer for the response timeouts, regardless of how many
+/// clients exist. This makes it affordable to have a client for every remote
+/// node that a configuration tool is talking to.
+class DatagramClientPool : public StateFlowBase
+{
+public:
+    /// Constructor.
+    /// @param iface is the service on which to run this flow
+    /// @param send_flow can receive an (addressed) Datagram message and send
+    /// it to the appropriate destination -- takes care of fragmenting etc.
+    DatagramClientPool(If *iface, MessageHandler *send_flow);
+
+    ~DatagramClientPool();
+
+    /// Creates a new datagram client. The client is owned by the pool.
+    /// @return the new client.
+    DatagramClient *create_client();
+
+    /// @return the number of datagrams that are sent and waiting for the
+    /// response.
+    unsigned num_in_flight()
+    {
+        return inFlight_.size();
+    }
+
+    /// @return the number of datagrams that are waiting for a previous
+    /// datagram to the same destination to complete.
+    unsigned num_queued()
+    {
+        return numQueued_;
+    }
+
+    /// @return the largest value num_in_flight() has ever reached.
+    unsigned peak_in_flight()
+    {
+        return peakInFlight_;
+    }
+
+    /// @return the largest value num_queued() has ever reached.
+    unsigned peak_queued()
+    {
+        return peakQueued_;
+    }
+
+    /// @return the total number of datagrams sent.
+    unsigned num_sent()
+    {
+        return numSent_;
+    }
+
+private:
+    class PoolClient;
+    friend class PoolClient;
+
+    /// Called on the executor when a client got a datagram to send. Sends the
+    /// datagram or queues it behind the one in flight to the same
+    /// destination.
+    /// @param c the client.
+    void start(PoolClient *c);
+
+    /// Hands off the datagram of a client to the send flow.
+    /// @param c the client.
+    void send(PoolClient *c);
+
+    /// Completes the transmission of a client, and sends the next datagram
+    /// queued for the same destination.
+    /// @param c an in-flight client.
+    void finish(PoolClient *c);
+
+    /// Callback when a datagram response message comes in.
+    /// @param message the incoming message.
+    void handle_response(GenMessage *message);
+
+    /// Timer flow: fails the datagrams that did not get a response in time,
+    /// then sleeps until the next deadline.
+    Action check_timeouts();
+
+    /// This object is registered to receive response messages at the interface
+    /// level. Then it forwards the call to the parent.
+    class ReplyListener : public MessageHandler
+    {
+    public:
+        /// Constructor. @param parent the pool that owns this listener.
+        ReplyListener(DatagramClientPool *parent)
+            : parent_(parent)
+        {
+        }
+
+        void send(message_type *buffer, unsigned priority = UINT_MAX) override
+        {
+            parent_->handle_response(buffer->data());
+            buffer->unref();
+        }
+
+    private:
+        /// Pool that owns this listener.
+        DatagramClientPool *parent_;
+    };
+
+    /// @return the interface service we are running on.
+    If *iface()
+    {
+        return static_cast<If *>(service());
+    }
+
+    /// Addressed datagram send flow from the interface. Externally owned.
+    MessageHandler *sendFlow_;
+    /// Instance of the listener object.
+    ReplyListener listener_ {this};
+    /// Helper object for sleep.
+    StateFlowTimer timer_ {this};
+    /// Clients whose datagram is sent and waiting for the response.
+    std::vector<PoolClient *> inFlight_;
+    /// All clients created, owned by the pool.
+    std::vector<std::unique_ptr<PoolClient>> clients_;
+    /// When the timer flow is sleeping, the time it will wake up.
+    long long wakeupTime_ {0};
+    /// Number of datagrams waiting for another one to the same destination.
+    unsigned numQueued_ {0};
+    /// Largest number of datagrams in flight seen.
+    unsigned peakInFlight_ {0};
+    /// Largest number of datagrams queued seen.
+    unsigned peakQueued_ {0};
+    /// Total number of datagrams sent.
+    unsigned numSent_ {0};
+    /// 1 if the timer flow is waiting for a datagram to be sent.
+    unsigned timerIdle_ : 1;
+    /// 1 if the timer flow is sleeping until wakeupTime_.
+    unsigned isSleeping_ : 1;
+};
+
+} // namespace openlcb
+
+#endif // _OPENLCB_DATAGRAMCLIENTPOOL_HXX_
@@ -86,6 +86,79 @@ public:
         DIE("Canceling datagram send operation is not yet implemented.");
     }
 
+    /// Decodes a response message to a datagram, and updates a datagram
+    /// result code with it. The caller has to check beforehand that the
+    /// response came from the destination and is addressed to the source of
+    /// the datagram.
+    /// @param message an incoming Datagram OK, Datagram Rejected, Terminate
+    /// Due To Error or Optional Interaction Rejected message.
+    /// @param result the datagram result code to update.
+    /// @return true if the message was a response to the datagram, false if
+    /// it should be ignored.
+    static bool apply_response(GenMessage *message, uint32_t *result)
+    {
+        uint16_t error_code = 0;
+        uint8_t payload_length = 0;
+        const uint8_t *payload = nullptr;
+        if (!message->payload.empty())
+        {
+            payload =
+                reinterpret_cast<const uint8_t *>(message->payload.data());
+            payload_length = message->payload.size();
+        }
+        if (payload_length >= 2)
+        {
+            error_code = (((uint16_t)payload[0]) << 8) | payload[1];
+        }
+
+        switch (message->mti)
+        {
+            case Defs::MTI_TERMINATE_DUE_TO_ERROR:
+            case Defs::MTI_OPTIONAL_INTERACTION_REJECTED:
+            {
+                if (payload_length >= 4)
+                {
+                    uint16_t return_mti = payload[2];
+                    return_mti <<= 8;
+                    return_mti |= payload[3];
+                    if (return_mti != Defs::MTI_DATAGRAM)
+                    {
+                        // This must be a rejection of some other
+                        // message. Ignore.
+                        LOG(VERBOSE, "wrong rejection mti");
+                        return false;
+                    }
+                }
+            } // fall through
+            case Defs::MTI_DATAGRAM_REJECTED:
+            {
+                *result &= ~0xffff;
+                *result |= error_code;
+                // Ensures that an error response is visible in the flags.
+                if (!(*result & (PERMANENT_ERROR | RESEND_OK)))
+                {
+                    *result |= PERMANENT_ERROR;
+                }
+                break;
+            }
+            case Defs::MTI_DATAGRAM_OK:
+            {
+                if (payload_length)
+                {
+                    *result &= ~(0xff << RESPONSE_FLAGS_SHIFT);
+                    *result |= payload[0] << RESPONSE_FLAGS_SHIFT;
+                }
+                *result |= OPERATION_SUCCESS;
+                break;
+            }
+            default:
+                // Ignore message.
+                LOG(VERBOSE, "unknown mti");
+                return false;
+        } // switch response MTI
+        return true;
+    }
+
 private:
     /// Equivalent to enqueuing a new datagram to send.
     /// @param b datagram to send.
@@ -293,65 +366,10 @@ private:
             return;
         }
 
-        uint16_t error_code = 0;
-        uint8_t payload_length = 0;
-        const uint8_t *payload = nullptr;
-        if (!message->payload.empty())
+        if (!apply_response(message, &result_))
         {
-            payload =
-                reinterpret_cast<const uint8_t *>(message->payload.data());
-            payload_length = message->payload.size();
-        }
-        if (payload_length >= 2)
-        {
-            error_code = (((uint16_t)payload[0]) << 8) | payload[1];
+            return;
         }
-
-        switch (message->mti)
-        {
-            case Defs::MTI_TERMINATE_DUE_TO_ERROR:
-            case Defs::MTI_OPTIONAL_INTERACTION_REJECTED:
-            {
-                if (payload_length >= 4)
-                {
-                    uint16_t return_mti = payload[2];
-                    return_mti <<= 8;
-                    return_mti |= payload[3];
-                    if (return_mti != Defs::MTI_DATAGRAM)
-                    {
-                        // This must be a rejection of some other
-                        // message. Ignore.
-                        LOG(VERBOSE, "wrong rejection mti");
-                        return;
-                    }
-                }
-            } // fall through
-            case Defs::MTI_DATAGRAM_REJECTED:
-            {
-                result_ &= ~0xffff;
-                result_ |= error_code;
-                // Ensures that an error response is visible in the flags.
-                if (!(result_ & (PERMANENT_ERROR | RESEND_OK)))
-                {
-                    result_ |= PERMANENT_ERROR;
-                }
-                break;
-            }
-            case Defs::MTI_DATAGRAM_OK:
-            {
-                if (payload_length)
-                {
-                    result_ &= ~(0xff << RESPONSE_FLAGS_SHIFT);
-                    result_ |= payload[0] << RESPONSE_FLAGS_SHIFT;
-                }
-                result_ |= OPERATION_SUCCESS;
-                break;
-            }
-            default:
-                // Ignore message.
-                LOG(VERBOSE, "unknown mti");
-                return;
-        } // switch response MTI
         stop_waiting_for_response();
     } // handle_message
 
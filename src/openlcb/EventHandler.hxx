@@ -278,6 +278,23 @@ public:
     virtual void unregister_handler(EventHandler *handler,
         uint32_t user_arg = 0, uint32_t user_arg_mask = 0) = 0;
 
+    /// Adds many event handlers that use the same mask. Equivalent to calling
+    /// register_handler for each entry, but implementations may invalidate
+    /// the running iterations only once and build their lookup structures in
+    /// one go.
+    /// @param entries points to an array of registry entries.
+    /// @param count how many entries there are in the array.
+    /// @param mask is used for registering consecutive events, see
+    /// register_handler.
+    virtual void register_handlers(
+        const EventRegistryEntry *entries, size_t count, unsigned mask)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            register_handler(entries[i], mask);
+        }
+    }
+
     /// Prepares storage for adding many event handlers.
     /// @param count how many empty slots to reserve.
     virtual void reserve(size_t count)
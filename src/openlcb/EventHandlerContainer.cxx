@@ -35,6 +35,7 @@
 #include "openlcb/EventHandlerContainer.hxx"
 
 #include <algorithm>
+#include <climits>
 
 namespace openlcb
 {
@@ -48,6 +49,20 @@ void TreeEventHandlers::register_handler(const EventRegistryEntry &entry,
     handlers_[mask].insert(EventRegistryEntry(entry));
 }
 
+void TreeEventHandlers::register_handlers(
+    const EventRegistryEntry *entries, size_t count, unsigned mask)
+{
+    AtomicHolder h(this);
+    LOG(VERBOSE, "%p: register %u handlers", this, (unsigned)count);
+    set_dirty();
+    OneMaskMap &m = handlers_[mask];
+    m.reserve(m.size() + count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        m.insert(EventRegistryEntry(entries[i]));
+    }
+}
+
 void TreeEventHandlers::unregister_handler(
     EventHandler *handler, uint32_t user_arg, uint32_t user_arg_mask)
 {
@@ -160,4 +175,232 @@ TreeEventHandlers::TreeEventHandlers()
 {
 }
 
+FlatEventHandlers::FlatEventHandlers()
+{
+}
+
+void FlatEventHandlers::register_handler(
+    const EventRegistryEntry &entry, unsigned mask)
+{
+    register_handlers(&entry, 1, mask);
+}
+
+void FlatEventHandlers::register_handlers(
+    const EventRegistryEntry *entries, size_t count, unsigned mask)
+{
+    AtomicHolder h(this);
+    LOG(VERBOSE, "%p: register %u handlers", this, (unsigned)count);
+    set_dirty();
+    for (size_t i = 0; i < count; ++i)
+    {
+        pending_.push_back({entries[i], (uint8_t)mask});
+    }
+}
+
+unsigned FlatEventHandlers::find_range(unsigned mask)
+{
+    unsigned idx = 0;
+    while (idx < ranges_.size() && ranges_[idx].mask < mask)
+    {
+        ++idx;
+    }
+    if (idx < ranges_.size() && ranges_[idx].mask == mask)
+    {
+        return idx;
+    }
+    unsigned ofs =
+        idx < ranges_.size() ? ranges_[idx].begin : entries_.size();
+    Range r;
+    r.begin = r.end = ofs;
+    r.mask = mask;
+    ranges_.insert(ranges_.begin() + idx, r);
+    return idx;
+}
+
+void FlatEventHandlers::sort_entries()
+{
+    if (pending_.empty())
+    {
+        return;
+    }
+    std::stable_sort(pending_.begin(), pending_.end(),
+        [](const PendingEntry &a, const PendingEntry &b) {
+            return a.mask < b.mask;
+        });
+    for (unsigned i = 0; i < pending_.size(); ++i)
+    {
+        if (i == 0 || pending_[i].mask != pending_[i - 1].mask)
+        {
+            find_range(pending_[i].mask);
+        }
+    }
+    // Goes from the last range to the first one, so that every existing
+    // entry moves only once, towards the end of the array.
+    unsigned dst_end = entries_.size() + pending_.size();
+    // The filler values get overwritten below.
+    entries_.resize(dst_end, pending_[0].entry);
+    auto b = entries_.begin();
+    auto p = pending_.end();
+    for (unsigned ri = ranges_.size(); ri-- > 0;)
+    {
+        Range &r = ranges_[ri];
+        auto q = p;
+        while (q != pending_.begin() && (q - 1)->mask == r.mask)
+        {
+            --q;
+        }
+        unsigned num_old = r.end - r.begin;
+        unsigned begin = dst_end - (p - q) - num_old;
+        std::move_backward(b + r.begin, b + r.end, b + begin + num_old);
+        unsigned sorted_end = begin + num_old;
+        for (auto it = q; it != p; ++it)
+        {
+            entries_[sorted_end + (it - q)] = it->entry;
+        }
+        std::sort(b + sorted_end, b + dst_end, EventRegistryEntryCmp());
+        std::inplace_merge(
+            b + begin, b + sorted_end, b + dst_end, EventRegistryEntryCmp());
+        r.begin = begin;
+        r.end = dst_end;
+        dst_end = begin;
+        p = q;
+    }
+    pending_.clear();
+}
+
+void FlatEventHandlers::unregister_handler(
+    EventHandler *handler, uint32_t user_arg, uint32_t user_arg_mask)
+{
+    AtomicHolder h(this);
+    set_dirty();
+    LOG(VERBOSE, "%p: unregister %p", this, handler);
+    auto matches = [handler, user_arg, user_arg_mask](
+                       const EventRegistryEntry &e) {
+        return e.handler == handler &&
+            ((e.user_arg & user_arg_mask) == (user_arg & user_arg_mask));
+    };
+    // Compacts the array in place, keeping the relative order of the entries
+    // and adjusting the range index.
+    unsigned dst = 0;
+    for (Range &r : ranges_)
+    {
+        unsigned begin = dst;
+        for (unsigned src = r.begin; src < r.end; ++src)
+        {
+            const EventRegistryEntry &e = entries_[src];
+            if (matches(e))
+            {
+                continue;
+            }
+            if (dst != src)
+            {
+                entries_[dst] = e;
+            }
+            ++dst;
+        }
+        r.begin = begin;
+        r.end = dst;
+    }
+    entries_.erase(entries_.begin() + dst, entries_.end());
+    pending_.erase(std::remove_if(pending_.begin(), pending_.end(),
+                       [&matches](const PendingEntry &p) {
+                           return matches(p.entry);
+                       }),
+        pending_.end());
+}
+
+void FlatEventHandlers::reserve(size_t count)
+{
+    AtomicHolder h(this);
+    entries_.reserve(entries_.size() + pending_.size() + count);
+    pending_.reserve(pending_.size() + count);
+}
+
+/// Class representing the iteration state on the flat array-based event
+/// handler registry.
+class FlatEventHandlers::Iterator : public EventIterator
+{
+public:
+    Iterator(FlatEventHandlers *parent)
+        : parent_(parent)
+    {
+        clear_iteration();
+    }
+
+    EventRegistryEntry *next_entry() OVERRIDE
+    {
+        AtomicHolder h(parent_);
+        while (range_ < parent_->ranges_.size())
+        {
+            if (it_ < end_)
+            {
+                return &parent_->entries_[it_++];
+            }
+            ++range_;
+            if (range_ < parent_->ranges_.size())
+            {
+                setup_current_range();
+            }
+        }
+        return nullptr;
+    }
+
+    void clear_iteration() OVERRIDE
+    {
+        AtomicHolder h(parent_);
+        range_ = UINT_MAX;
+        it_ = end_ = 0;
+    }
+
+    void init_iteration(EventReport *r) OVERRIDE
+    {
+        AtomicHolder h(parent_);
+        parent_->sort_entries();
+        currentReport_ = r;
+        range_ = 0;
+        it_ = end_ = 0;
+        if (range_ < parent_->ranges_.size())
+        {
+            setup_current_range();
+        }
+    }
+
+private:
+    /// Sets it_ and end_ to the entries of the current range that match the
+    /// current report.
+    void setup_current_range()
+    {
+        const Range &r = parent_->ranges_[range_];
+        if (r.mask >= 64)
+        {
+            // 64 bits -> all events go to everyone.
+            it_ = r.begin;
+            end_ = r.end;
+            return;
+        }
+        auto b = parent_->entries_.begin();
+        uint64_t current_mask = (1ULL << r.mask) - 1;
+        uint64_t eventid_key = currentReport_->event & (~current_mask);
+        it_ = std::lower_bound(b + r.begin, b + r.end, eventid_key,
+                  EventRegistryEntryCmp()) - b;
+        eventid_key = currentReport_->event + currentReport_->mask;
+        end_ = std::upper_bound(b + it_, b + r.end, eventid_key,
+                   EventRegistryEntryCmp()) - b;
+    }
+
+    FlatEventHandlers *parent_;
+    EventReport *currentReport_;
+    /// Index of the current range in parent_->ranges_.
+    unsigned range_;
+    /// Index of the next entry to return.
+    unsigned it_;
+    /// Index after the last entry to return in the current range.
+    unsigned end_;
+};
+
+EventIterator *FlatEventHandlers::create_iterator()
+{
+    return new Iterator(this);
+}
+
 } // namespace openlcb
@@ -144,6 +144,23 @@ public:
   HandlersList handlers_;
 };
 
+/// Comparison operator for event registry entries, ordering them by event ID.
+struct EventRegistryEntryCmp
+{
+    bool operator()(const EventRegistryEntry &d, uint64_t k)
+    {
+        return d.event < k;
+    }
+    bool operator()(uint64_t k, const EventRegistryEntry &d)
+    {
+        return k < d.event;
+    }
+    bool operator()(const EventRegistryEntry &a, const EventRegistryEntry &b)
+    {
+        return a.event < b.event;
+    }
+};
+
 /// EventRegistry implementation that keeps event handlers in a SortedListMap
 /// and filters the event handler calls based on the registered event handler
 /// arguments (id/mask).
@@ -154,6 +171,8 @@ public:
     EventIterator* create_iterator() OVERRIDE;
     void register_handler(const EventRegistryEntry &entry,
                           unsigned mask) OVERRIDE;
+    void register_handlers(const EventRegistryEntry *entries, size_t count,
+                           unsigned mask) OVERRIDE;
     void unregister_handler(EventHandler *handler, uint32_t user_arg = 0,
         uint32_t user_arg_mask = 0) OVERRIDE;
     void reserve(size_t count) OVERRIDE;
@@ -162,24 +181,7 @@ private:
     class Iterator;
     friend class Iterator;
 
-    /// Comparison operator for event registry entries.
-    struct cmpop
-    {
-        bool operator()(const EventRegistryEntry &d, uint64_t k)
-        {
-            return d.event < k;
-        }
-        bool operator()(uint64_t k, const EventRegistryEntry &d)
-        {
-            return k < d.event;
-        }
-        bool operator()(const EventRegistryEntry &a, const EventRegistryEntry &b)
-        {
-            return a.event < b.event;
-        }
-    };
-
-    typedef SortedListSet<EventRegistryEntry, cmpop> OneMaskMap;
+    typedef SortedListSet<EventRegistryEntry, EventRegistryEntryCmp> OneMaskMap;
     typedef std::map<uint8_t, OneMaskMap> MaskLookupMap;
     /** The registered handlers. The offset in the first map tell us how many
      * bits wide the registration is (it is the mask value in the register
@@ -187,6 +189,78 @@ private:
     MaskLookupMap handlers_;
 };
 
+/// EventRegistry implementation that keeps all event handlers in a single
+/// flat array. The array is ordered by the registration mask first and by the
+/// event ID second; a small range index holds where the entries of each mask
+/// begin and end. An incoming event is looked up with a binary search in each
+/// mask's range. Yields the same entries in the same order as
+/// TreeEventHandlers, but with less memory overhead and better locality.
+///
+/// New registrations are collected in a separate list and merged into the
+/// array in one pass at the next lookup, so registering n handlers at startup
+/// costs O(n log n) instead of moving the array for every handler;
+/// register_handlers() adds a whole batch with one invalidation of the
+/// running iterations.
+///
+/// EventService uses this registry when the build defines
+/// OPENMRN_FLAT_EVENT_REGISTRY; see openmrn_features.h.
+class FlatEventHandlers : public EventRegistry, private Atomic
+{
+public:
+    FlatEventHandlers();
+
+    EventIterator *create_iterator() OVERRIDE;
+    void register_handler(const EventRegistryEntry &entry,
+                          unsigned mask) OVERRIDE;
+    void register_handlers(const EventRegistryEntry *entries, size_t count,
+                           unsigned mask) OVERRIDE;
+    void unregister_handler(EventHandler *handler, uint32_t user_arg = 0,
+        uint32_t user_arg_mask = 0) OVERRIDE;
+    void reserve(size_t count) OVERRIDE;
+
+private:
+    class Iterator;
+    friend class Iterator;
+
+    /// Entry of the range index: where the registrations of a given mask are
+    /// in entries_.
+    struct Range
+    {
+        /// Index of the first entry with this mask.
+        unsigned begin;
+        /// Index after the last entry with this mask.
+        unsigned end;
+        /// How many bits wide the registration is (the mask value in the
+        /// register call).
+        uint8_t mask;
+    };
+
+    /// @return the index in ranges_ for a given mask, adding an empty range
+    /// if needed. Must be called with the lock held.
+    /// @param mask the registration mask.
+    unsigned find_range(unsigned mask);
+
+    /// Merges the entries registered since the last call into their
+    /// range. Must be called with the lock held.
+    void sort_entries();
+
+    /// A registration that was not merged into entries_ yet.
+    struct PendingEntry
+    {
+        /// What was registered.
+        EventRegistryEntry entry;
+        /// The registration mask.
+        uint8_t mask;
+    };
+
+    /// All registered handlers.
+    std::vector<EventRegistryEntry> entries_;
+    /// The range index, ordered by mask.
+    std::vector<Range> ranges_;
+    /// Registrations since the last lookup, in registration order.
+    std::vector<PendingEntry> pending_;
+};
+
 }; /* namespace openlcb */
 
 #endif  // _OPENLCB_EVENTHANDLERCONTAINER_HXX_
@@ -12,6 +12,7 @@
 #include "openlcb/EventHandlerTemplates.hxx"
 #include "openlcb/EventHandlerContainer.hxx"
 #include "openlcb/Defs.hxx"
+#include "openmrn_features.h"
 #include "openlcb/EndianHelper.hxx"
 
 namespace openlcb
@@ -58,6 +59,8 @@ EventService::Impl::Impl(EventService *service) : callerFlow_(service)
 {
 #ifdef TARGET_LPC11Cxx
     registry.reset(new VectorEventHandlers());
+#elif OPENMRN_HAVE_FLAT_EVENT_REGISTRY
+    registry.reset(new FlatEventHandlers());
 #else
     registry.reset(new TreeEventHandlers());
 #endif
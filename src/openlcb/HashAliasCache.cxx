@@ -0,0 +1,527 @@
+/** \copyright
+ * Copyright (c) 2026, Balazs Racz
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are  permitted provided that the following conditions are met:
+ *
+ *  - Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  - Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file HashAliasCache.cxx
+ * Alias cache with constant time lookups, for large number of entries.
+ *
+ * @author Balazs Racz
+ * @date 17 Oct 2026
+ */
+
+#include "openlcb/HashAliasCache.hxx"
+
+#include <algorithm>
+#include <vector>
+
+#include "utils/logging.h"
+
+#ifdef GTEST
+#define TEST_CONSISTENCY
+#endif
+
+namespace openlcb
+{
+
+#define CONSTANT 0x1B0CA37ABA9 /**< constant for random number generation */
+
+constexpr uint16_t HashAliasCache::NONE_ENTRY;
+constexpr unsigned HashAliasCache::EVICTION_SAMPLES;
+
+#if defined(TEST_CONSISTENCY)
+// Defined in AliasCache.cxx.
+extern volatile int consistency_result;
+extern bool alias_cache_check_consistency;
+#endif
+
+HashAliasCache::HashAliasCache(NodeID seed, size_t entries,
+    void (*remove_callback)(NodeID id, NodeAlias alias, void *), void *context)
+    : pool_(new Metadata[entries])
+    , seed_(seed)
+    , entries_(entries)
+    , removeCallback_(remove_callback)
+    , context_(context)
+{
+    HASSERT(entries < NONE_ENTRY);
+    // Keeps the load factor of the hash tables at or below 2/3.
+    tableBits_ = 1;
+    while ((1u << tableBits_) * 2 < entries * 3)
+    {
+        ++tableBits_;
+    }
+    tableMask_ = (1u << tableBits_) - 1;
+    aliasTable_ = new uint16_t[tableMask_ + 1];
+    idTable_ = new uint16_t[tableMask_ + 1];
+    clear();
+}
+
+HashAliasCache::~HashAliasCache()
+{
+    delete[] pool_;
+    delete[] aliasTable_;
+    delete[] idTable_;
+}
+
+void HashAliasCache::clear()
+{
+    for (unsigned i = 0; i <= tableMask_; ++i)
+    {
+        aliasTable_[i] = NONE_ENTRY;
+        idTable_[i] = NONE_ENTRY;
+    }
+    freeList_ = NONE_ENTRY;
+    for (size_t i = entries_; i > 0; --i)
+    {
+        pool_[i - 1].alias_ = 0;
+        pool_[i - 1].next_free() = freeList_;
+        freeList_ = i - 1;
+    }
+    numUsed_ = 0;
+}
+
+unsigned HashAliasCache::find_alias_slot(NodeAlias alias)
+{
+    unsigned slot = alias_hash(alias);
+    while (aliasTable_[slot] != NONE_ENTRY &&
+        pool_[aliasTable_[slot]].alias_ != alias)
+    {
+        slot = (slot + 1) & tableMask_;
+    }
+    return slot;
+}
+
+unsigned HashAliasCache::find_id_slot(NodeID id)
+{
+    unsigned slot = id_hash(id);
+    while (idTable_[slot] != NONE_ENTRY &&
+        pool_[idTable_[slot]].get_node_id() != id)
+    {
+        slot = (slot + 1) & tableMask_;
+    }
+    return slot;
+}
+
+template <class H>
+void HashAliasCache::erase_slot(uint16_t *table, unsigned slot, H home)
+{
+    unsigned hole = slot;
+    unsigned next = slot;
+    while (true)
+    {
+        next = (next + 1) & tableMask_;
+        if (table[next] == NONE_ENTRY)
+        {
+            break;
+        }
+        unsigned h = home(table[next]);
+        // The entry at next can move to the hole unless its home slot is
+        // cyclically in (hole, next].
+        bool stays = hole <= next ? (hole < h && h <= next)
+                                  : (hole < h || h <= next);
+        if (!stays)
+        {
+            table[hole] = table[next];
+            hole = next;
+        }
+    }
+    table[hole] = NONE_ENTRY;
+}
+
+void HashAliasCache::release_entry(uint16_t idx)
+{
+    Metadata *m = pool_ + idx;
+    if (m->alias_ != NOT_RESPONDING)
+    {
+        erase_slot(aliasTable_, find_alias_slot(m->alias_),
+            [this](uint16_t i) { return alias_hash(pool_[i].alias_); });
+    }
+    erase_slot(idTable_, find_id_slot(m->get_node_id()),
+        [this](uint16_t i) { return id_hash(pool_[i].get_node_id()); });
+    // Ensures that the AME query handler does not find this metadata.
+    m->alias_ = 0;
+    m->next_free() = freeList_;
+    freeList_ = idx;
+    --numUsed_;
+}
+
+uint16_t HashAliasCache::pick_eviction()
+{
+    HASSERT(numUsed_ > 0);
+    unsigned samples = std::min<unsigned>(EVICTION_SAMPLES, entries_);
+    uint16_t best = NONE_ENTRY;
+    unsigned best_age = 0;
+    // When the cache is full (which is when we evict), every entry is in use,
+    // so the samples are all valid.
+    for (unsigned i = 0; i < samples; ++i)
+    {
+        unsigned idx = evictCursor_;
+        if (++evictCursor_ >= entries_)
+        {
+            evictCursor_ = 0;
+        }
+        Metadata *m = pool_ + idx;
+        if (!m->alias_)
+        {
+            continue;
+        }
+        if (best == NONE_ENTRY || m->lru_.value() > best_age)
+        {
+            best = idx;
+            best_age = m->lru_.value();
+        }
+    }
+    HASSERT(best != NONE_ENTRY);
+    return best;
+}
+
+void HashAliasCache::count_op()
+{
+    if (++opsSinceTick_ < entries_)
+    {
+        return;
+    }
+    opsSinceTick_ = 0;
+    lruTick_.tick();
+    for (unsigned i = 0; i < entries_; ++i)
+    {
+        if (pool_[i].alias_)
+        {
+            pool_[i].lru_.tick(lruTick_);
+        }
+    }
+}
+
+void HashAliasCache::touch(Metadata *metadata)
+{
+    metadata->lru_.touch();
+    count_op();
+}
+
+void HashAliasCache::maybe_check_consistency()
+{
+#if defined(TEST_CONSISTENCY)
+    if (alias_cache_check_consistency)
+    {
+        consistency_result = check_consistency();
+        HASSERT(0 == consistency_result);
+    }
+#endif
+}
+
+void HashAliasCache::add(NodeID id, NodeAlias alias)
+{
+    HASSERT(id != 0);
+    HASSERT(alias != 0);
+
+    if (alias != NOT_RESPONDING)
+    {
+        // We can have more than one NOT_RESPONDING entry.
+        uint16_t idx = aliasTable_[find_alias_slot(alias)];
+        if (idx != NONE_ENTRY)
+        {
+            /* we already have a mapping for this alias, so lets remove it */
+            NodeID nid = pool_[idx].get_node_id();
+            NodeAlias a = pool_[idx].alias_;
+            release_entry(idx);
+            if (removeCallback_)
+            {
+                /* tell the interface layer that we removed this mapping */
+                (*removeCallback_)(nid, a, context_);
+            }
+        }
+    }
+    uint16_t idx = idTable_[find_id_slot(id)];
+    if (idx != NONE_ENTRY)
+    {
+        /* we already have a mapping for this id, so lets remove it */
+        NodeAlias a = pool_[idx].alias_;
+        release_entry(idx);
+        if (removeCallback_)
+        {
+            /* tell the interface layer that we removed this mapping */
+            (*removeCallback_)(id, a, context_);
+        }
+    }
+
+    if (freeList_ == NONE_ENTRY)
+    {
+        /* kick out the oldest mapping */
+        idx = pick_eviction();
+        NodeID nid = pool_[idx].get_node_id();
+        NodeAlias a = pool_[idx].alias_;
+        release_entry(idx);
+        if (removeCallback_)
+        {
+            /* tell the interface layer that we removed this mapping */
+            (*removeCallback_)(nid, a, context_);
+        }
+    }
+    idx = freeList_;
+    Metadata *insert = pool_ + idx;
+    freeList_ = insert->next_free();
+
+    insert->set_node_id(id);
+    insert->alias_ = alias;
+    insert->lru_.touch();
+    if (alias != NOT_RESPONDING)
+    {
+        // NOT_RESPONDING entries are only findable by node ID. There can be
+        // any number of them.
+        aliasTable_[find_alias_slot(alias)] = idx;
+    }
+    idTable_[find_id_slot(id)] = idx;
+    ++numUsed_;
+    count_op();
+
+    maybe_check_consistency();
+}
+
+void HashAliasCache::remove(NodeAlias alias)
+{
+    if (alias == 0 || alias == NOT_RESPONDING)
+    {
+        return;
+    }
+    uint16_t idx = aliasTable_[find_alias_slot(alias)];
+    if (idx != NONE_ENTRY)
+    {
+        release_entry(idx);
+    }
+    maybe_check_consistency();
+}
+
+bool HashAliasCache::retrieve(unsigned entry, NodeID *node, NodeAlias *alias)
+{
+    HASSERT(entry < size());
+    Metadata *md = pool_ + entry;
+    if (!md->alias_)
+    {
+        return false;
+    }
+    if (node)
+    {
+        *node = md->get_node_id();
+    }
+    if (alias)
+    {
+        *alias = md->alias_;
+    }
+    return true;
+}
+
+bool HashAliasCache::next_entry(NodeID bound, NodeID *node, NodeAlias *alias)
+{
+    Metadata *found = nullptr;
+    NodeID found_id = 0;
+    for (unsigned i = 0; i < entries_; ++i)
+    {
+        Metadata *m = pool_ + i;
+        if (!m->alias_)
+        {
+            continue;
+        }
+        NodeID id = m->get_node_id();
+        if (id > bound && (!found || id < found_id))
+        {
+            found = m;
+            found_id = id;
+        }
+    }
+    if (!found)
+    {
+        return false;
+    }
+    if (alias)
+    {
+        *alias = found->alias_;
+    }
+    if (node)
+    {
+        *node = found_id;
+    }
+    return true;
+}
+
+NodeAlias HashAliasCache::lookup(NodeID id)
+{
+    HASSERT(id != 0);
+    uint16_t idx = idTable_[find_id_slot(id)];
+    if (idx == NONE_ENTRY)
+    {
+        /* no match found */
+        return 0;
+    }
+    Metadata *metadata = pool_ + idx;
+    /* update timestamp */
+    touch(metadata);
+    return metadata->alias_;
+}
+
+NodeID HashAliasCache::lookup(NodeAlias alias)
+{
+    if (alias == 0 || alias == NOT_RESPONDING)
+    {
+        return 0;
+    }
+    uint16_t idx = aliasTable_[find_alias_slot(alias)];
+    if (idx == NONE_ENTRY)
+    {
+        /* no match found */
+        return 0;
+    }
+    Metadata *metadata = pool_ + idx;
+    /* update timestamp */
+    touch(metadata);
+    return metadata->get_node_id();
+}
+
+void HashAliasCache::for_each(
+    void (*callback)(void *, NodeID, NodeAlias), void *context)
+{
+    HASSERT(callback != NULL);
+    std::vector<uint16_t> order;
+    order.reserve(numUsed_);
+    for (unsigned i = 0; i < entries_; ++i)
+    {
+        if (pool_[i].alias_)
+        {
+            order.push_back(i);
+        }
+    }
+    std::stable_sort(
+        order.begin(), order.end(), [this](uint16_t a, uint16_t b) {
+            return pool_[a].lru_.value() < pool_[b].lru_.value();
+        });
+    for (uint16_t idx : order)
+    {
+        Metadata *metadata = pool_ + idx;
+        (*callback)(context, metadata->get_node_id(),
+            metadata->alias_);
+    }
+}
+
+NodeAlias HashAliasCache::generate()
+{
+    NodeAlias alias;
+
+    do
+    {
+        /* calculate the alias given the current seed */
+        alias = (seed_ ^ (seed_ >> 12) ^ (seed_ >> 24) ^ (seed_ >> 36)) & 0xfff;
+
+        /* calculate the next seed */
+        seed_ = ((((1 << 9) + 1) * (seed_) + CONSTANT)) & 0xffffffffffff;
+    } while (alias == 0 || lookup(alias) != 0);
+
+    /* new random alias */
+    return alias;
+}
+
+int HashAliasCache::check_consistency()
+{
+    unsigned num_free = 0;
+    for (uint16_t i = freeList_; i != NONE_ENTRY; i = pool_[i].next_free())
+    {
+        if (i >= entries_)
+        {
+            LOG(INFO, "Freelist points outside the pool.");
+            return 1;
+        }
+        if (pool_[i].alias_)
+        {
+            LOG(INFO, "Used entry on the freelist.");
+            return 2;
+        }
+        if (++num_free > entries_)
+        {
+            LOG(INFO, "Loop in the freelist.");
+            return 3;
+        }
+    }
+    if (num_free + numUsed_ != entries_)
+    {
+        LOG(INFO, "Lost some metadata entries.");
+        return 4;
+    }
+    unsigned num_alias = 0;
+    unsigned num_id = 0;
+    for (unsigned i = 0; i <= tableMask_; ++i)
+    {
+        if (aliasTable_[i] != NONE_ENTRY)
+        {
+            ++num_alias;
+            NodeAlias a = pool_[aliasTable_[i]].alias_;
+            if (!a || a == NOT_RESPONDING)
+            {
+                LOG(INFO, "Alias table points to a free entry.");
+                return 5;
+            }
+        }
+        if (idTable_[i] != NONE_ENTRY)
+        {
+            ++num_id;
+            if (!pool_[idTable_[i]].alias_)
+            {
+                LOG(INFO, "ID table points to a free entry.");
+                return 6;
+            }
+        }
+    }
+    unsigned num_not_responding = 0;
+    for (unsigned i = 0; i < entries_; ++i)
+    {
+        if (pool_[i].alias_ == NOT_RESPONDING)
+        {
+            ++num_not_responding;
+        }
+    }
+    if (num_alias + num_not_responding != numUsed_ || num_id != numUsed_)
+    {
+        LOG(INFO, "Hash table sizes do not match the entry count.");
+        return 7;
+    }
+    for (unsigned i = 0; i < entries_; ++i)
+    {
+        Metadata *m = pool_ + i;
+        if (!m->alias_)
+        {
+            continue;
+        }
+        if (m->alias_ != NOT_RESPONDING &&
+            aliasTable_[find_alias_slot(m->alias_)] != i)
+        {
+            LOG(INFO, "Entry is not found by alias.");
+            return 8;
+        }
+        if (idTable_[find_id_slot(m->get_node_id())] != i)
+        {
+            LOG(INFO, "Entry is not found by node ID.");
+            return 9;
+        }
+    }
+    return 0;
+}
+
+} // namespace openlcb
@@ -0,0 +1,290 @@
+/** \copyright
+ * Copyright (c) 2026, Balazs Racz
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are  permitted provided that the following conditions are met:
+ *
+ *  - Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  - Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file HashAliasCache.hxx
+ * Alias cache with constant time lookups, for large number of entries.
+ *
+ * @author Balazs Racz
+ * @date 17 Oct 2026
+ */
+
+#ifndef _OPENLCB_HASHALIASCACHE_HXX_
+#define _OPENLCB_HASHALIASCACHE_HXX_
+
+#include "openlcb/Defs.hxx"
+#include "utils/LruCounter.hxx"
+#include "utils/macros.h"
+
+namespace openlcb
+{
+
+/** Cache of alias to node id mappings, with the same API as AliasCache, but
+ * constant time operations. Intended for interfaces that track thousands of
+ * remote nodes. All the memory is allocated at construction time. There is no
+ * locking; mutual exclusion must be handled by the user.
+ *
+ * Theory of operation:
+ *
+ * The NodeID and alias of each entry is stored in the Metadata struct, laid
+ * out in the pre-allocated array `pool_`. Unused entries have alias 0 and are
+ * linked into a free list.
+ *
+ * Lookup by alias and by NodeID happens via two open-addressing hash tables
+ * with linear probing, which contain 16-bit indexes into `pool_`. The tables
+ * are sized to at most 2/3 load. Removal uses backward shift deletion, so
+ * there are no tombstones. NOT_RESPONDING entries are only in the NodeID
+ * table.
+ *
+ * Instead of an exact LRU list, each entry has an 8-bit LruCounter. The
+ * counters are advanced after every size() operations (amortized constant
+ * time). When the cache is full, the entry to evict is the oldest among a
+ * small window of entries starting at a rotating cursor.
+ *
+ * Differences from AliasCache: for_each() visits the entries in approximate
+ * last touched order; next_entry() is linear time in the cache size.
+ */
+class HashAliasCache
+{
+public:
+    /** Constructor.
+     * @param seed starting seed for generation of aliases
+     * @param entries maximum number of entries in this cache
+     * @param remove_callback callback to call when we remove a mapping from
+     *        the cache however it will not be called in the remove() method
+     * @param context context pointer to pass to remove_callback
+     */
+    HashAliasCache(NodeID seed, size_t entries,
+        void (*remove_callback)(NodeID id, NodeAlias alias, void *) = NULL,
+        void *context = NULL);
+
+    /** Default destructor */
+    ~HashAliasCache();
+
+    /// Sentinel entry for empty hash slots and lists.
+    static constexpr uint16_t NONE_ENTRY = 0xFFFFu;
+
+    /** Reinitializes the entire map. */
+    void clear();
+
+    /** Add an alias to an alias cache.
+     * @param id 48-bit NMRAnet Node ID to associate alias with
+     * @param alias 12-bit alias associated with Node ID
+     */
+    void add(NodeID id, NodeAlias alias);
+
+    /** Remove an alias from an alias cache.  This method does not call the
+     * remove_callback method passed in at construction since it is a
+     * deliberate call not requiring notification.
+     * @param alias 12-bit alias associated with Node ID
+     */
+    void remove(NodeAlias alias);
+
+    /** Lookup a node's alias based on its Node ID.
+     * @param id Node ID to look for
+     * @return alias that matches the Node ID, else 0 if not found
+     */
+    NodeAlias lookup(NodeID id);
+
+    /** Lookup a node's ID based on its alias.
+     * @param alias alias to look for
+     * @return Node ID that matches the alias, else 0 if not found
+     */
+    NodeID lookup(NodeAlias alias);
+
+    /** Call the given callback function once for each alias tracked. The
+     * order is approximately the last "touched" order (newest first).
+     * @param callback method to call
+     * @param context context pointer to pass to callback
+     */
+    void for_each(void (*callback)(void *, NodeID, NodeAlias), void *context);
+
+    /** Returns the total number of aliases that can be cached. */
+    size_t size()
+    {
+        return entries_;
+    }
+
+    /** Retrieves an entry by index. Allows stable iteration in the face of
+     * changes.
+     * @param entry is between 0 and size() - 1.
+     * @param node will be filled with the node ID. May be null.
+     * @param alias will be filled with the alias. May be null.
+     * @return true if the entry is valid, and node and alias were filled,
+     * otherwise false if the entry is not allocated.
+     */
+    bool retrieve(unsigned entry, NodeID *node, NodeAlias *alias);
+
+    /** Retrieves the next entry by increasing node ID. This is linear time in
+     * the size of the cache.
+     * @param bound is a Node ID. Will search for the next largest node ID
+     * (upper bound of this key).
+     * @param node will be filled with the node ID. May be null.
+     * @param alias will be filled with the alias. May be null.
+     * @return true if a larger element is found and node and alias were
+     * filled, otherwise false if bound is >= the largest node ID in the cache.
+     */
+    bool next_entry(NodeID bound, NodeID *node, NodeAlias *alias);
+
+    /** Generate a 12-bit pseudo-random alias for a given alias cache.
+     * @return pseudo-random 12-bit alias, an alias of zero is invalid
+     */
+    NodeAlias generate();
+
+    /** Visible for testing. Check internal consistency. */
+    int check_consistency();
+
+private:
+    /// How many entries we look at when picking an entry to evict.
+    static constexpr unsigned EVICTION_SAMPLES = 16;
+
+    /** Interesting information about a given cache entry. */
+    struct Metadata
+    {
+        /// Sets the node ID field.
+        /// @param id the node ID to set.
+        void set_node_id(NodeID id)
+        {
+            nodeId_[0] = id & 0xFFFFu;
+            nodeId_[1] = (id >> 16) & 0xFFFFu;
+            nodeId_[2] = (id >> 32) & 0xFFFFu;
+        }
+
+        /// @return the node ID field.
+        NodeID get_node_id()
+        {
+            return (uint64_t(nodeId_[2]) << 32) |
+                (uint64_t(nodeId_[1]) << 16) | nodeId_[0];
+        }
+
+        /// @return the link to the next free entry. Valid only when this
+        /// entry is on the free list.
+        uint16_t &next_free()
+        {
+            return nodeId_[0];
+        }
+
+        /// OpenLCB Node ID, in 16-bit pieces to avoid padding.
+        uint16_t nodeId_[3];
+        /// OpenLCB-CAN alias. 0 if the entry is free.
+        NodeAlias alias_ = 0;
+        /// Approximate age of the entry.
+        LruCounter<uint8_t> lru_;
+    };
+
+    /// @param alias a stored alias @return home slot in aliasTable_.
+    unsigned alias_hash(NodeAlias alias)
+    {
+        return (uint32_t(alias) * 2654435761u) >> (32 - tableBits_);
+    }
+
+    /// @param id a node ID @return home slot in idTable_.
+    unsigned id_hash(NodeID id)
+    {
+        return (id * UINT64_C(0x9E3779B97F4A7C15)) >> (64 - tableBits_);
+    }
+
+    /// Finds an alias in the alias table.
+    /// @param alias stored alias value
+    /// @return the slot where the alias is, or the empty slot where it would
+    /// have to be inserted.
+    unsigned find_alias_slot(NodeAlias alias);
+
+    /// Finds a node ID in the ID table.
+    /// @param id node ID
+    /// @return the slot where the ID is, or the empty slot where it would
+    /// have to be inserted.
+    unsigned find_id_slot(NodeID id);
+
+    /// Removes an entry from one of the hash tables.
+    /// @param table aliasTable_ or idTable_
+    /// @param slot where the entry to remove is
+    /// @param home function returning the home slot of a pool index.
+    template <class H> void erase_slot(uint16_t *table, unsigned slot, H home);
+
+    /// Removes an entry from both hash tables and puts it on the free list.
+    /// Does not call the remove callback.
+    /// @param idx index into pool_.
+    void release_entry(uint16_t idx);
+
+    /// Picks the entry to kick out when the cache is full. @return index into
+    /// pool_.
+    uint16_t pick_eviction();
+
+    /** Update the time stamp for a given entry.
+     * @param metadata metadata associated with the entry
+     */
+    void touch(Metadata *metadata);
+
+    /// Counts an operation, and advances the LRU counters if needed.
+    void count_op();
+
+    /// Runs the consistency check if enabled (only in tests).
+    void maybe_check_consistency();
+
+    /** pointer to allocated Metadata pool */
+    Metadata *pool_;
+    /// Open addressing table of pool indexes, keyed by the alias.
+    uint16_t *aliasTable_;
+    /// Open addressing table of pool indexes, keyed by the node ID.
+    uint16_t *idTable_;
+    /// Number of bits in the hash table index.
+    uint8_t tableBits_;
+    /// Number of slots in the hash tables minus one.
+    unsigned tableMask_;
+
+    /** list of unused mapping entries (index into pool) */
+    uint16_t freeList_;
+
+    /// Number of entries in use.
+    unsigned numUsed_;
+
+    /// Where to start looking for an entry to evict.
+    unsigned evictCursor_ {0};
+
+    /// How many operations happened since the last tick of the LRU counters.
+    unsigned opsSinceTick_ {0};
+
+    /// Global tick counter for the entries' LRU counters.
+    GlobalLruCounter lruTick_;
+
+    /** Seed for the generation of the next alias */
+    NodeID seed_;
+
+    /** How many metadata entries have we allocated. */
+    size_t entries_;
+
+    /** callback function to be used when we remove an entry from the cache */
+    void (*removeCallback_)(NodeID id, NodeAlias alias, void *);
+
+    /** context pointer to pass in with remove_callback */
+    void *context_;
+
+    DISALLOW_COPY_AND_ASSIGN(HashAliasCache);
+};
+
+} /* namespace openlcb */
+
+#endif // _OPENLCB_HASHALIASCACHE_HXX_
@@ -34,6 +34,8 @@
 
 #include "openlcb/IfCan.hxx"
 
+#include <algorithm>
+#include <vector>
 #include "utils/StlMap.hxx"
 #include "openlcb/AliasAllocator.hxx"
 #include "openlcb/IfImpl.hxx"
@@ -627,7 +629,8 @@ public:
             buffer_key |= CanDefs::get_mti(id_);
             /** @todo (balazs.racz): handle the error cases here, like when we
              * get a middle frame out of the blue etc. */
-            Payload *mapped_buffer = &pendingBuffers_[buffer_key];
+            auto pending = find_pending(buffer_key);
+            Payload *mapped_buffer = &pending->payload;
             if ((f->data[0] & CanDefs::NOT_FIRST_FRAME) == 0)
             {
                 // First frame. Make sure the pending buffer is empty.
@@ -639,6 +642,9 @@ public:
                         (unsigned)id_, f->data[0], f->data[1]);
                 }
                 mapped_buffer->clear();
+                // One allocation up front instead of repeated regrowth as
+                // the frames arrive.
+                mapped_buffer->reserve(MULTI_FRAME_RESERVE);
             }
             if (f->can_dlc > 2)
             {
@@ -654,7 +660,7 @@ public:
             {
                 // Frame complete.
                 mapped_buffer->swap(buf_);
-                pendingBuffers_.erase(buffer_key);
+                pendingBuffers_.erase(pending);
             }
         }
         else
@@ -698,11 +704,53 @@ public:
     }
 
 private:
+    /// How many bytes of payload storage to allocate when the first frame of
+    /// a multi-frame message arrives. Covers a typical SNIP reply.
+    static constexpr unsigned MULTI_FRAME_RESERVE = 64;
+
+    /// Reassembly state for one multi-frame message.
+    struct PendingBuffer
+    {
+        /// Destination alias, source alias and MTI of the message.
+        uint64_t key;
+        /// Payload bytes collected so far.
+        Payload payload;
+
+        /// Sort order of pendingBuffers_. @param k key to compare to.
+        /// @return true if this entry comes before key k.
+        bool operator<(uint64_t k) const
+        {
+            return key < k;
+        }
+    };
+
+    typedef std::vector<PendingBuffer>::iterator PendingIterator;
+
+    /// Looks up the reassembly slot for a given message with a binary
+    /// search, or inserts an empty one if there is none yet.
+    /// @param key is the destination alias, source alias and MTI of the
+    /// message.
+    /// @return reassembly slot for key. Invalidated by the next call.
+    PendingIterator find_pending(uint64_t key)
+    {
+        auto it = std::lower_bound(
+            pendingBuffers_.begin(), pendingBuffers_.end(), key);
+        if (it == pendingBuffers_.end() || it->key != key)
+        {
+            it = pendingBuffers_.insert(it, PendingBuffer {key, Payload()});
+        }
+        return it;
+    }
+
     uint32_t id_;
     string buf_;
     NodeHandle dstHandle_;
-    /// Reassembly buffers for multi-frame messages.
-    StlMap<uint32_t, Payload> pendingBuffers_;
+    /// Reassembly buffers for the multi-frame messages in progress, sorted
+    /// by key. Entries are removed when a message completes; the vector keeps
+    /// its capacity, so the steady state does not allocate any container
+    /// memory, only the payload itself, which is handed over to the outgoing
+    /// GenMessage.
+    std::vector<PendingBuffer> pendingBuffers_;
 };
 
 IfCan::IfCan(ExecutorBase *executor, CanHubFlow *device,
@@ -41,11 +41,22 @@
 #include "openlcb/If.hxx"
 #include "openlcb/AliasCache.hxx"
 #include "openlcb/Defs.hxx"
+#include "openlcb/HashAliasCache.hxx"
+#include "openmrn_features.h"
 #include "utils/CanIf.hxx"
 
 namespace openlcb
 {
 
+#if OPENMRN_HAVE_HASH_REMOTE_ALIAS_CACHE
+/// Type of the alias cache for remote nodes. See
+/// OPENMRN_HAVE_HASH_REMOTE_ALIAS_CACHE in openmrn_features.h.
+typedef HashAliasCache RemoteAliasCache;
+#else
+/// Type of the alias cache for remote nodes.
+typedef AliasCache RemoteAliasCache;
+#endif
+
 class IfCan;
 
 /** Counts the number of alias conflicts that we see for aliases that we
@@ -100,7 +111,7 @@ public:
     }
 
     /// @returns the alias cache for remote nodes on this IF
-    AliasCache *remote_aliases()
+    RemoteAliasCache *remote_aliases()
     {
         executor()->assert_current();
         return &remoteAliases_;
@@ -148,7 +159,7 @@ private:
      *
      *  This member must only be accessed from the If's executor.
      */
-    AliasCache remoteAliases_;
+    RemoteAliasCache remoteAliases_;
 
     /// Various implementation control flows that this interface owns.
     std::vector<std::unique_ptr<Executable>> ownedFlows_;
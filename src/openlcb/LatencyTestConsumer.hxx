@@ -36,6 +36,8 @@
 #define _OPENLCB_LATENCYTESTCONSUMER_HXX_
 
 #include "openlcb/EventHandlerTemplates.hxx"
+#include "os/os.h"
+#include "utils/Stats.hxx"
 
 namespace openlcb
 {
@@ -58,18 +60,48 @@ namespace openlcb
 /// the consumer will reply on the bus. Requests' handling is not
 /// parallelized. If the hook process cannot complete the requests fast enough,
 /// the node will run out of memory and crash.
+///
+/// Optionally the local delivery latency can be recorded in a histogram owned
+/// by the caller. This is the time from the arrival of the identify consumer
+/// message at the interface until the reply is handed to the outgoing
+/// message queue, including the event service queueing and the hook.
 class LatencyTestConsumer : public SimpleEventHandler
 {
 public:
     /// To complete the hook, call the notifiable.
     using HookFn = std::function<void(Notifiable *)>;
 
-    LatencyTestConsumer(Node *node, HookFn hook = nullptr)
+    /// Histogram of the delivery latencies in usec.
+    using LatencyHistogram = Histogram<4, 32>;
+
+    /// @param node is the node that will be sending responses.
+    /// @param hook will be invoked and waited for before each reply.
+    /// @param latency if not null, the delivery latency of each request is
+    /// recorded here (in usec). Owned by the caller, must outlive *this.
+    LatencyTestConsumer(Node *node, HookFn hook = nullptr,
+        LatencyHistogram *latency = nullptr)
         : node_(node)
         , hook_(hook)
+        , latency_(latency)
+        , arrivalHandler_(this)
     {
         EventRegistry::instance()->register_handler(
             EventRegistryEntry(this, EVENT_BASE), 32);
+        if (latency_)
+        {
+            node_->iface()->dispatcher()->register_handler(&arrivalHandler_,
+                Defs::MTI_CONSUMER_IDENTIFY, Defs::MTI_EXACT);
+        }
+    }
+
+    ~LatencyTestConsumer()
+    {
+        if (latency_)
+        {
+            node_->iface()->dispatcher()->unregister_handler_all(
+                &arrivalHandler_);
+        }
+        EventRegistry::instance()->unregister_handler(this);
     }
 
     void handle_identify_global(const EventRegistryEntry &registry_entry,
@@ -91,6 +123,10 @@ public:
     {
         event_ = event;
         done_ = done;
+        if (latency_)
+        {
+            start_ = take_arrival(event->event);
+        }
         if (hook_)
         {
             hook_(new TempNotifiable([this]() { reply(); }));
@@ -102,9 +138,68 @@ public:
     }
 
 private:
+    /// Registered in the interface dispatcher to take the arrival timestamp
+    /// of the incoming identify consumer messages.
+    class ArrivalHandler : public MessageHandler
+    {
+    public:
+        /// @param parent is the LatencyTestConsumer that owns *this
+        ArrivalHandler(LatencyTestConsumer *parent)
+            : parent_(parent)
+        {
+        }
+
+        /// @param b incoming message
+        void send(Buffer<GenMessage> *b, unsigned) override
+        {
+            auto d = get_buffer_deleter(b);
+            if (b->data()->payload.size() != 8)
+            {
+                return;
+            }
+            EventId ev = data_to_eventid(b->data()->payload.data());
+            if ((ev >> 32) != (EVENT_BASE >> 32))
+            {
+                return;
+            }
+            Arrival &a = parent_->arrivals_[parent_->nextArrival_];
+            parent_->nextArrival_ =
+                (parent_->nextArrival_ + 1) % NUM_ARRIVALS;
+            a.id = ev & 0xffffffff;
+            a.time = os_get_time_monotonic();
+        }
+
+    private:
+        /// LatencyTestConsumer that owns *this.
+        LatencyTestConsumer *parent_;
+    };
+
+    /// Looks up and consumes the arrival timestamp of a request.
+    /// @param ev the event ID of the request.
+    /// @return the arrival time of the request, or the current time if it
+    /// was not recorded.
+    long long take_arrival(EventId ev)
+    {
+        uint32_t id = ev & 0xffffffff;
+        for (Arrival &a : arrivals_)
+        {
+            if (a.time && a.id == id)
+            {
+                long long t = a.time;
+                a.time = 0;
+                return t;
+            }
+        }
+        return os_get_time_monotonic();
+    }
+
     void reply()
     {
         AutoNotify an(done_);
+        if (latency_)
+        {
+            latency_->add(NSEC_TO_USEC(os_get_time_monotonic() - start_));
+        }
         event_->event_write_helper<1>()->WriteAsync(node_,
             Defs::MTI_CONSUMER_IDENTIFIED_UNKNOWN, WriteHelper::global(),
             eventid_to_buffer(event_->event), done_->new_child());
@@ -114,6 +209,20 @@ private:
     /// the id.
     static constexpr EventId EVENT_BASE = 0x0900013900000000;
 
+    /// How many requests' arrival timestamps we remember. Requests that are
+    /// queued deeper than this in the event service get timed from handler
+    /// entry instead.
+    static constexpr unsigned NUM_ARRIVALS = 4;
+
+    /// Arrival timestamp of a request.
+    struct Arrival
+    {
+        /// Lower 32 bits of the event ID.
+        uint32_t id;
+        /// os_get_time_monotonic() at arrival, 0 if unused.
+        long long time {0};
+    };
+
     /// Which node should be sending responses.
     Node *node_;
 
@@ -126,6 +235,21 @@ private:
 
     /// Will notify this after sending the reply.
     BarrierNotifiable *done_ {nullptr};
+
+    /// Distribution of the delivery latencies, or nullptr if not measured.
+    LatencyHistogram *latency_;
+
+    /// Arrival time of the request we are working on.
+    long long start_ {0};
+
+    /// Arrival timestamps of recent requests, a ring buffer.
+    Arrival arrivals_[NUM_ARRIVALS];
+
+    /// Where to record the next arrival in arrivals_.
+    unsigned nextArrival_ {0};
+
+    /// Registered in the dispatcher when latency_ is set.
+    ArrivalHandler arrivalHandler_;
 };
 
 } // namespace openlcb
@@ -46,6 +46,7 @@
 #include "can_ioctl.h"
 #endif
 
+#include "openlcb/ConfigFileSnapshot.hxx"
 #include "openlcb/ConfigUpdateFlow.hxx"
 
 extern "C" {
@@ -158,6 +159,7 @@ size_t FileMemorySpace::write(address_t destination, const uint8_t *data,
         return 0;
     }
     ssize_t ret = ::write(fd_, data, len);
+    ConfigFileSnapshot::invalidate(fd_);
     if (ret < 0)
     {
         LOG(INFO, "Error writing to fd %d: %s", fd_, strerror(errno));
@@ -40,6 +40,7 @@
 #include "openlcb/IfCan.hxx"
 #include "openlcb/MemoryConfig.hxx"
 #include "openlcb/StreamReceiver.hxx"
+#include "openlcb/StreamSender.hxx"
 #include "openlcb/StreamTransport.hxx"
 
 namespace openlcb
@@ -72,6 +73,11 @@ struct MemoryConfigClientRequest : public CallableFlowRequestBase
         WRITE
     };
 
+    enum WriteStreamCmd
+    {
+        WRITE_STREAM
+    };
+
     enum UpdateCompleteCmd
     {
         UPDATE_COMPLETE
@@ -180,6 +186,21 @@ struct MemoryConfigClientRequest : public CallableFlowRequestBase
         payload = std::move(data);
     }
 
+    /// Sets up a command to write a part of a memory space using stream
+    /// transport.
+    /// @param WriteStreamCmd polymorphic matching arg; always set to
+    /// WRITE_STREAM.
+    /// @param d is the destination node to write to
+    /// @param space is the memory space to write to
+    /// @param offset if the address of the first byte to write
+    /// @param data is the data to write
+    void reset(WriteStreamCmd, NodeHandle d, uint8_t space, unsigned offset,
+        string data)
+    {
+        reset(WRITE, d, space, offset, std::move(data));
+        use_stream = true;
+    }
+
     /// Sets up a command to send an Update Complete request to a remote node.
     /// @param UpdateCompleteCmd polymorphic matching arg; always set to
     /// UPDATE_COMPLETE.
@@ -603,6 +624,7 @@ private:
         return return_with_error(error);
     }
 
+protected:
     void cleanup_write()
     {
         responsePayload_.clear();
@@ -617,6 +639,8 @@ private:
         return return_ok();
     }
 
+private:
+
     Action do_meta_request()
     {
         dgClient_ = full_allocation_result(dg_service()->client_allocator());
@@ -782,6 +806,21 @@ private:
                         parent_->timer_.trigger();
                     }
                     return respond_ok(0);
+                case MemoryConfigDefs::COMMAND_WRITE_STREAM_REPLY:
+                case MemoryConfigDefs::COMMAND_WRITE_STREAM_FAILED:
+                    if (parent_->request()->cmd !=
+                            MemoryConfigClientRequest::CMD_WRITE ||
+                        !parent_->request()->use_stream)
+                    {
+                        break;
+                    }
+                    parent_->responseCode_ = 0;
+                    message()->data()->payload.swap(parent_->responsePayload_);
+                    if (parent_->isWaitingForTimer_)
+                    {
+                        parent_->timer_.trigger();
+                    }
+                    return respond_ok(0);
             }
             return respond_reject(Defs::ERROR_UNIMPLEMENTED_SUBCMD);
         }
@@ -832,13 +871,10 @@ public:
         Node *node, MemoryConfigHandler *memcfg, uint8_t local_stream_id)
         : MemoryConfigClient(node, memcfg)
     {
-        /// @todo make this not specific to the CAN-buf interface but somehow
-        /// portable.
-        IfCan *iface = static_cast<IfCan *>(node_->iface());
-        HASSERT(iface);
-        HASSERT(iface->stream_transport());
-        dstStreamId_ = iface->stream_transport()->get_next_stream_receive_id();
-        receiver_.reset(new StreamReceiverCan(iface, dstStreamId_));
+        StreamTransport *transport = node_->iface()->stream_transport();
+        HASSERT(transport);
+        dstStreamId_ = transport->get_next_stream_receive_id();
+        receiver_.reset(transport->create_receiver(dstStreamId_));
     }
 
 protected:
@@ -855,6 +891,9 @@ protected:
             case MemoryConfigClientRequest::CMD_READ_PART:
                 return allocate_and_call(
                     STATE(do_stream_read), dg_service()->client_allocator());
+            case MemoryConfigClientRequest::CMD_WRITE:
+                return allocate_and_call(
+                    STATE(do_stream_write), dg_service()->client_allocator());
             default:
                 return return_with_error(Defs::ERROR_UNIMPLEMENTED_SUBCMD);
         }
@@ -992,6 +1031,177 @@ protected:
         return return_with_error(request()->resultCode);
     }
 
+    Action do_stream_write()
+    {
+        dgClient_ = full_allocation_result(dg_service()->client_allocator());
+        memoryConfigHandler_->set_client(&responseFlow_);
+        return allocate_and_call(
+            STATE(got_stream_sender), stream_transport()->sender_allocator());
+    }
+
+    Action got_stream_sender()
+    {
+        sender_ =
+            full_allocation_result(stream_transport()->sender_allocator());
+        srcStreamId_ = stream_transport()->get_send_stream_id();
+        return allocate_and_call(dg_service()->iface()->dispatcher(),
+            STATE(send_stream_write_datagram));
+    }
+
+    Action send_stream_write_datagram()
+    {
+        auto *b = get_allocation_result(dg_service()->iface()->dispatcher());
+        b->set_done(bn_.reset(this));
+        b->data()->reset(Defs::MTI_DATAGRAM, node_->node_id(), request()->dst,
+            MemoryConfigDefs::write_stream_datagram(
+                request()->memory_space, request()->address, srcStreamId_));
+
+        isWaitingForTimer_ = 0;
+        responseCode_ = DatagramClient::OPERATION_PENDING;
+        dgClient_->write_datagram(b);
+        return wait_and_call(STATE(stream_write_dg_complete));
+    }
+
+    Action stream_write_dg_complete()
+    {
+        if (!(dgClient_->result() & DatagramClient::OPERATION_SUCCESS))
+        {
+            // some error occurred.
+            return handle_stream_write_error(dgClient_->result());
+        }
+        if (responseCode_ & DatagramClient::OPERATION_PENDING)
+        {
+            isWaitingForTimer_ = 1;
+            return sleep_and_call(
+                &timer_, SEC_TO_NSEC(3), STATE(stream_write_response_timeout));
+        }
+        else
+        {
+            return call_immediately(STATE(stream_write_response_timeout));
+        }
+    }
+
+    Action stream_write_response_timeout()
+    {
+        if (responseCode_ & DatagramClient::OPERATION_PENDING)
+        {
+            return handle_stream_write_error(Defs::OPENMRN_TIMEOUT);
+        }
+        size_t len = responsePayload_.size();
+        const uint8_t *bytes =
+            MemoryConfigDefs::payload_bytes(responsePayload_);
+        if (!MemoryConfigDefs::payload_min_length_check(responsePayload_, 1))
+        {
+            LOG(INFO,
+                "Memory Config client: response datagram payload not "
+                "long enough");
+            return handle_stream_write_error(
+                Defs::ERROR_INVALID_ARGS_MESSAGE_TOO_SHORT);
+        }
+        unsigned ofs = MemoryConfigDefs::get_payload_offset(responsePayload_);
+        unsigned address = MemoryConfigDefs::get_address(responsePayload_);
+        uint8_t space = MemoryConfigDefs::get_space(responsePayload_);
+        uint8_t cmd = bytes[1] & MemoryConfigDefs::COMMAND_MASK;
+        if (address != request()->address)
+        {
+            return handle_stream_write_error(Defs::ERROR_OUT_OF_ORDER);
+        }
+        if (space != request()->memory_space)
+        {
+            return handle_stream_write_error(Defs::ERROR_OUT_OF_ORDER);
+        }
+        if (cmd == MemoryConfigDefs::COMMAND_WRITE_STREAM_FAILED)
+        {
+            if (len < ofs + 2)
+            {
+                return handle_stream_write_error(
+                    Defs::ERROR_INVALID_ARGS_MESSAGE_TOO_SHORT);
+            }
+            uint16_t error = bytes[ofs++];
+            error <<= 8;
+            error |= bytes[ofs];
+            return handle_stream_write_error(error);
+        }
+        if (cmd != MemoryConfigDefs::COMMAND_WRITE_STREAM_REPLY)
+        {
+            return handle_stream_write_error(Defs::ERROR_UNIMPLEMENTED);
+        }
+        if (bytes[ofs] != srcStreamId_)
+        {
+            return handle_stream_write_error(Defs::ERROR_OUT_OF_ORDER);
+        }
+        // The destination stream ID is optional in the reply.
+        uint8_t dst_stream_id = StreamDefs::INVALID_STREAM_ID;
+        if (len > ofs + 1)
+        {
+            dst_stream_id = bytes[ofs + 1];
+        }
+        sender_->start_stream(
+            node_, request()->dst, srcStreamId_, dst_stream_id);
+        return call_immediately(STATE(wait_for_stream_started));
+    }
+
+    Action wait_for_stream_started()
+    {
+        auto state = sender_->get_state();
+        if (state == StreamSender::RUNNING)
+        {
+            auto *b = sender_->alloc();
+            // The payload string stays alive until the request is returned,
+            // which happens only after the sender is done with it.
+            b->data()->set_from(
+                request()->payload.data(), request()->payload.size());
+            sender_->send(b);
+            sender_->close_stream();
+            return call_immediately(STATE(wait_for_stream_write_closed));
+        }
+        if (state == StreamSender::STATE_ERROR)
+        {
+            return handle_stream_write_error(sender_->get_error());
+        }
+        return sleep_and_call(
+            &timer_, MSEC_TO_NSEC(3), STATE(wait_for_stream_started));
+    }
+
+    Action wait_for_stream_write_closed()
+    {
+        auto state = sender_->get_state();
+        if (state == StreamSender::CLOSING && sender_->is_waiting())
+        {
+            // Sender is done and empty.
+            release_sender();
+            return finish_write();
+        }
+        if (state == StreamSender::STATE_ERROR && sender_->is_waiting())
+        {
+            return handle_stream_write_error(sender_->get_error());
+        }
+        return sleep_and_call(
+            &timer_, MSEC_TO_NSEC(3), STATE(wait_for_stream_write_closed));
+    }
+
+    /// Called upon various error conditions of a stream write.
+    Action handle_stream_write_error(int error)
+    {
+        release_sender();
+        cleanup_write();
+        return return_with_error(error);
+    }
+
+    /// Returns the stream sender and the source stream ID to the transport.
+    void release_sender()
+    {
+        sender_->clear();
+        stream_transport()->sender_allocator()->typed_insert(sender_);
+        sender_ = nullptr;
+        stream_transport()->release_send_stream_id(srcStreamId_);
+    }
+
+    StreamTransport *stream_transport()
+    {
+        return node_->iface()->stream_transport();
+    }
+
     /// Stores incoming stream data into the request()->payload object
     /// (which is a string).
     struct DefaultSink : public ByteSink
@@ -1019,6 +1229,10 @@ protected:
     uint8_t dstStreamId_;
     /// Holds a ref to the stream receiver request.
     BufferPtr<StreamReceiveRequest> streamRecvRequest_;
+    /// Stream sender used for the write requests.
+    StreamSender *sender_ {nullptr};
+    /// stream ID on the local device for the stream writes.
+    uint8_t srcStreamId_;
 }; // class MemoryConfigClientWithStream
 
 } // namespace openlcb
@@ -37,6 +37,7 @@
 
 #include "openlcb/If.hxx"
 #include "openlcb/MemoryConfig.hxx"
+#include "openlcb/StreamReceiverInterface.hxx"
 #include "openlcb/StreamSender.hxx"
 #include "openlcb/StreamTransport.hxx"
 
@@ -102,10 +103,7 @@ private:
         LOG(INFO, "got sender");
         sender_ =
             full_allocation_result(stream_transport()->sender_allocator());
-        /// @todo the APIs are not on the right object in StreamSender, so we
-        /// have to do this down cast.
-        senderCan_ = static_cast<StreamSenderCan *>(sender_);
-        HASSERT(senderCan_);
+        HASSERT(sender_);
         return call_immediately(STATE(initiate_stream));
     }
 
@@ -113,22 +111,22 @@ private:
     {
         LOG(INFO, "initiate");
         srcStreamId_ = stream_transport()->get_send_stream_id();
-        senderCan_->start_stream(node_, dst_, srcStreamId_, dstStreamId_);
+        sender_->start_stream(node_, dst_, srcStreamId_, dstStreamId_);
         return call_immediately(STATE(wait_for_started));
     }
 
     Action wait_for_started()
     {
-        auto state = senderCan_->get_state();
+        auto state = sender_->get_state();
         if (state == StreamSender::RUNNING)
         {
-            dstStreamId_ = senderCan_->get_dst_stream_id();
+            dstStreamId_ = sender_->get_dst_stream_id();
             startedCb_(0);
             return call_immediately(STATE(alloc_buffer));
         }
         if (state == StreamSender::STATE_ERROR)
         {
-            auto err = senderCan_->get_error();
+            auto err = sender_->get_error();
             LOG(INFO, "failed to start stream: 0x%04x", err);
             startedCb_(err);
             return call_immediately(STATE(done_stream));
@@ -158,7 +156,7 @@ private:
         if (!len_)
         {
             sender_->send(sendBuffer_.release());
-            senderCan_->close_stream();
+            sender_->close_stream();
             return call_immediately(STATE(wait_for_close));
         }
         size_t free = sendBuffer_->data()->free_space();
@@ -185,7 +183,7 @@ private:
         if (err == MemoryConfigDefs::ERROR_OUT_OF_BOUNDS)
         {
             sender_->send(sendBuffer_.release());
-            senderCan_->close_stream();
+            sender_->close_stream();
             return call_immediately(STATE(wait_for_close));
         }
         if (!err)
@@ -196,24 +194,24 @@ private:
         {
             LOG(INFO, "error reading input stream: %04x", err);
             sender_->send(sendBuffer_.release());
-            senderCan_->close_stream(err);
+            sender_->close_stream(err);
             return call_immediately(STATE(wait_for_close));
         }
     }
 
     Action wait_for_close()
     {
-        auto state = senderCan_->get_state();
-        if (state == StreamSender::CLOSING && senderCan_->is_waiting())
+        auto state = sender_->get_state();
+        if (state == StreamSender::CLOSING && sender_->is_waiting())
         {
             // Sender is done and empty.
             return call_immediately(STATE(done_stream));
         }
-        if (state == StreamSender::STATE_ERROR && senderCan_->is_waiting())
+        if (state == StreamSender::STATE_ERROR && sender_->is_waiting())
         {
             // Sender has errored and consumed / thrown away all data.
             // There is no place really to show the error.
-            LOG(INFO, "Stream sender error: 0x%04x", senderCan_->get_error());
+            LOG(INFO, "Stream sender error: 0x%04x", sender_->get_error());
             return call_immediately(STATE(done_stream));
         }
         return sleep_and_call(&timer_, MSEC_TO_NSEC(3), STATE(wait_for_close));
@@ -221,7 +219,7 @@ private:
 
     Action done_stream()
     {
-        senderCan_->clear();
+        sender_->clear();
         stream_transport()->sender_allocator()->typed_insert(sender_);
         sender_ = nullptr;
         return delete_this();
@@ -258,10 +256,193 @@ private:
     /// How many bytes are left to read. 0xFFFFFFFF if all bytes until EOF need
     /// to be read.
     uint32_t len_;
+    /// Stream sender flow, allocated from the interface's stream transport.
+    StreamSender *sender_;
+};
+
+/// Receives a stream and writes it into a memory space. This object is owned
+/// by the MemoryConfigStreamHandler and serves one stream at a time. The
+/// memory space provides the flow control: while write() returns ERROR_AGAIN,
+/// the incoming data stays queued here, which holds back the stream receiver
+/// from granting more window to the sender.
+class MemorySpaceStreamWriteFlow : public StateFlow<ByteBuffer, QList<1>>
+{
+public:
+    /// Constructor.
     ///
+    /// @param iface interface on which the streams will arrive. Must have
+    /// stream support.
+    MemorySpaceStreamWriteFlow(If *iface)
+        : StateFlow<ByteBuffer, QList<1>>(iface)
+        , localStreamId_(
+              iface->stream_transport()->get_next_stream_receive_id())
+        , receiver_(iface->stream_transport()->create_receiver(localStreamId_))
+        , isBusy_(0)
+        , streamDone_(0)
+    { }
+
+    /// @return true if a stream write is in progress.
+    bool is_busy()
+    {
+        return isBusy_;
+    }
+
+    /// @return true if the remote node did not send any data for a long
+    /// time, either because it never opened the announced stream, or because
+    /// it went away in the middle of it.
+    bool is_stale()
+    {
+        return isBusy_ &&
+            (os_get_time_monotonic() - lastActivity_ >
+                SEC_TO_NSEC(STREAM_INACTIVITY_TIMEOUT_SEC));
+    }
+
+    /// Gives up waiting for the current stream.
+    void cancel()
+    {
+        receiver_->cancel_request();
+    }
+
+    /// Starts receiving a stream into a memory space. May be called only when
+    /// is_busy() returns false.
     ///
-    StreamSenderCan *senderCan_;
-    StreamSender *sender_;
+    /// @param node local node that the stream is addressed to.
+    /// @param space memory space to write.
+    /// @param src remote node that will send the stream.
+    /// @param src_stream_id stream ID on the remote node.
+    /// @param ofs address in the memory space of the first byte to write.
+    void start(Node *node, MemorySpace *space, NodeHandle src,
+        uint8_t src_stream_id, uint32_t ofs)
+    {
+        HASSERT(!isBusy_);
+        isBusy_ = 1;
+        streamDone_ = 0;
+        lastActivity_ = os_get_time_monotonic();
+        space_ = space;
+        ofs_ = ofs;
+        errorCode_ = 0;
+        receiver_->pool()->alloc(&recvRequest_);
+        recvRequest_->data()->reset(
+            this, node, src, src_stream_id, localStreamId_);
+        recvRequest_->data()->done.reset(&doneNotifiable_);
+        receiver_->send(recvRequest_->ref());
+    }
+
+    /// @return the stream ID on the local node.
+    uint8_t get_dst_stream_id()
+    {
+        return localStreamId_;
+    }
+
+private:
+    /// Called for every chunk of the stream, and once more with an empty
+    /// chunk after the stream is closed.
+    Action entry() override
+    {
+        if (streamDone_ && !message()->data()->size())
+        {
+            return call_immediately(STATE(stream_complete));
+        }
+        lastActivity_ = os_get_time_monotonic();
+        return call_immediately(STATE(try_write));
+    }
+
+    Action try_write()
+    {
+        size_t len = message()->data()->size();
+        if (!len || errorCode_)
+        {
+            // Done with this chunk, or dropping the data after an error.
+            return release_and_exit();
+        }
+        MemorySpace::errorcode_t err = 0;
+        size_t written =
+            space_->write(ofs_, message()->data()->data_, len, &err, this);
+        message()->data()->advance(written);
+        ofs_ += written;
+        if (written)
+        {
+            // A slow memory space holds back the sender; that is not
+            // inactivity.
+            lastActivity_ = os_get_time_monotonic();
+        }
+        if (err == MemorySpace::ERROR_AGAIN)
+        {
+            return wait();
+        }
+        if (err)
+        {
+            LOG(INFO, "error writing stream to memory space: %04x", err);
+            errorCode_ = err;
+        }
+        return again();
+    }
+
+    /// Called after the last chunk was written.
+    Action stream_complete()
+    {
+        if (recvRequest_->data()->resultCode)
+        {
+            LOG(INFO, "stream write ended with error %04x",
+                (unsigned)recvRequest_->data()->resultCode);
+        }
+        recvRequest_.reset();
+        isBusy_ = 0;
+        return release_and_exit();
+    }
+
+    /// Invoked by the stream receiver when the stream is closed. The data
+    /// chunks are already queued in this flow, so we add an empty chunk at
+    /// the end to find out when they are all written.
+    void stream_done()
+    {
+        streamDone_ = 1;
+        auto *b = alloc();
+        b->data()->size_ = 0;
+        send(b);
+    }
+
+    /// Notifiable to get the completion of the stream receive request.
+    class DoneNotifiable : public Notifiable
+    {
+    public:
+        DoneNotifiable(MemorySpaceStreamWriteFlow *parent)
+            : parent_(parent)
+        { }
+
+        void notify() override
+        {
+            parent_->stream_done();
+        }
+
+    private:
+        MemorySpaceStreamWriteFlow *parent_;
+    } doneNotifiable_ {this};
+
+    /// After how many seconds without data (counted from the write stream
+    /// reply, or the last data chunk) the stream is considered abandoned.
+    static constexpr unsigned STREAM_INACTIVITY_TIMEOUT_SEC = 20;
+
+    /// Stream ID on the local node, assigned to our stream receiver.
+    uint8_t localStreamId_;
+    /// Stream receiver for the incoming data.
+    std::unique_ptr<StreamReceiverInterface> receiver_;
+    /// Request object sent to the stream receiver.
+    BufferPtr<StreamReceiveRequest> recvRequest_;
+    /// Memory space we are writing.
+    MemorySpace *space_ {nullptr};
+    /// When the current stream write was started, or the last data arrived or
+    /// was written to the memory space.
+    long long lastActivity_ {0};
+    /// Next byte to write.
+    uint32_t ofs_ {0};
+    /// Error from the memory space. After an error the rest of the stream is
+    /// thrown away.
+    uint16_t errorCode_ {0};
+    /// 1 while a stream is being received.
+    uint8_t isBusy_ : 1;
+    /// 1 if the stream receiver is done with the stream.
+    uint8_t streamDone_ : 1;
 };
 
 /// Handler for the stream read/write commands in the memory config protocol
@@ -291,7 +472,10 @@ public:
             {
                 return call_immediately(STATE(handle_read_stream));
             }
-                /// @todo handle write stream
+            case MemoryConfigDefs::COMMAND_WRITE_STREAM:
+            {
+                return call_immediately(STATE(handle_write_stream));
+            }
         }
         return respond_reject(Defs::ERROR_UNIMPLEMENTED_SUBCMD);
     }
@@ -386,6 +570,60 @@ private:
         return respond_ok(DatagramClient::REPLY_PENDING);
     }
 
+    Action handle_write_stream()
+    {
+        size_t len = message()->data()->payload.size();
+        const uint8_t *bytes = in_bytes();
+
+        size_t stream_data_offset = 6;
+        if (has_custom_space())
+        {
+            ++stream_data_offset;
+        }
+        if (len < stream_data_offset + 1)
+        {
+            return respond_reject(Defs::ERROR_INVALID_ARGS);
+        }
+        MemorySpace *space = get_space();
+        if (!space)
+        {
+            return respond_reject(MemoryConfigDefs::ERROR_SPACE_NOT_KNOWN);
+        }
+        if (space->read_only())
+        {
+            return respond_reject(MemoryConfigDefs::ERROR_WRITE_TO_RO);
+        }
+        if (!writeFlow_)
+        {
+            writeFlow_.reset(
+                new MemorySpaceStreamWriteFlow(message()->data()->dst->iface()));
+        }
+        if (writeFlow_->is_busy())
+        {
+            if (writeFlow_->is_stale())
+            {
+                // The remote node never opened the stream, or stopped
+                // sending. The next try will succeed.
+                writeFlow_->cancel();
+            }
+            return respond_reject(DatagramDefs::BUFFER_UNAVAILABLE);
+        }
+
+        uint8_t src_stream_id = bytes[stream_data_offset];
+        writeFlow_->start(message()->data()->dst, space, message()->data()->src,
+            src_stream_id, get_address());
+
+        response_.resize(stream_data_offset + 2);
+        uint8_t *response_bytes = out_bytes();
+        response_bytes[0] = DATAGRAM_ID;
+        response_bytes[1] = MemoryConfigDefs::COMMAND_WRITE_STREAM_REPLY;
+        set_address_and_space();
+        response_bytes[stream_data_offset] = src_stream_id;
+        response_bytes[stream_data_offset + 1] =
+            writeFlow_->get_dst_stream_id();
+        return respond_ok(DatagramClient::REPLY_PENDING);
+    }
+
     /** Looks up the memory space for the current datagram. Returns NULL if no
      * space was registered (for neither the current node, nor global). */
     MemorySpace *get_space()
@@ -425,12 +663,13 @@ private:
     /// OpenLCB error code from the stream start.
     uint16_t streamErrorCode_;
 
-    union
-    {
-        /// The flow that we created for reading the memory space into the
-        /// stream.
-        MemorySpaceStreamReadFlow *readFlow_;
-    };
+    /// The flow that we created for reading the memory space into the
+    /// stream.
+    MemorySpaceStreamReadFlow *readFlow_;
+
+    /// Receives the streams of write requests. Created upon the first write
+    /// request.
+    std::unique_ptr<MemorySpaceStreamWriteFlow> writeFlow_;
 }; // class MemoryConfigStreamHandler
 
 } // namespace openlcb
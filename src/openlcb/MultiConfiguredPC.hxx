@@ -36,6 +36,8 @@
 #ifndef _OPENLCB_MULTICONFIGUREDPC_HXX_
 #define _OPENLCB_MULTICONFIGUREDPC_HXX_
 
+#include <vector>
+
 #include "openlcb/ConfigRepresentation.hxx"
 #include "openlcb/EventHandlerTemplates.hxx"
 #include "openlcb/RefreshLoop.hxx"
@@ -214,15 +216,17 @@ public:
             do_unregister();
         }
         RepeatedGroup<config_entry_type, UINT_MAX> grp_ref(offset_.offset());
+        // All events are registered in one batch at the end.
+        std::vector<EventRegistryEntry> entries;
+        entries.reserve(size_ * 2);
         for (unsigned i = 0; i < size_; ++i)
         {
             const config_entry_type cfg_ref(grp_ref.entry(i));
             EventId cfg_event_on = cfg_ref.pc().event_on().read(fd);
             EventId cfg_event_off = cfg_ref.pc().event_off().read(fd);
-            EventRegistry::instance()->register_handler(
-                EventRegistryEntry(this, cfg_event_off, i * 2), 0);
-            EventRegistry::instance()->register_handler(
-                EventRegistryEntry(this, cfg_event_on, i * 2 + 1), 0);
+            entries.push_back(EventRegistryEntry(this, cfg_event_off, i * 2));
+            entries.push_back(
+                EventRegistryEntry(this, cfg_event_on, i * 2 + 1));
             uint8_t action = cfg_ref.action().read(fd);
             if (action == (uint8_t)PCConfig::ActionConfig::DOUTPUT)
             {
@@ -240,6 +244,8 @@ public:
                 producedEvents_[i * 2 + 1] = cfg_event_on;
             }
         }
+        EventRegistry::instance()->register_handlers(
+            entries.data(), entries.size(), 0);
         return REINIT_NEEDED; // Causes events identify.
     }
 
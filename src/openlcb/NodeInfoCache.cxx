@@ -0,0 +1,296 @@
+/** \copyright
+ * Copyright (c) 2026, Balazs Racz
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are  permitted provided that the following conditions are met:
+ *
+ *  - Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  - Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file NodeInfoCache.cxx
+ * Shared cache of the SNIP and PIP information of remote nodes.
+ *
+ * @author Balazs Racz
+ * @date 17 Oct 2026
+ */
+
+#include "openlcb/NodeInfoCache.hxx"
+
+#include "openlcb/PIPClient.hxx"
+#include "openlcb/SNIPClient.hxx"
+
+namespace openlcb
+{
+
+/// Queries the SNIP and PIP of one node at a time from the cache's pending
+/// queue, until the queue is empty.
+class NodeInfoCache::Fetcher : public StateFlowBase
+{
+public:
+    /// @param parent the cache that owns this fetcher.
+    Fetcher(NodeInfoCache *parent)
+        : StateFlowBase(parent->node_->iface())
+        , parent_(parent)
+        , snipClient_(parent->node_->iface())
+        , pipClient_(parent->node_->iface())
+    {
+    }
+
+    /// Starts working on the pending queue.
+    void start()
+    {
+        start_flow(STATE(next_node));
+    }
+
+private:
+    friend class NodeInfoCache;
+
+    Action next_node()
+    {
+        if (parent_->pending_.empty())
+        {
+            parent_->idle_.push_back(this);
+            return exit();
+        }
+        NodeInfo *info = &parent_->nodes_[parent_->pending_.front()];
+        parent_->pending_.pop_front();
+        dst_ = info->handle_;
+        generation_ = info->generation_;
+        ++parent_->numRequests_;
+        return invoke_subflow_and_wait(
+            &snipClient_, STATE(snip_done), parent_->node_, dst_);
+    }
+
+    Action snip_done()
+    {
+        auto b = get_buffer_deleter(full_allocation_result(&snipClient_));
+        snipResult_ = b->data()->resultCode;
+        snip_ = std::move(b->data()->response);
+        ++parent_->numRequests_;
+        pipClient_.request(dst_, parent_->node_, this);
+        return wait_and_call(STATE(pip_done));
+    }
+
+    Action pip_done()
+    {
+        parent_->fetch_done(this);
+        return call_immediately(STATE(next_node));
+    }
+
+    /// Cache that owns this fetcher.
+    NodeInfoCache *parent_;
+    /// Node being queried.
+    NodeHandle dst_;
+    /// Generation of the cache entry when the fetch started.
+    uint8_t generation_;
+    /// Result code of the SNIP request.
+    int snipResult_;
+    /// Response of the SNIP request.
+    string snip_;
+    /// Client for the SNIP request.
+    SNIPClient snipClient_;
+    /// Client for the PIP request.
+    PIPClient pipClient_;
+};
+
+NodeInfoCache::NodeInfoCache(Node *node, unsigned max_in_flight, bool prefetch)
+    : node_(node)
+    , prefetch_(prefetch)
+{
+    for (unsigned i = 0; i < max_in_flight; ++i)
+    {
+        fetchers_.emplace_back(new Fetcher(this));
+        idle_.push_back(fetchers_.back().get());
+    }
+    node_->iface()->dispatcher()->register_handler(
+        &handler_, Defs::MTI_VERIFIED_NODE_ID_NUMBER, Defs::MTI_EXACT);
+    node_->iface()->dispatcher()->register_handler(
+        &handler_, Defs::MTI_INITIALIZATION_COMPLETE, Defs::MTI_EXACT);
+}
+
+NodeInfoCache::~NodeInfoCache()
+{
+    node_->iface()->dispatcher()->unregister_handler_all(&handler_);
+}
+
+const NodeInfoCache::NodeInfo *NodeInfoCache::lookup(NodeID id)
+{
+    auto it = nodes_.find(id);
+    if (it == nodes_.end() || !it->second.complete())
+    {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+void NodeInfoCache::fetch(NodeHandle h, Notifiable *done)
+{
+    HASSERT(h.id);
+    NodeInfo *info = &nodes_[h.id];
+    info->handle_.id = h.id;
+    if (h.alias)
+    {
+        info->handle_.alias = h.alias;
+    }
+    if (info->complete() &&
+        !(info->flags_ & (NodeInfo::SNIP_RETRY | NodeInfo::PIP_RETRY)))
+    {
+        ++numHits_;
+        done->notify();
+        return;
+    }
+    info->waiters_.push_back(done);
+    enqueue(info);
+}
+
+void NodeInfoCache::invalidate(NodeID id)
+{
+    auto it = nodes_.find(id);
+    if (it == nodes_.end())
+    {
+        return;
+    }
+    NodeInfo *info = &it->second;
+    info->flags_ &= NodeInfo::FETCH_PENDING;
+    info->snip_.clear();
+    info->snip_.shrink_to_fit();
+    info->pip_ = 0;
+    ++info->generation_;
+}
+
+void NodeInfoCache::refresh()
+{
+    auto b = node_->iface()->global_message_write_flow()->alloc();
+    b->data()->reset(
+        Defs::MTI_VERIFY_NODE_ID_GLOBAL, node_->node_id(), EMPTY_PAYLOAD);
+    node_->iface()->global_message_write_flow()->send(b);
+}
+
+void NodeInfoCache::enqueue(NodeInfo *info)
+{
+    if (info->flags_ & NodeInfo::FETCH_PENDING)
+    {
+        return;
+    }
+    info->flags_ |= NodeInfo::FETCH_PENDING;
+    pending_.push_back(info->handle_.id);
+    if (!idle_.empty())
+    {
+        Fetcher *f = idle_.back();
+        idle_.pop_back();
+        f->start();
+    }
+}
+
+void NodeInfoCache::fetch_done(Fetcher *f)
+{
+    NodeInfo *info = &nodes_[f->dst_.id];
+    if (info->generation_ != f->generation_)
+    {
+        // The node has reinitialized while we were talking to it. The
+        // answers might be stale; asks again.
+        pending_.push_back(f->dst_.id);
+        return;
+    }
+    info->flags_ &= ~NodeInfo::FETCH_PENDING;
+    // A failed retry keeps the data from an earlier successful fetch.
+    if (f->snipResult_ == 0)
+    {
+        info->snip_ = std::move(f->snip_);
+        info->flags_ &= ~(NodeInfo::SNIP_FAILED | NodeInfo::SNIP_RETRY);
+        info->flags_ |= NodeInfo::SNIP_VALID;
+    }
+    else if (!(info->flags_ & NodeInfo::SNIP_VALID))
+    {
+        set_failed(info, f->snipResult_, NodeInfo::SNIP_FAILED,
+            NodeInfo::SNIP_RETRY);
+    }
+    uint32_t pip_result = f->pipClient_.error_code();
+    if (pip_result == PIPClient::OPERATION_SUCCESS)
+    {
+        info->pip_ = f->pipClient_.response();
+        info->flags_ &= ~(NodeInfo::PIP_FAILED | NodeInfo::PIP_RETRY);
+        info->flags_ |= NodeInfo::PIP_VALID;
+    }
+    else if (!(info->flags_ & NodeInfo::PIP_VALID))
+    {
+        set_failed(info, pip_result, NodeInfo::PIP_FAILED,
+            NodeInfo::PIP_RETRY);
+    }
+    std::vector<Notifiable *> waiters;
+    waiters.swap(info->waiters_);
+    for (Notifiable *n : waiters)
+    {
+        n->notify();
+    }
+}
+
+void NodeInfoCache::set_failed(
+    NodeInfo *info, uint32_t result, uint8_t failed, uint8_t retry)
+{
+    info->flags_ |= failed;
+    // A node that does not implement the protocol keeps rejecting it, so
+    // only timeouts and temporary errors are worth asking again.
+    if ((result & Defs::ERROR_PERMANENT) && !(result & Defs::ERROR_TEMPORARY))
+    {
+        info->flags_ &= ~retry;
+    }
+    else
+    {
+        info->flags_ |= retry;
+    }
+}
+
+void NodeInfoCache::handle_node(GenMessage *msg)
+{
+    if (msg->payload.size() != 6)
+    {
+        return;
+    }
+    NodeID id = buffer_to_node_id(msg->payload);
+    bool is_new = nodes_.find(id) == nodes_.end();
+    NodeInfo *info = &nodes_[id];
+    info->handle_.id = id;
+    if (msg->src.alias)
+    {
+        info->handle_.alias = msg->src.alias;
+    }
+    if (msg->mti == Defs::MTI_INITIALIZATION_COMPLETE && !is_new)
+    {
+        // The node has restarted, maybe with a different configuration.
+        invalidate(id);
+        if (!info->waiters_.empty())
+        {
+            enqueue(info);
+        }
+    }
+    if (prefetch_ && !info->complete())
+    {
+        enqueue(info);
+    }
+}
+
+void NodeInfoCache::NodeHandler::send(Buffer<GenMessage> *b, unsigned)
+{
+    auto d = get_buffer_deleter(b);
+    parent_->handle_node(b->data());
+}
+
+} // namespace openlcb
@@ -0,0 +1,235 @@
+/** \copyright
+ * Copyright (c) 2026, Balazs Racz
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are  permitted provided that the following conditions are met:
+ *
+ *  - Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  - Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file NodeInfoCache.hxx
+ * Shared cache of the SNIP and PIP information of remote nodes.
+ *
+ * @author Balazs Racz
+ * @date 17 Oct 2026
+ */
+
+#ifndef _OPENLCB_NODEINFOCACHE_HXX_
+#define _OPENLCB_NODEINFOCACHE_HXX_
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "openlcb/If.hxx"
+
+namespace openlcb
+{
+
+/// Caches the Simple Node Information (SNIP) and Protocol Identification
+/// (PIP) responses of remote nodes, so that all panels, throttles and
+/// configuration tools in the same process share one copy of the data instead
+/// of querying the bus again.
+///
+/// The cache listens to Verified Node ID and Initialization Complete messages
+/// to learn the nodes on the network. When a node sends Initialization
+/// Complete, its cached data is discarded. The data is fetched lazily, upon
+/// the first request for a node, or with prefetch enabled for every node that
+/// shows up on the network. At most max_in_flight nodes are being queried at
+/// any time.
+///
+/// All functions must be called on the interface's executor. The cache must
+/// not be destroyed while fetches are outstanding.
+class NodeInfoCache
+{
+public:
+    /// Information known about one remote node.
+    struct NodeInfo
+    {
+        /// Bits for flags_.
+        enum Flags : uint8_t
+        {
+            /// snip_ contains the node's SNIP response.
+            SNIP_VALID = 1,
+            /// pip_ contains the node's protocol support bits.
+            PIP_VALID = 2,
+            /// The SNIP request was rejected or timed out.
+            SNIP_FAILED = 4,
+            /// The PIP request was rejected or timed out.
+            PIP_FAILED = 8,
+            /// A fetch is queued or running for this node.
+            FETCH_PENDING = 16,
+            /// The SNIP request timed out or was rejected with a temporary
+            /// error. The next fetch() asks again.
+            SNIP_RETRY = 32,
+            /// The PIP request timed out or was rejected with a temporary
+            /// error. The next fetch() asks again.
+            PIP_RETRY = 64,
+        };
+
+        /// @return true if both SNIP and PIP have been fetched (successfully
+        /// or not).
+        bool complete() const
+        {
+            return (flags_ & (SNIP_VALID | SNIP_FAILED)) &&
+                (flags_ & (PIP_VALID | PIP_FAILED));
+        }
+
+        /// Node ID and last known alias of the node.
+        NodeHandle handle_;
+        /// Raw payload of the SNIP response.
+        string snip_;
+        /// Protocol support bits from the PIP response.
+        uint64_t pip_ {0};
+        /// Bitmask of Flags.
+        uint8_t flags_ {0};
+        /// Incremented when the node reinitializes. A fetch that was started
+        /// for an older generation is discarded and retried.
+        uint8_t generation_ {0};
+        /// Notified when the pending fetch completes.
+        std::vector<Notifiable *> waiters_;
+    };
+
+    /// Constructor.
+    /// @param node local node from which to send the queries
+    /// @param max_in_flight how many nodes to query at the same time.
+    /// @param prefetch if true, fetches the information of every node that
+    /// shows up on the network, instead of waiting for the first request.
+    NodeInfoCache(Node *node, unsigned max_in_flight = 4, bool prefetch = false);
+
+    /// Destructor.
+    ~NodeInfoCache();
+
+    /// Looks up a node in the cache. Does not generate network traffic.
+    /// @param id node ID of the remote node
+    /// @return the cached information, or nullptr if it is not complete
+    /// yet. The contents change when the node reinitializes.
+    const NodeInfo *lookup(NodeID id);
+
+    /// Requests the information of a remote node. If the information is
+    /// cached, done is notified inline. Otherwise a fetch is started (or an
+    /// already pending fetch for the same node is joined) and done is
+    /// notified when it completes. The caller then calls lookup() and checks
+    /// the flags for failures. Permanent rejections are cached like
+    /// responses; a node whose SNIP or PIP request timed out or failed with a
+    /// temporary error is queried again by the next fetch().
+    /// @param h remote node. The node ID must be set; the alias is filled in
+    /// from the cache if missing.
+    /// @param done notified when the information is available.
+    void fetch(NodeHandle h, Notifiable *done);
+
+    /// Discards the cached information of a node. The next fetch will query
+    /// the network again.
+    /// @param id node ID of the remote node.
+    void invalidate(NodeID id);
+
+    /// Sends a global Verify Node ID message, which makes every node on the
+    /// network known to the cache. With prefetch enabled this fills the cache
+    /// for the whole network.
+    void refresh();
+
+    /// @return the number of remote nodes known.
+    size_t size()
+    {
+        return nodes_.size();
+    }
+
+    /// @return how many SNIP and PIP requests were sent to the network.
+    unsigned num_requests()
+    {
+        return numRequests_;
+    }
+
+    /// @return how many fetch() calls were served from the cache.
+    unsigned num_hits()
+    {
+        return numHits_;
+    }
+
+private:
+    class Fetcher;
+    friend class Fetcher;
+
+    /// Helper class to register in the dispatcher. Incoming Verified Node ID
+    /// and Initialization Complete messages are routed to this object.
+    class NodeHandler : public MessageHandler
+    {
+    public:
+        /// @param parent is the NodeInfoCache that owns *this
+        NodeHandler(NodeInfoCache *parent)
+            : parent_(parent)
+        {
+        }
+
+        /// @param b incoming message
+        void send(Buffer<GenMessage> *b, unsigned) override;
+
+    private:
+        /// NodeInfoCache that owns *this.
+        NodeInfoCache *parent_;
+    };
+    friend class NodeHandler;
+
+    /// Handles an incoming Verified Node ID or Initialization Complete
+    /// message.
+    /// @param msg incoming message.
+    void handle_node(GenMessage *msg);
+
+    /// Queues a fetch for a node, unless one is already pending.
+    /// @param info cache entry of the node.
+    void enqueue(NodeInfo *info);
+
+    /// Called by a fetcher when the queries for a node are complete.
+    /// @param f the fetcher whose results to store.
+    void fetch_done(Fetcher *f);
+
+    /// Records a failed SNIP or PIP request in a cache entry.
+    /// @param info cache entry of the node.
+    /// @param result error code of the request.
+    /// @param failed SNIP_FAILED or PIP_FAILED.
+    /// @param retry SNIP_RETRY or PIP_RETRY.
+    static void set_failed(
+        NodeInfo *info, uint32_t result, uint8_t failed, uint8_t retry);
+
+    /// Local node to send queries from.
+    Node *node_;
+    /// Registered in the interface's dispatcher.
+    NodeHandler handler_ {this};
+    /// All known remote nodes.
+    std::map<NodeID, NodeInfo> nodes_;
+    /// Nodes waiting for a fetcher.
+    std::deque<NodeID> pending_;
+    /// Owns the fetchers; their count bounds the number of nodes queried at
+    /// the same time.
+    std::vector<std::unique_ptr<Fetcher>> fetchers_;
+    /// Fetchers that are not running.
+    std::vector<Fetcher *> idle_;
+    /// Number of SNIP and PIP requests sent.
+    unsigned numRequests_ {0};
+    /// Number of fetch() calls served from the cache.
+    unsigned numHits_ {0};
+    /// True if every new node has to be fetched.
+    bool prefetch_;
+};
+
+} // namespace openlcb
+
+#endif // _OPENLCB_NODEINFOCACHE_HXX_
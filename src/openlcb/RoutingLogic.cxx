@@ -60,4 +60,67 @@ uint8_t event_range_to_bit_count(EventId* event) {
     return ret;
 }
 
+void EventPortTable::add(EventId event, PortMask ports)
+{
+    HASSERT(ports);
+    // Keeps the load factor at or below 1/2.
+    if ((count_ + 1) * 2 > entries_.size())
+    {
+        rehash(entries_.empty() ? 16 : entries_.size() * 2);
+    }
+    size_t mask = entries_.size() - 1;
+    for (size_t i = hash(event) & mask;; i = (i + 1) & mask)
+    {
+        Entry &e = entries_[i];
+        if (!e.ports_)
+        {
+            e.event_ = event;
+            e.ports_ = ports;
+            ++count_;
+            return;
+        }
+        if (e.event_ == event)
+        {
+            e.ports_ |= ports;
+            return;
+        }
+    }
+}
+
+void EventPortTable::remove_ports(PortMask ports)
+{
+    bool need_rehash = false;
+    for (Entry &e : entries_)
+    {
+        if (e.ports_ & ports)
+        {
+            e.ports_ &= ~ports;
+            if (!e.ports_)
+            {
+                --count_;
+                need_rehash = true;
+            }
+        }
+    }
+    if (need_rehash)
+    {
+        // Freed slots may have broken probe sequences.
+        rehash(entries_.size());
+    }
+}
+
+void EventPortTable::rehash(size_t size)
+{
+    std::vector<Entry> old(size, Entry {0, 0});
+    old.swap(entries_);
+    count_ = 0;
+    for (const Entry &e : old)
+    {
+        if (e.ports_)
+        {
+            add(e.event_, e.ports_);
+        }
+    }
+}
+
 } // namespace openlcb
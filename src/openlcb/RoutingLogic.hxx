@@ -36,9 +36,11 @@
 #ifndef _OPENLCB_ROUTNGLOGIC_HXX_
 #define _OPENLCB_ROUTNGLOGIC_HXX_
 
+#include <algorithm>
 #include <set>
 #include <map>
 #include <unordered_map>
+#include <vector>
 
 #include "os/OS.hxx"
 #include "openlcb/EventHandler.hxx"
@@ -57,6 +59,102 @@ namespace openlcb
  */
 uint8_t event_range_to_bit_count(EventId *event);
 
+/** Open addressing hash table that maps event IDs to a set of ports, the set
+ * being represented as a bitmask of port indexes. Uses linear probing. There
+ * is no deletion of individual entries; removing ports rebuilds the table.
+ *
+ * This class is thread-compatible.
+ */
+class EventPortTable
+{
+public:
+    /// Bitmask of port indexes.
+    typedef uint64_t PortMask;
+
+    EventPortTable()
+    {
+    }
+
+    /** Adds ports to the set stored for an event.
+     *
+     * @param event is the key.
+     * @param ports is a non-empty set of ports that will be added to the
+     * entry for event. */
+    void add(EventId event, PortMask ports);
+
+    /** Looks up the set of ports for an event.
+     *
+     * @param event is the key.
+     * @return the set of ports stored for this event, 0 if there is no entry.
+     */
+    PortMask lookup(EventId event) const
+    {
+        if (!count_)
+        {
+            return 0;
+        }
+        size_t mask = entries_.size() - 1;
+        for (size_t i = hash(event) & mask;; i = (i + 1) & mask)
+        {
+            const Entry &e = entries_[i];
+            if (!e.ports_)
+            {
+                return 0;
+            }
+            if (e.event_ == event)
+            {
+                return e.ports_;
+            }
+        }
+    }
+
+    /** Removes a set of ports from every entry. Entries that become empty are
+     * dropped from the table.
+     *
+     * @param ports is the set of ports to remove. */
+    void remove_ports(PortMask ports);
+
+    /// @return the number of events stored.
+    size_t size() const
+    {
+        return count_;
+    }
+
+private:
+    /// One slot in the hash table.
+    struct Entry
+    {
+        /// Key.
+        EventId event_;
+        /// Value. 0 means the slot is free.
+        PortMask ports_;
+    };
+
+    /// @param event is the key.
+    /// @return the hash code for the key.
+    static size_t hash(EventId event)
+    {
+        // Finalizer of MurmurHash3. Event IDs are highly structured (common
+        // node ID prefix, sequential suffix), so we need good mixing.
+        event ^= event >> 33;
+        event *= UINT64_C(0xff51afd7ed558ccd);
+        event ^= event >> 33;
+        event *= UINT64_C(0xc4ceb9fe1a85ec53);
+        event ^= event >> 33;
+        return (size_t)event;
+    }
+
+    /// Resizes the table to a given number of slots and re-inserts all
+    /// entries.
+    /// @param size new number of slots, must be a power of two.
+    void rehash(size_t size);
+
+    /// Slots of the hash table. Size is zero or a power of two.
+    std::vector<Entry> entries_;
+    /// Number of used slots.
+    size_t count_ {0};
+};
+
 /** Routing table for gateways and routers in OpenLCB.
  *
  * The routing table contains which direction to send addressed packets as well
@@ -233,6 +331,344 @@ private:
     std::map<Port *, EventSet> eventRoutingTable_;
 };
 
+/** Alternative implementation of the routing table for gateways and routers
+ * with many ports and many events. The API is the same as RoutingLogic, with
+ * an additional call that returns the set of all ports that are interested in
+ * an event with one lookup.
+ *
+ * Individual events are stored in a hash table mapping the event ID to a
+ * bitmask of ports, thus an exact match costs one hash lookup, independent of
+ * the number of events and ports. Event ranges are stored in a separate hash
+ * table per range size (number of mask bits); an event report costs one
+ * lookup for every distinct range size that is in use (typically only a
+ * few).
+ *
+ * The first MAX_PORTS - 1 ports get their own bit in the port masks. Ports
+ * registered beyond that all share the bit OVERFLOW_INDEX and get every event
+ * without filtering; see overflow_ports(). Ports that are removed free up
+ * their index for reuse by ports registered later.
+ */
+template <class Port, typename Address> class HashRoutingLogic
+{
+public:
+    /// Bitmask of port indexes. Bit i refers to port_for_index(i).
+    typedef EventPortTable::PortMask PortMask;
+
+    /// Number of bits in a port mask.
+    static constexpr unsigned MAX_PORTS = sizeof(PortMask) * 8;
+
+    /// Bit that stands for all ports that did not get their own bit.
+    static constexpr unsigned OVERFLOW_INDEX = MAX_PORTS - 1;
+
+    HashRoutingLogic()
+    {
+    }
+    ~HashRoutingLogic()
+    {
+    }
+
+    /** Clears all entries in the routing table related to a given port, as the
+     * given port is being removed.
+     *
+     * @param port describes the target port to be removed.
+     */
+    void remove_port(Port *port)
+    {
+        remove_ports(&port, 1);
+    }
+
+    /** Clears all entries in the routing table related to a set of ports.
+     * The event tables are rebuilt only once, so this is cheaper than calling
+     * remove_port() for each port.
+     *
+     * @param ports is an array of the ports to be removed.
+     * @param count is the number of entries in ports.
+     */
+    void remove_ports(Port *const *ports, size_t count)
+    {
+        OSMutexLock l(&lock_);
+        std::set<Port *> removed(ports, ports + count);
+        for (auto &it : addressRoutingTable_)
+        {
+            if (removed.count(it.second))
+            {
+                it.second = nullptr;
+            }
+        }
+        PortMask bits = 0;
+        for (Port *port : removed)
+        {
+            auto it = portIndex_.find(port);
+            if (it != portIndex_.end())
+            {
+                bits |= PortMask(1) << it->second;
+                ports_[it->second] = nullptr;
+                portIndex_.erase(it);
+                continue;
+            }
+            auto oit =
+                std::find(overflowPorts_.begin(), overflowPorts_.end(), port);
+            if (oit != overflowPorts_.end())
+            {
+                overflowPorts_.erase(oit);
+            }
+        }
+        if (!bits)
+        {
+            return;
+        }
+        allRangePorts_ &= ~bits;
+        exactTable_.remove_ports(bits);
+        for (auto rit = rangeTables_.begin(); rit != rangeTables_.end();)
+        {
+            rit->table_.remove_ports(bits);
+            if (rit->table_.size() == 0)
+            {
+                rit = rangeTables_.erase(rit);
+            }
+            else
+            {
+                ++rit;
+            }
+        }
+    }
+
+    /** Declares that a given node ID is reachable via a specific port. Used
+     * with the source node IDs of all the incoming packets.
+     *
+     * @param port is where the incoming packet came from (i.e. the port on
+     * which source is reachable.
+     * @param source is the node handle where the packet came from.
+     */
+    void add_node_id_to_route(Port *port, Address source)
+    {
+        OSMutexLock l(&lock_);
+        addressRoutingTable_[source] = port;
+    }
+
+    /** Looks up which port an addressed packet should be sent to.
+     *
+     * @param dest is the address of the destination node that needs to be
+     * contacted.
+     * @returns a (live) port if the address is in the routing table, otherwise
+     * nullptr.
+     */
+    Port *lookup_port_for_address(Address dest)
+    {
+        OSMutexLock l(&lock_);
+        auto it = addressRoutingTable_.find(dest);
+        if (it == addressRoutingTable_.end())
+            return nullptr;
+        return it->second;
+    }
+
+    /** Declares that there is a consumer for the given event ID on the given
+     * port.
+     *
+     * @param port is where the consumer identified from has come from.
+     * @param event is the event ID for which there is a consumer identified on
+     * that port. */
+    void register_consumer(Port *port, EventId event)
+    {
+        OSMutexLock l(&lock_);
+        PortMask bit = port_bit(port);
+        if (bit)
+        {
+            exactTable_.add(event, bit);
+        }
+    }
+
+    /** Declares that there is a consumer for the given event ID range on the
+     * given port.
+     *
+     * @param port is there the consumer range identified has come from.
+     * @param encoded_range is the range of consumer encoded via the OpenLCB
+     * method. */
+    void register_consumer_range(Port *port, EventId encoded_range)
+    {
+        OSMutexLock l(&lock_);
+        PortMask bit = port_bit(port);
+        if (!bit)
+        {
+            return;
+        }
+        uint8_t bit_count = event_range_to_bit_count(&encoded_range);
+        if (bit_count >= 64)
+        {
+            allRangePorts_ |= bit;
+            return;
+        }
+        auto it = rangeTables_.begin();
+        while (it != rangeTables_.end() && it->bitCount_ < bit_count)
+        {
+            ++it;
+        }
+        if (it == rangeTables_.end() || it->bitCount_ != bit_count)
+        {
+            it = rangeTables_.insert(it, RangeTable());
+            it->bitCount_ = bit_count;
+        }
+        it->table_.add(encoded_range, bit);
+    }
+
+    /** Declares that there is a producer for the given event ID on the given
+     * port.
+     *
+     * @param port is where the producer identified from has come from.
+     * @param event is the event ID for which there is a producer identified on
+     * that port. */
+    void register_producer(Port *port, EventId event)
+    {
+        // For the moment we do not keep separate routing tables for producers
+        // and consumers.
+        register_consumer(port, event);
+    }
+
+    /** Declares that there is a producer for the given event ID range on the
+     * given port.
+     *
+     * @param port is there the producer range identified has come from.
+     * @param encoded_range is the range of producer encoded via the OpenLCB
+     * method. */
+    void register_producer_range(Port *port, EventId encoded_range)
+    {
+        // For the moment we do not keep separate routing tables for producers
+        // and consumers.
+        register_consumer_range(port, encoded_range);
+    }
+
+    /** Computes all ports that a given PCER message should be forwarded to.
+     *
+     * @param event is the event ID from the PCER message.
+     *
+     * @return the set of ports that have a consumer for the given event. Use
+     * port_for_index() to translate the bits to ports. The bit
+     * OVERFLOW_INDEX is set whenever there are overflow_ports(). */
+    PortMask lookup_pcer_ports(EventId event)
+    {
+        OSMutexLock l(&lock_);
+        PortMask ret = allRangePorts_ | exactTable_.lookup(event);
+        if (!overflowPorts_.empty())
+        {
+            ret |= PortMask(1) << OVERFLOW_INDEX;
+        }
+        for (const auto &r : rangeTables_)
+        {
+            ret |= r.table_.lookup(event & ~((UINT64_C(1) << r.bitCount_) - 1));
+        }
+        return ret;
+    }
+
+    /** Checks if a given PCER message should be forwarded to the given port.
+     * When the decision is needed for every port, lookup_pcer_ports() is more
+     * efficient.
+     *
+     * @param port is the port to query.
+     * @param event is the event ID from the PCER message.
+     *
+     * @return true if the given event has a consumer on the given port. */
+    bool check_pcer(Port *port, EventId event)
+    {
+        PortMask bit;
+        {
+            OSMutexLock l(&lock_);
+            auto it = portIndex_.find(port);
+            if (it == portIndex_.end())
+            {
+                return std::find(overflowPorts_.begin(), overflowPorts_.end(),
+                           port) != overflowPorts_.end();
+            }
+            bit = PortMask(1) << it->second;
+        }
+        return (lookup_pcer_ports(event) & bit) != 0;
+    }
+
+    /** Translates a bit of a port mask to the port.
+     *
+     * @param index is the bit number in the port mask, 0..MAX_PORTS-1.
+     * @return the port, or nullptr if there is no port with that index
+     * (always for OVERFLOW_INDEX). */
+    Port *port_for_index(unsigned index)
+    {
+        OSMutexLock l(&lock_);
+        return ports_[index];
+    }
+
+    /** @return the ports that were registered when all bits were taken. These
+     * have no event filter; every event has to be forwarded to them. Only
+     * used by routers with more than OVERFLOW_INDEX ports. */
+    std::vector<Port *> overflow_ports()
+    {
+        OSMutexLock l(&lock_);
+        return overflowPorts_;
+    }
+
+private:
+    /** Looks up the bit for a port, assigning a new index if this port has
+     * not been seen yet. Must be called with the lock held.
+     *
+     * @param port is the port to look up.
+     * @return the bitmask with the bit of the port set, or 0 if there is no
+     * free bit left (the port is then added to the overflow ports). */
+    PortMask port_bit(Port *port)
+    {
+        auto it = portIndex_.find(port);
+        if (it != portIndex_.end())
+        {
+            return PortMask(1) << it->second;
+        }
+        for (unsigned i = 0; i < OVERFLOW_INDEX; ++i)
+        {
+            if (!ports_[i])
+            {
+                ports_[i] = port;
+                portIndex_[port] = i;
+                return PortMask(1) << i;
+            }
+        }
+        if (std::find(overflowPorts_.begin(), overflowPorts_.end(), port) ==
+            overflowPorts_.end())
+        {
+            overflowPorts_.push_back(port);
+        }
+        return 0;
+    }
+
+    /// Protects all internal data structures.
+    OSMutex lock_;
+
+    /// Stores all known addresses and which port they route to.
+    std::unordered_map<Address, Port *> addressRoutingTable_;
+
+    /// Ports by their bit index. nullptr for unused index.
+    Port *ports_[MAX_PORTS] = {nullptr};
+
+    /// Reverse lookup for ports_.
+    std::unordered_map<Port *, unsigned> portIndex_;
+
+    /// Ports that did not get a bit. They receive all events.
+    std::vector<Port *> overflowPorts_;
+
+    /// Ports with a registered single event, keyed by the event ID.
+    EventPortTable exactTable_;
+
+    /// Registered ranges of a given size.
+    struct RangeTable
+    {
+        /// Number of mask bits in the ranges, 1..63.
+        uint8_t bitCount_;
+        /// Ports keyed by the base of the range (with the mask bits cleared).
+        EventPortTable table_;
+    };
+
+    /// The range tables for the different range sizes in use, sorted by
+    /// bitCount_.
+    std::vector<RangeTable> rangeTables_;
+
+    /// Ports that have registered the full event space as a range.
+    PortMask allRangePorts_ {0};
+};
+
 } // namespace openlcb
 
 #endif // _OPENLCB_ROUTNGLOGIC_HXX_
@@ -111,6 +111,16 @@ void SimpleCanStackBase::add_stream_support()
     additionalComponents_.emplace_back(mem_stream);
 }
 
+void SimpleTcpStackBase::add_stream_support()
+{
+    Destructable *t =
+        new StreamTransportTcp(if_tcp(), config_num_stream_senders());
+    additionalComponents_.emplace_back(t);
+    Destructable *mem_stream =
+        new MemoryConfigStreamHandler(memory_config_handler());
+    additionalComponents_.emplace_back(mem_stream);
+}
+
 void SimpleStackBase::start_stack(bool delay_start)
 {
 #if OPENMRN_HAVE_POSIX_FD
@@ -479,7 +479,8 @@ private:
                   config_local_alias_cache_size(),
                   config_remote_alias_cache_size(), config_local_nodes_count())
             , datagramService_(&ifCan_, config_num_datagram_registry_entries(),
-                  config_num_datagram_clients())
+                  config_num_datagram_clients(),
+                  config_datagram_client_pool() != 0)
         {
             AddAliasAllocator(node_id, &ifCan_);
         }
@@ -535,6 +536,25 @@ public:
         if_tcp()->add_network_fd(fd, on_error);
     }
 
+    /// Enables stream transport in the interface and in the memory config
+    /// protocol.
+    void add_stream_support();
+
+    /// Helper class to add stream support straight after construction.
+    /// Usage: add following at toplevel in main.cxx
+    /// ```
+    /// SimpleTcpStack stack(NODE_ID);
+    /// SimpleTcpStack::WithStreamSupport stream_support(&stack);
+    /// ```
+    class WithStreamSupport
+    {
+    public:
+        WithStreamSupport(SimpleTcpStackBase *p)
+        {
+            p->add_stream_support();
+        }
+    };
+
 protected:
     /// Helper function for start_stack et al.
     void start_iface(bool restart) override;
@@ -45,13 +45,15 @@
 namespace openlcb
 {
 
-void StreamReceiverCan::announced_stream()
+void StreamReceiverBase::announced_stream()
 {
     // Resets state bits.
     streamClosed_ = 0;
     pendingInit_ = 0;
     pendingCancel_ = 0;
     isWaiting_ = 0;
+    isRunning_ = 0;
+    nextWindowGranted_ = 0;
 
     if (!request()->streamWindowSize_)
     {
@@ -63,7 +65,7 @@ void StreamReceiverCan::announced_stream()
         Defs::MTI_STREAM_INITIATE_REQUEST, Defs::MTI_EXACT);
 }
 
-void StreamReceiverCan::send(Buffer<StreamReceiveRequest> *msg, unsigned prio)
+void StreamReceiverBase::send(Buffer<StreamReceiveRequest> *msg, unsigned prio)
 {
     reset_message(msg, prio);
 
@@ -84,7 +86,7 @@ void StreamReceiverCan::send(Buffer<StreamReceiveRequest> *msg, unsigned prio)
     wait_for_wakeup();
 }
 
-void StreamReceiverCan::handle_stream_initiate(Buffer<GenMessage> *message)
+void StreamReceiverBase::handle_stream_initiate(Buffer<GenMessage> *message)
 {
     auto rb = get_buffer_deleter(message);
 
@@ -135,6 +137,8 @@ void StreamReceiverCan::handle_stream_initiate(Buffer<GenMessage> *message)
     }
 
     streamWindowRemaining_ = request()->streamWindowSize_;
+    proceedThreshold_ = request()->streamWindowSize_ -
+        (uint32_t)request()->streamWindowSize_ * earlyProceedPercent_ / 100;
     totalByteCount_ = 0;
 
     node()->iface()->dispatcher()->register_handler(
@@ -144,20 +148,24 @@ void StreamReceiverCan::handle_stream_initiate(Buffer<GenMessage> *message)
         Defs::MTI_STREAM_INITIATE_REQUEST, Defs::MTI_EXACT);
 
     pendingInit_ = 1;
-    notify();
+    notify_if_waiting();
 }
 
-void StreamReceiverCan::handle_bytes_received(const uint8_t *data, size_t len)
+void StreamReceiverBase::handle_bytes_received(const uint8_t *data, size_t len)
 {
     while (len > 0)
     {
+        if (!streamWindowRemaining_ && nextWindowGranted_ && !streamClosed_)
+        {
+            start_next_window();
+        }
         if (!currentBuffer_)
         {
             // Need to allocate a new chunk first.
             mainBufferPool->alloc(&currentBuffer_);
             // Add an empty raw buffer to it.
             RawBufferPtr rb;
-            if (streamWindowRemaining_ <= RawData::MAX_SIZE)
+            if (streamWindowRemaining_ <= RawData::MAX_SIZE && lastBuffer_)
             {
                 // We need to use the last raw buffer.
                 rb = std::move(lastBuffer_);
@@ -169,7 +177,13 @@ void StreamReceiverCan::handle_bytes_received(const uint8_t *data, size_t len)
             }
             currentBuffer_->data()->set_from(std::move(rb), 0);
         }
-        size_t copied = currentBuffer_->data()->append(data, len);
+        size_t max_copy = len;
+        if (streamWindowRemaining_ && max_copy > streamWindowRemaining_)
+        {
+            // The rest of the data belongs to the next window.
+            max_copy = streamWindowRemaining_;
+        }
+        size_t copied = currentBuffer_->data()->append(data, max_copy);
         data += copied;
         len -= copied;
         totalByteCount_ += copied;
@@ -188,14 +202,18 @@ void StreamReceiverCan::handle_bytes_received(const uint8_t *data, size_t len)
             request()->target_->send(currentBuffer_.release());
         }
     } // while len > 0
-    if (!streamWindowRemaining_)
+    if (!streamWindowRemaining_ && nextWindowGranted_ && !streamClosed_)
+    {
+        start_next_window();
+    }
+    if (has_work())
     {
         // wake up state flow to send ack to the stream
-        notify();
+        notify_if_waiting();
     }
 }
 
-void StreamReceiverCan::handle_stream_complete(Buffer<GenMessage> *message)
+void StreamReceiverBase::handle_stream_complete(Buffer<GenMessage> *message)
 {
     auto rb = get_buffer_deleter(message);
 
@@ -244,94 +262,49 @@ void StreamReceiverCan::handle_stream_complete(Buffer<GenMessage> *message)
     if (!streamWindowRemaining_)
     {
         // wake up the flow.
-        notify();
+        notify_if_waiting();
     }
 
     node()->iface()->dispatcher()->unregister_handler(
         &streamCompleteHandler_, Defs::MTI_STREAM_COMPLETE, Defs::MTI_EXACT);
 }
 
-class StreamReceiverCan::StreamDataHandler : public IncomingFrameHandler
-{
-public:
-    StreamDataHandler(StreamReceiverCan *parent)
-        : parent_(parent)
-    { }
-
-    /// Starts registration for receiving stream data with the given aliases.
-    void start(NodeAlias remote_alias, NodeAlias local_alias)
-    {
-        HASSERT(remote_alias);
-        HASSERT(local_alias);
-        uint32_t frame_id = 0;
-        CanDefs::set_datagram_fields(
-            &frame_id, remote_alias, local_alias, CanDefs::STREAM_DATA);
-        LOG(VERBOSE, "register frame ID %x", (unsigned)frame_id);
-        parent_->if_can()->frame_dispatcher()->register_handler(
-            this, frame_id, CanDefs::STREAM_DG_RECV_MASK);
-    }
-
-    /// Stops receiving stream data.
-    void stop()
-    {
-        parent_->if_can()->frame_dispatcher()->unregister_handler_all(this);
-    }
-
-    /// Handler callback for incoming messages.
-    void send(Buffer<CanMessageData> *message, unsigned priority) override
-    {
-        auto rb = get_buffer_deleter(message);
-
-        if (message->data()->can_dlc <= 0)
-        {
-            return; // no payload
-        }
-        if (message->data()->data[0] != parent_->request()->localStreamId_)
-        {
-            return; // different stream
-        }
-        parent_->handle_bytes_received(
-            message->data()->data + 1, message->data()->can_dlc - 1);
-    }
-
-private:
-    /// Owning stream receiver object.
-    StreamReceiverCan *parent_;
-};
-
-StreamReceiverCan::StreamReceiverCan(IfCan *interface, uint8_t local_stream_id)
+StreamReceiverBase::StreamReceiverBase(If *interface, uint8_t local_stream_id)
     : StreamReceiverInterface(interface)
-    , dataHandler_(new StreamDataHandler(this))
     , assignedStreamId_(local_stream_id)
     , streamClosed_(0)
     , pendingInit_(0)
     , pendingCancel_(0)
     , isWaiting_(0)
-{ }
+    , isRunning_(0)
+    , nextWindowGranted_(0)
+{
+    earlyProceedPercent_ = config_stream_receiver_early_proceed_percent();
+    HASSERT(earlyProceedPercent_ <= 100);
+}
 
-StreamReceiverCan::~StreamReceiverCan()
+StreamReceiverBase::~StreamReceiverBase()
 { }
 
-void StreamReceiverCan::cancel_request()
+void StreamReceiverBase::cancel_request()
 {
     pendingCancel_ = 1;
-    if (isWaiting_)
-    {
-        isWaiting_ = 0;
-        notify();
-    }
+    notify_if_waiting();
 }
 
-void StreamReceiverCan::unregister_handlers()
+void StreamReceiverBase::unregister_handlers()
 {
-    dataHandler_->stop();
+    isRunning_ = 0;
+    nextWindowGranted_ = 0;
+    nextLastBuffer_.reset();
+    stop_data_handler();
     node()->iface()->dispatcher()->unregister_handler_all(
         &streamInitiateHandler_);
     node()->iface()->dispatcher()->unregister_handler_all(
         &streamCompleteHandler_);
 }
 
-StateFlowBase::Action StreamReceiverCan::wakeup()
+StateFlowBase::Action StreamReceiverBase::wakeup()
 {
     isWaiting_ = 0;
     // Checks reason for wakeup.
@@ -350,40 +323,41 @@ StateFlowBase::Action StreamReceiverCan::wakeup()
         pendingInit_ = 0;
         return call_immediately(STATE(init_reply));
     }
-    if (!streamWindowRemaining_)
+    if (streamClosed_ && !streamWindowRemaining_)
     {
-        if (streamClosed_)
+        streamClosed_ = 0;
+        isRunning_ = 0;
+        nextWindowGranted_ = 0;
+        nextLastBuffer_.reset();
+        stop_data_handler();
+        if (currentBuffer_)
         {
-            streamClosed_ = 0;
-            dataHandler_->stop();
-            if (currentBuffer_)
-            {
-                // Sends off the buffer and clears currentBuffer_.
-                request()->target_->send(currentBuffer_.release());
-            }
-            return return_ok();
+            // Sends off the buffer and clears currentBuffer_.
+            request()->target_->send(currentBuffer_.release());
         }
+        return return_ok();
+    }
+    if (need_proceed())
+    {
         // Need to send an ack.
         return call_immediately(STATE(window_reached));
     }
-    return wait();
+    return wait_for_wakeup();
 }
 
-StateFlowBase::Action StreamReceiverCan::init_reply()
+StateFlowBase::Action StreamReceiverBase::init_reply()
 {
     // Initialize the last buffer for the first window.
     return allocate_and_call<RawData>(
         nullptr, STATE(init_buffer_ready), &lastBufferPool_);
 }
 
-StateFlowBase::Action StreamReceiverCan::init_buffer_ready()
+StateFlowBase::Action StreamReceiverBase::init_buffer_ready()
 {
     lastBuffer_.reset(get_allocation_result<RawData>(nullptr));
 
-    node()->iface()->canonicalize_handle(&request()->src_);
-    NodeHandle local(node()->node_id());
-    node()->iface()->canonicalize_handle(&local);
-    dataHandler_->start(request()->src_.alias, local.alias);
+    isRunning_ = 1;
+    start_data_handler();
 
     send_message(node(), Defs::MTI_STREAM_INITIATE_REPLY, request()->src_,
         StreamDefs::create_initiate_response(request()->streamWindowSize_,
@@ -392,20 +366,147 @@ StateFlowBase::Action StreamReceiverCan::init_buffer_ready()
     return wait_for_wakeup();
 }
 
-StateFlowBase::Action StreamReceiverCan::window_reached()
+StateFlowBase::Action StreamReceiverBase::window_reached()
 {
     return allocate_and_call<RawData>(
         nullptr, STATE(have_raw_buffer), &lastBufferPool_);
 }
 
-StateFlowBase::Action StreamReceiverCan::have_raw_buffer()
+StateFlowBase::Action StreamReceiverBase::have_raw_buffer()
 {
-    lastBuffer_.reset(get_allocation_result<RawData>(nullptr));
-    streamWindowRemaining_ = request()->streamWindowSize_;
+    if (streamClosed_)
+    {
+        // The stream was closed while we were waiting for the buffer.
+        get_allocation_result<RawData>(nullptr)->unref();
+        return wait_for_wakeup();
+    }
+    if (streamWindowRemaining_)
+    {
+        // Early proceed: the sender may continue into the next window while
+        // the current one is still arriving.
+        nextLastBuffer_.reset(get_allocation_result<RawData>(nullptr));
+        nextWindowGranted_ = 1;
+    }
+    else
+    {
+        lastBuffer_.reset(get_allocation_result<RawData>(nullptr));
+        streamWindowRemaining_ = request()->streamWindowSize_;
+    }
     send_message(node(), Defs::MTI_STREAM_PROCEED, request()->src_,
         StreamDefs::create_data_proceed(
             request()->srcStreamId_, request()->localStreamId_));
     return wait_for_wakeup();
 }
 
+class StreamReceiverCan::StreamDataHandler : public IncomingFrameHandler
+{
+public:
+    StreamDataHandler(StreamReceiverCan *parent)
+        : parent_(parent)
+    { }
+
+    /// Starts registration for receiving stream data with the given aliases.
+    void start(NodeAlias remote_alias, NodeAlias local_alias)
+    {
+        HASSERT(remote_alias);
+        HASSERT(local_alias);
+        uint32_t frame_id = 0;
+        CanDefs::set_datagram_fields(
+            &frame_id, remote_alias, local_alias, CanDefs::STREAM_DATA);
+        LOG(VERBOSE, "register frame ID %x", (unsigned)frame_id);
+        parent_->if_can()->frame_dispatcher()->register_handler(
+            this, frame_id, CanDefs::STREAM_DG_RECV_MASK);
+    }
+
+    /// Stops receiving stream data.
+    void stop()
+    {
+        parent_->if_can()->frame_dispatcher()->unregister_handler_all(this);
+    }
+
+    /// Handler callback for incoming messages.
+    void send(Buffer<CanMessageData> *message, unsigned priority) override
+    {
+        auto rb = get_buffer_deleter(message);
+
+        if (message->data()->can_dlc <= 0)
+        {
+            return; // no payload
+        }
+        if (message->data()->data[0] != parent_->request()->localStreamId_)
+        {
+            return; // different stream
+        }
+        parent_->handle_bytes_received(
+            message->data()->data + 1, message->data()->can_dlc - 1);
+    }
+
+private:
+    /// Owning stream receiver object.
+    StreamReceiverCan *parent_;
+};
+
+StreamReceiverCan::StreamReceiverCan(IfCan *interface, uint8_t local_stream_id)
+    : StreamReceiverBase(interface, local_stream_id)
+    , dataHandler_(new StreamDataHandler(this))
+{ }
+
+StreamReceiverCan::~StreamReceiverCan()
+{ }
+
+void StreamReceiverCan::start_data_handler()
+{
+    node()->iface()->canonicalize_handle(&request()->src_);
+    NodeHandle local(node()->node_id());
+    node()->iface()->canonicalize_handle(&local);
+    dataHandler_->start(request()->src_.alias, local.alias);
+}
+
+void StreamReceiverCan::stop_data_handler()
+{
+    dataHandler_->stop();
+}
+
+StreamReceiverTcp::StreamReceiverTcp(If *interface, uint8_t local_stream_id)
+    : StreamReceiverBase(interface, local_stream_id)
+{ }
+
+StreamReceiverTcp::~StreamReceiverTcp()
+{ }
+
+void StreamReceiverTcp::start_data_handler()
+{
+    node()->iface()->dispatcher()->register_handler(
+        &streamDataHandler_, Defs::MTI_STREAM_DATA, Defs::MTI_EXACT);
+}
+
+void StreamReceiverTcp::stop_data_handler()
+{
+    node()->iface()->dispatcher()->unregister_handler_all(&streamDataHandler_);
+}
+
+void StreamReceiverTcp::handle_stream_data(Buffer<GenMessage> *message)
+{
+    auto rb = get_buffer_deleter(message);
+
+    if (message->data()->dstNode != node() ||
+        !node()->iface()->matching_node(request()->src_, message->data()->src))
+    {
+        // Not for me.
+        return;
+    }
+    const auto &payload = message->data()->payload;
+    if (payload.size() <= 1)
+    {
+        return; // no payload
+    }
+    if ((uint8_t)payload[0] != request()->localStreamId_)
+    {
+        return; // different stream
+    }
+    handle_bytes_received(
+        reinterpret_cast<const uint8_t *>(payload.data()) + 1,
+        payload.size() - 1);
+}
+
 } // namespace openlcb
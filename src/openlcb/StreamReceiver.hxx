@@ -46,17 +46,21 @@
 namespace openlcb
 {
 
-class StreamReceiverCan : public StreamReceiverInterface
+/// Protocol state machine for receiving a stream from a remote node. This
+/// class handles the stream initiate, proceed and complete messages, which
+/// are the same on every transport, and the windowing of the incoming
+/// data. Subclasses implement receiving the stream data from the wire.
+class StreamReceiverBase : public StreamReceiverInterface
 {
 public:
     /// Constructor.
     ///
-    /// @param interface the CAN interface that owns this stream receiver.
+    /// @param interface the interface that owns this stream receiver.
     /// @param local_stream_id what should be the local stream ID for the
     /// streams used for this receiver.
-    StreamReceiverCan(IfCan *interface, uint8_t local_stream_id);
+    StreamReceiverBase(If *interface, uint8_t local_stream_id);
 
-    ~StreamReceiverCan();
+    ~StreamReceiverBase();
 
     /// Implements the flow interface for the request API. This is not based on
     /// entry() because the registration has to be synchrnous with the calling
@@ -67,7 +71,40 @@ public:
     /// then be asynchronously returned using the regular mechanism with a
     /// temporary error.
     void cancel_request() override;
-    
+
+    /// Sets when the next stream window is granted to the sender. The Stream
+    /// Proceed message for the next window is sent when this percentage of
+    /// the current window has arrived, letting the sender continue without
+    /// waiting for a round trip at every window boundary. At most two windows
+    /// are outstanding. 100 disables early proceed. Takes effect at the next
+    /// stream initiate.
+    ///
+    /// @param percent 0 to 100.
+    void set_early_proceed_percent(uint8_t percent)
+    {
+        HASSERT(percent <= 100);
+        earlyProceedPercent_ = percent;
+    }
+
+protected:
+    /// Starts delivering incoming stream data to handle_bytes_received(). The
+    /// source node is in request()->src_, the local node is node().
+    virtual void start_data_handler() = 0;
+
+    /// Stops receiving stream data.
+    virtual void stop_data_handler() = 0;
+
+    /// Handles data arriving from the network.
+    /// @param data payload bytes of the stream.
+    /// @param len number of bytes in data.
+    void handle_bytes_received(const uint8_t *data, size_t len);
+
+    /// @return the local node pointer.
+    Node *node()
+    {
+        return request()->dst_;
+    }
+
 private:
     /// Helper function for send() when a stream has to start synchronously.
     void announced_stream();
@@ -80,7 +117,7 @@ private:
 
     Action wait_for_wakeup()
     {
-        if (pendingCancel_)
+        if (has_work())
         {
             return call_immediately(STATE(wakeup));
         }
@@ -88,6 +125,51 @@ private:
         return wait_and_call(STATE(wakeup));
     }
 
+    /// Wakes up the state flow if it is waiting for a notification. If the
+    /// flow is busy, it will check has_work() before waiting again.
+    void notify_if_waiting()
+    {
+        if (isWaiting_)
+        {
+            isWaiting_ = 0;
+            notify();
+        }
+    }
+
+    /// @return true if wakeup() has something to do.
+    bool has_work()
+    {
+        return pendingCancel_ || pendingInit_ ||
+            (streamClosed_ && !streamWindowRemaining_) || need_proceed();
+    }
+
+    /// @return true if it is time to grant the next window to the sender.
+    bool need_proceed()
+    {
+        if (!isRunning_ || streamClosed_ || nextWindowGranted_)
+        {
+            return false;
+        }
+        if (!streamWindowRemaining_)
+        {
+            return true;
+        }
+        // An early proceed must not block the flow waiting for the consumer,
+        // so we only send it if the buffer for the next window is available
+        // right away.
+        return streamWindowRemaining_ <= proceedThreshold_ &&
+            lastBufferPool_.free_items() > 0;
+    }
+
+    /// Switches to the window that was already granted with an early
+    /// proceed message.
+    void start_next_window()
+    {
+        lastBuffer_ = std::move(nextLastBuffer_);
+        streamWindowRemaining_ = request()->streamWindowSize_;
+        nextWindowGranted_ = 0;
+    }
+
     /// Root of the flow when something happens in the handlers.
     Action wakeup();
 
@@ -96,8 +178,8 @@ private:
     Action init_reply();
     Action init_buffer_ready();
 
-    /// Invoked when the stream window runs out. Maybe waits for the data to be
-    /// consumed below the low-watermark.
+    /// Invoked when the next stream window has to be granted. Maybe waits for
+    /// the data to be consumed below the low-watermark.
     Action window_reached();
     /// Called when the allocation of the raw buffer is successful. Sends off
     /// the stream proceed message.
@@ -109,9 +191,6 @@ private:
     ///
     void handle_stream_initiate(Buffer<GenMessage> *message);
 
-    /// Handles data arriving from the network.
-    inline void handle_bytes_received(const uint8_t *data, size_t len);
-
     /// Invoked by the GenericHandler when a stream complete message arrives.
     ///
     /// @param message buffer with stream complete message.
@@ -120,29 +199,14 @@ private:
 
     /// Removes all handlers that are registered.
     void unregister_handlers();
-    
-    /// @return the local CAN interface.
-    IfCan *if_can()
-    {
-        return static_cast<IfCan *>(service());
-    }
-
-    /// @return the local node pointer.
-    Node *node()
-    {
-        return request()->dst_;
-    }
 
     /// Helper class for incoming message for stream initiate.
     MessageHandler::GenericHandler streamInitiateHandler_ {
-        this, &StreamReceiverCan::handle_stream_initiate};
-
-    class StreamDataHandler;
-    friend class StreamDataHandler;
+        this, &StreamReceiverBase::handle_stream_initiate};
 
     /// Helper class for incoming message for stream complete.
     MessageHandler::GenericHandler streamCompleteHandler_ {
-        this, &StreamReceiverCan::handle_stream_complete};
+        this, &StreamReceiverBase::handle_stream_complete};
 
     /// This pool is used to allocate one raw buffer per stream window
     /// size. This pool therefore functions as a throttling for the data
@@ -157,8 +221,9 @@ private:
     /// comes from the lastBufferPool_ to function as throttling signal.
     RawBufferPtr lastBuffer_;
 
-    /// Helper object that receives the actual stream CAN frames.
-    std::unique_ptr<StreamDataHandler> dataHandler_;
+    /// The buffer that will be the last one in the next stream window, if
+    /// that window was already granted by an early proceed message.
+    RawBufferPtr nextLastBuffer_;
 
     /// How many bytes we have transmitted in this stream so far.
     size_t totalByteCount_;
@@ -166,6 +231,13 @@ private:
     /// Remaining stream window size.
     uint16_t streamWindowRemaining_;
 
+    /// When streamWindowRemaining_ drops to this value, we send the proceed
+    /// message for the next window.
+    uint16_t proceedThreshold_;
+
+    /// Percentage of the window to receive before granting the next one.
+    uint8_t earlyProceedPercent_;
+
     /// Unique stream ID at the destination (local) node, assigned at
     /// construction time.
     const uint8_t assignedStreamId_;
@@ -178,7 +250,71 @@ private:
     uint8_t pendingCancel_ : 1;
     /// 1 if we are currently waiting for a notification
     uint8_t isWaiting_ : 1;
-}; // class StreamReceiver
+    /// 1 if the stream was accepted and the data handler is active.
+    uint8_t isRunning_ : 1;
+    /// 1 if we already sent the proceed message for the next window.
+    uint8_t nextWindowGranted_ : 1;
+}; // class StreamReceiverBase
+
+/// Stream receiver for the CAN interface. The stream data arrives in CAN
+/// frames, which are taken from the frame dispatcher directly.
+class StreamReceiverCan : public StreamReceiverBase
+{
+public:
+    /// Constructor.
+    ///
+    /// @param interface the CAN interface that owns this stream receiver.
+    /// @param local_stream_id what should be the local stream ID for the
+    /// streams used for this receiver.
+    StreamReceiverCan(IfCan *interface, uint8_t local_stream_id);
+
+    ~StreamReceiverCan();
+
+private:
+    void start_data_handler() override;
+    void stop_data_handler() override;
+
+    /// @return the local CAN interface.
+    IfCan *if_can()
+    {
+        return static_cast<IfCan *>(service());
+    }
+
+    class StreamDataHandler;
+    friend class StreamDataHandler;
+
+    /// Helper object that receives the actual stream CAN frames.
+    std::unique_ptr<StreamDataHandler> dataHandler_;
+}; // class StreamReceiverCan
+
+/// Stream receiver for interfaces that carry arbitrary length messages, such
+/// as OpenLCB-TCP. The stream data arrives in Stream Data Send messages.
+class StreamReceiverTcp : public StreamReceiverBase
+{
+public:
+    /// Constructor.
+    ///
+    /// @param interface the interface that owns this stream receiver.
+    /// @param local_stream_id what should be the local stream ID for the
+    /// streams used for this receiver.
+    StreamReceiverTcp(If *interface, uint8_t local_stream_id);
+
+    ~StreamReceiverTcp();
+
+private:
+    void start_data_handler() override;
+    void stop_data_handler() override;
+
+    /// Invoked by the GenericHandler when a stream data message arrives.
+    ///
+    /// @param message buffer with stream data message.
+    ///
+    void handle_stream_data(Buffer<GenMessage> *message);
+
+    /// Helper class for incoming stream data messages.
+    MessageHandler::GenericHandler streamDataHandler_ {
+        this, &StreamReceiverTcp::handle_stream_data};
+}; // class StreamReceiverTcp
 
 } // namespace openlcb
 
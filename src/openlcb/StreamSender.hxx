@@ -48,11 +48,19 @@
 namespace openlcb
 {
 
+/// Protocol state machine for sending a stream to a remote node. This class
+/// handles the stream initiate, proceed and complete messages, which are
+/// the same on every transport. Subclasses implement how the stream payload
+/// is put on the wire.
+/// @todo add progress report API.
 class StreamSender : public StateFlow<ByteBuffer, QList<1>>
 {
 public:
     StreamSender(Service *s)
         : StateFlow<ByteBuffer, QList<1>>(s)
+        , sleeping_(false)
+        , requestClose_(false)
+        , requestInit_(false)
     {
     }
 
@@ -74,21 +82,6 @@ public:
         /// An error occurred.
         STATE_ERROR
     };
-};
-
-/// Helper class for sending stream data to a CAN interface.
-/// @todo add progress report API.
-class StreamSenderCan : public StreamSender
-{
-public:
-    StreamSenderCan(Service *service, IfCan *iface)
-        : StreamSender(service)
-        , ifCan_(iface)
-        , sleeping_(false)
-        , requestClose_(false)
-        , requestInit_(false)
-    {
-    }
 
     /// Initiates using the stream sender. May be called only on idle stream
     /// senders.
@@ -102,7 +95,7 @@ public:
     ///
     /// @return *this for calling optional settings API commands.
     ///
-    StreamSenderCan &start_stream(Node *src, NodeHandle dst,
+    StreamSender &start_stream(Node *src, NodeHandle dst,
         uint8_t source_stream_id,
         uint8_t dst_stream_id = StreamDefs::INVALID_STREAM_ID)
     {
@@ -115,13 +108,16 @@ public:
         dstStreamId_ = dst_stream_id;
         HASSERT(sleeping_ == false);
         HASSERT(requestClose_ == 0);
-        requestInit_ = true;
-        trigger();
         streamFlags_ = 0;
         streamAdditionalFlags_ = 0;
         streamWindowSize_ = StreamDefs::MAX_PAYLOAD;
         streamWindowRemaining_ = 0;
         errorCode_ = 0;
+        requestInit_ = true;
+        // The state flow may run on a different thread, and on a fast link
+        // the reply may arrive before we return, so everything above has to
+        // be set up before waking up the flow.
+        trigger();
         return *this;
     }
 
@@ -142,7 +138,7 @@ public:
     /// @param window_size in bytes, what should we propose in the stream
     /// initiate call
     ///
-    StreamSenderCan &set_proposed_window_size(uint16_t window_size)
+    StreamSender &set_proposed_window_size(uint16_t window_size)
     {
         HASSERT(state_ == STARTED);
         streamWindowSize_ = window_size;
@@ -155,7 +151,7 @@ public:
     ///
     /// @param stream_uid a valid 6-byte stream identifier.
     ///
-    StreamSenderCan &set_stream_uid(NodeID stream_uid)
+    StreamSender &set_stream_uid(NodeID stream_uid)
     {
         HASSERT(state_ == STARTED);
         /// @todo implement opening unannounced streams.
@@ -241,9 +237,69 @@ public:
             }
             return release_and_exit();
         }
-        return call_immediately(STATE(allocate_can_buffer));
+        return send_data();
+    }
+
+protected:
+    /// Sends out the next piece of stream payload. Called when there is
+    /// payload in the current chunk and the stream window is not exhausted.
+    /// Implementations take some bytes using payload() and advance(), then
+    /// continue with entry().
+    virtual Action send_data() = 0;
+
+    /// @param max_len the most bytes that a single packet of the transport
+    /// can carry.
+    /// @return how many bytes of data we can put into the next packet.
+    size_t compute_next_length(size_t max_len)
+    {
+        size_t ret = remaining();
+        // Cannot exceed the packet max payload.
+        if (ret > max_len)
+        {
+            ret = max_len;
+        }
+        // Cannot exceed remaining bytes in stream window.
+        if (ret > streamWindowRemaining_)
+        {
+            ret = streamWindowRemaining_;
+        }
+        return ret;
+    }
+
+    /// @return the number of bytes available in the current chunk.
+    size_t remaining()
+    {
+        return message()->data()->size_;
+    }
+
+    /// @return pointer to the beginning of the data to send.
+    uint8_t *payload()
+    {
+        return message()->data()->data_;
     }
 
+    /// Consumes a certain number of bytes from the beginning of the data to
+    /// send.
+    /// @param num_bytes how much data to consume.
+    void advance(size_t num_bytes)
+    {
+        message()->data()->advance(num_bytes);
+        totalByteCount_ += num_bytes;
+        streamWindowRemaining_ -= num_bytes;
+    }
+
+    /// Which node are we sending the outgoing data from. This is a local
+    /// virtual node.
+    Node *node_ {nullptr};
+    /// Destination node that we are sending to. It is important that the alias
+    /// is filled in here.
+    NodeHandle dst_;
+    /// Stream ID at the destination node. @todo fill in
+    uint8_t dstStreamId_ {StreamDefs::INVALID_STREAM_ID};
+    /// Determines whether the stream transmission is happening to
+    /// localhost. Almost never true.
+    uint8_t isLoopbackStream_ : 1;
+
 private:
     /// Sends an empty message to *this, thereby waking up the state machine.
     void trigger()
@@ -385,45 +441,6 @@ private:
         return entry();
     }
 
-    /// Allocates a buffer for a CAN frame (for payload send).
-    Action allocate_can_buffer()
-    {
-        return allocate_and_call(
-            ifCan_->frame_write_flow(), STATE(got_frame), &canFramePool_);
-    }
-
-    /// Got a buffer for an output frame (payload send).
-    Action got_frame()
-    {
-        auto *b = get_allocation_result(ifCan_->frame_write_flow());
-
-        uint32_t can_id;
-        NodeAlias local_alias =
-            ifCan_->local_aliases()->lookup(node_->node_id());
-        NodeAlias remote_alias = dst_.alias;
-        CanDefs::set_datagram_fields(
-            &can_id, local_alias, remote_alias, CanDefs::STREAM_DATA);
-        auto *frame = b->data()->mutable_frame();
-        SET_CAN_FRAME_ID_EFF(*frame, can_id);
-
-        size_t len = compute_next_can_length();
-
-        frame->can_dlc = len + 1;
-        frame->data[0] = dstStreamId_;
-        memcpy(&frame->data[1], payload(), len);
-        advance(len);
-
-        if (!isLoopbackStream_)
-        {
-            ifCan_->frame_write_flow()->send(b);
-        }
-        else
-        {
-            ifCan_->loopback_frame_write_flow()->send(b);
-        }
-        return entry();
-    }
-
     /// Starts sleeping until a proceed message arrives. Run this state when
     /// streamWindowRemaining_ == 0.
     Action wait_for_stream_proceed()
@@ -482,45 +499,6 @@ private:
     }
 
 private:
-    /// @return how many bytes of data we can put into the next CAN frame.
-    size_t compute_next_can_length()
-    {
-        size_t ret = remaining();
-        // Cannot exceed CAN frame max payload.
-        if (ret > MAX_BYTES_PAYLOAD_PER_CAN_FRAME)
-        {
-            ret = MAX_BYTES_PAYLOAD_PER_CAN_FRAME;
-        }
-        // Cannot exceed remaining bytes in stream window.
-        if (ret > streamWindowRemaining_)
-        {
-            ret = streamWindowRemaining_;
-        }
-        return ret;
-    }
-
-    /// @return the number of bytes available in the current chunk.
-    size_t remaining()
-    {
-        return message()->data()->size_;
-    }
-
-    /// @return pointer to the beginning of the data to send.
-    uint8_t *payload()
-    {
-        return message()->data()->data_;
-    }
-
-    /// Consumes a certain number of bytes from the beginning of the data to
-    /// send.
-    /// @param num_bytes how much data to consume.
-    void advance(size_t num_bytes)
-    {
-        message()->data()->advance(num_bytes);
-        totalByteCount_ += num_bytes;
-        streamWindowRemaining_ -= num_bytes;
-    }
-
     Action return_error(uint32_t code, string message)
     {
         LOG(INFO, "error %x: %s", (unsigned)code, message.c_str());
@@ -537,42 +515,19 @@ private:
     /// with a timeout.
     static constexpr size_t STREAM_INIT_TIMEOUT_SEC = 20;
 
-    /// How many bytes payload we can copy into a single CAN frame.
-    static constexpr size_t MAX_BYTES_PAYLOAD_PER_CAN_FRAME = 7;
-
-    /// How many CAN frames should we allocate at a given time.
-    static constexpr size_t MAX_FRAMES_IN_FLIGHT = 4;
-
-    /// How many bytes the allocation of a single CAN frame should be.
-    static constexpr size_t CAN_FRAME_ALLOC_SIZE =
-        sizeof(CanFrameWriteFlow::message_type);
-
     /// Handles incoming stream proceed messages.
     MessageHandler::GenericHandler streamProceedHandler_ {
-        this, &StreamSenderCan::stream_proceed_received};
+        this, &StreamSender::stream_proceed_received};
     /// Handles incoming stream initiate reply messages.
     MessageHandler::GenericHandler streamInitiateReplyHandler_ {
-        this, &StreamSenderCan::stream_initiate_replied};
+        this, &StreamSender::stream_initiate_replied};
 
-    /// CAN-bus interface.
-    IfCan *ifCan_;
-    /// Which node are we sending the outgoing data from. This is a local
-    /// virtual node.
-    Node *node_ {nullptr};
-    /// Destination node that we are sending to. It is important that the alias
-    /// is filled in here.
-    NodeHandle dst_;
     /// How many bytes we have transmitted in this stream so far.
     size_t totalByteCount_ {0};
     /// What state the current class is in.
     StreamSenderState state_ {IDLE};
     /// Stream ID at the source node. @todo fill in
     uint8_t localStreamId_ {StreamDefs::INVALID_STREAM_ID};
-    /// Stream ID at the destination node. @todo fill in
-    uint8_t dstStreamId_ {StreamDefs::INVALID_STREAM_ID};
-    /// Determines whether the stream transmission is happening to
-    /// localhost. Almost never true.
-    uint8_t isLoopbackStream_ : 1;
     /// True if we are waiting for the timer.
     uint8_t sleeping_ : 1;
     /// 1 if there is a pending close request.
@@ -585,16 +540,144 @@ private:
     uint8_t streamAdditionalFlags_ {0};
     /// Total stream window size. @todo fill in
     uint16_t streamWindowSize_ {StreamDefs::MAX_PAYLOAD};
-    /// Remaining stream window size. @todo fill in
-    uint16_t streamWindowRemaining_ {0};
+    /// How many bytes we may send before we have to wait for a proceed
+    /// message. With early proceed from the receiver this may span more than
+    /// one window.
+    uint32_t streamWindowRemaining_ {0};
     /// When the stream process fails, this variable contains an error code.
     uint32_t errorCode_ {0};
+    /// Helper object for timeouts.
+    StateFlowTimer timer_ {this};
+};
+
+/// Helper class for sending stream data to a CAN interface.
+class StreamSenderCan : public StreamSender
+{
+public:
+    StreamSenderCan(Service *service, IfCan *iface)
+        : StreamSender(service)
+        , ifCan_(iface)
+    {
+    }
+
+private:
+    Action send_data() override
+    {
+        return call_immediately(STATE(allocate_can_buffer));
+    }
+
+    /// Allocates a buffer for a CAN frame (for payload send).
+    Action allocate_can_buffer()
+    {
+        return allocate_and_call(
+            ifCan_->frame_write_flow(), STATE(got_frame), &canFramePool_);
+    }
+
+    /// Got a buffer for an output frame (payload send).
+    Action got_frame()
+    {
+        auto *b = get_allocation_result(ifCan_->frame_write_flow());
+
+        uint32_t can_id;
+        NodeAlias local_alias =
+            ifCan_->local_aliases()->lookup(node_->node_id());
+        NodeAlias remote_alias = dst_.alias;
+        CanDefs::set_datagram_fields(
+            &can_id, local_alias, remote_alias, CanDefs::STREAM_DATA);
+        auto *frame = b->data()->mutable_frame();
+        SET_CAN_FRAME_ID_EFF(*frame, can_id);
+
+        size_t len = compute_next_length(MAX_BYTES_PAYLOAD_PER_CAN_FRAME);
+
+        frame->can_dlc = len + 1;
+        frame->data[0] = dstStreamId_;
+        memcpy(&frame->data[1], payload(), len);
+        advance(len);
+
+        if (!isLoopbackStream_)
+        {
+            ifCan_->frame_write_flow()->send(b);
+        }
+        else
+        {
+            ifCan_->loopback_frame_write_flow()->send(b);
+        }
+        return entry();
+    }
+
+    /// How many bytes payload we can copy into a single CAN frame.
+    static constexpr size_t MAX_BYTES_PAYLOAD_PER_CAN_FRAME = 7;
+
+    /// How many CAN frames should we allocate at a given time.
+    static constexpr size_t MAX_FRAMES_IN_FLIGHT = 4;
+
+    /// How many bytes the allocation of a single CAN frame should be.
+    static constexpr size_t CAN_FRAME_ALLOC_SIZE =
+        sizeof(CanFrameWriteFlow::message_type);
+
+    /// CAN-bus interface.
+    IfCan *ifCan_;
     /// Source of buffers for outgoing CAN frames. Limtedpool is allocating and
     /// releasing to the mainBufferPool, but blocks when we exceed a certain
     /// number of allocations until some buffers get freed.
     LimitedPool canFramePool_ {CAN_FRAME_ALLOC_SIZE, MAX_FRAMES_IN_FLIGHT};
-    /// Helper object for timeouts.
-    StateFlowTimer timer_ {this};
+};
+
+/// Helper class for sending stream data to an interface that carries
+/// arbitrary length messages, such as OpenLCB-TCP. Each stream data message
+/// carries as much of the current chunk as fits into the stream window.
+class StreamSenderTcp : public StreamSender
+{
+public:
+    /// Constructor.
+    /// @param service the service to run the flow on.
+    /// @param iface the interface to send the stream data messages to.
+    StreamSenderTcp(Service *service, If *iface)
+        : StreamSender(service)
+        , iface_(iface)
+    {
+    }
+
+private:
+    Action send_data() override
+    {
+        return allocate_and_call(iface_->addressed_message_write_flow(),
+            STATE(got_message), &messagePool_);
+    }
+
+    /// Got a buffer for an output message (payload send).
+    Action got_message()
+    {
+        auto *b =
+            get_allocation_result(iface_->addressed_message_write_flow());
+        size_t len = compute_next_length(MAX_BYTES_PAYLOAD_PER_MESSAGE);
+        string p;
+        p.reserve(len + 1);
+        p.push_back(dstStreamId_);
+        p.append(reinterpret_cast<const char *>(payload()), len);
+        b->data()->reset(
+            Defs::MTI_STREAM_DATA, node_->node_id(), dst_, std::move(p));
+        advance(len);
+        iface_->addressed_message_write_flow()->send(b);
+        return entry();
+    }
+
+    /// Largest stream payload to put into a single message. Larger chunks
+    /// are split, and the stream window limits this further.
+    static constexpr size_t MAX_BYTES_PAYLOAD_PER_MESSAGE = 0xFFFF;
+
+    /// How many messages should we allocate at a given time.
+    static constexpr size_t MAX_MESSAGES_IN_FLIGHT = 4;
+
+    /// How many bytes the allocation of a single message should be.
+    static constexpr size_t MESSAGE_ALLOC_SIZE =
+        sizeof(MessageHandler::message_type);
+
+    /// OpenLCB interface to send the messages to.
+    If *iface_;
+    /// Source of buffers for outgoing messages. Blocks when we exceed a
+    /// certain number of allocations until some buffers get freed.
+    LimitedPool messagePool_ {MESSAGE_ALLOC_SIZE, MAX_MESSAGES_IN_FLIGHT};
 };
 
 class StreamRendererCan : public StateFlow<ByteBuffer, QList<1>>
@@ -44,7 +44,9 @@ namespace openlcb
 {
 
 class StreamSender;
+class StreamReceiverInterface;
 class IfCan;
+class IfTcp;
 class If;
 
 /// Collects the objects needed to support streams on an OpenLCB interface.
@@ -105,6 +107,16 @@ public:
         return nextReceiveStreamId_++;
     }
 
+    /// Creates a stream receiver that is suitable for this interface.
+    ///
+    /// @param local_stream_id stream ID (DID) that the new receiver will use,
+    /// usually from get_next_stream_receive_id().
+    ///
+    /// @return a new stream receiver object. Ownership is transferred to the
+    /// caller.
+    virtual StreamReceiverInterface *create_receiver(
+        uint8_t local_stream_id) = 0;
+
 protected:
     /// Stream Sender objects.
     TypedQAsync<StreamSender> senders_;
@@ -135,6 +147,34 @@ public:
 
     /// Destructor.
     ~StreamTransportCan();
+
+    StreamReceiverInterface *create_receiver(uint8_t local_stream_id) override;
+
+private:
+    /// Interface that owns this transport.
+    IfCan *iface_;
+};
+
+/// OpenLCB-TCP specific implementation of the stream transport interface. The
+/// stream data is sent in messages as large as the stream window allows,
+/// instead of being split into CAN frames.
+class StreamTransportTcp : public StreamTransport
+{
+public:
+    /// Constructor
+    ///
+    /// @param iface OpenLCB-TCP interface object pointer.
+    /// @param num_senders How many stream senders to instantiate.
+    StreamTransportTcp(IfTcp *iface, unsigned num_senders);
+
+    /// Destructor.
+    ~StreamTransportTcp();
+
+    StreamReceiverInterface *create_receiver(uint8_t local_stream_id) override;
+
+private:
+    /// Interface that owns this transport.
+    IfTcp *iface_;
 };
 
 } // namespace openlcb
@@ -56,10 +56,6 @@ TrainNode::~TrainNode()
 
 TrainNodeWithConsist::~TrainNodeWithConsist()
 {
-    while (!consistSlaves_.empty())
-    {
-        delete consistSlaves_.pop_front();
-    }
 }
 
 DefaultTrainNode::~DefaultTrainNode()
@@ -201,8 +197,7 @@ struct TrainService::Impl
                 {
                     SpeedType sp = fp16_to_speed(payload() + 1);
                     train_node()->train()->set_speed(sp);
-                    nextConsistIndex_ = 0;
-                    return call_immediately(STATE(maybe_forward_consist));
+                    return call_immediately(STATE(forward_consist));
                 }
                 case TractionDefs::REQ_SET_FN:
                 {
@@ -232,14 +227,12 @@ struct TrainService::Impl
                     {
                         train_node()->train()->set_fn(address, value);
                     }
-                    nextConsistIndex_ = 0;
-                    return call_immediately(STATE(maybe_forward_consist));
+                    return call_immediately(STATE(forward_consist));
                 }
                 case TractionDefs::REQ_EMERGENCY_STOP:
                 {
                     train_node()->train()->set_emergencystop();
-                    nextConsistIndex_ = 0;
-                    return call_immediately(STATE(maybe_forward_consist));
+                    return call_immediately(STATE(forward_consist));
                 }
                 case TractionDefs::REQ_QUERY_SPEED: // fall through
                 case TractionDefs::REQ_QUERY_FN:
@@ -460,92 +453,74 @@ struct TrainService::Impl
             }
         }
 
-        Action maybe_forward_consist()
+        /// Forwards the incoming speed, function or emergency stop command to
+        /// every consist member in one pass. Members only get a copy of the
+        /// message; the last one that needs it takes over the incoming
+        /// buffer.
+        Action forward_consist()
         {
-            auto* train_node = this->train_node();
-            unsigned count = train_node->query_consist_length();
-            if (count <= nextConsistIndex_)
-                return release_and_exit();
-            uint8_t flags = 0;
-            NodeID dst = train_node->query_consist(nextConsistIndex_, &flags);
-            if (iface()->matching_node(nmsg()->src, NodeHandle(dst)))
-            {
-                ++nextConsistIndex_;
-                return again();
-            }
+            auto *train_node = this->train_node();
             uint8_t cmd = payload()[0] & TractionDefs::REQ_MASK;
-            bool flip_speed = false;
-            if (cmd == TractionDefs::REQ_SET_SPEED) {
-                if (flags & TractionDefs::CNSTFLAGS_REVERSE) {
-                    flip_speed = true;
-                }
-            } else if (cmd == TractionDefs::REQ_SET_FN) {
-                uint32_t address = payload()[1];
-                address <<= 8;
-                address |= payload()[2];
-                address <<= 8;
-                address |= payload()[3];
-                if (address == 0) {
-                    if ((flags & TractionDefs::CNSTFLAGS_LINKF0) == 0) {
-                        // skip
-                        ++nextConsistIndex_;
-                        return again();
-                    }
-                } else {
-                    if ((flags & TractionDefs::CNSTFLAGS_LINKFN) == 0) {
-                        // skip
-                        ++nextConsistIndex_;
-                        return again();
-                    }
-                }
+            // Which link flag the members need in order to get the command.
+            uint8_t need_flags = 0;
+            if (cmd == TractionDefs::REQ_SET_FN)
+            {
+                bool is_f0 =
+                    payload()[1] == 0 && payload()[2] == 0 && payload()[3] == 0;
+                need_flags = is_f0 ? TractionDefs::CNSTFLAGS_LINKF0
+                                   : TractionDefs::CNSTFLAGS_LINKFN;
             }
-            if (count == nextConsistIndex_ + 1u)
+            int count = train_node->query_consist_length();
+            // The member found last; sent when the next one is found.
+            NodeID pending = 0;
+            uint8_t pending_flags = 0;
+            for (int i = 0; i < count; ++i)
             {
-                // last node: we can transfer the message.
-                auto *b = transfer_message();
-                b->data()->src = NodeHandle(train_node->node_id());
-                b->data()->dst = NodeHandle(dst);
-                b->data()->dstNode = nullptr;
-                if (flip_speed) {
-                    b->data()->payload[1] ^= 0x80;
+                uint8_t flags = 0;
+                NodeID dst = train_node->query_consist(i, &flags);
+                if (!dst ||
+                    iface()->matching_node(nmsg()->src, NodeHandle(dst)) ||
+                    (flags & need_flags) != need_flags)
+                {
+                    continue;
                 }
-                b->data()->payload[0] |= TractionDefs::REQ_LISTENER;
-                iface()->addressed_message_write_flow()->send(b);
-                return exit();
+                if (pending)
+                {
+                    auto *b = iface()->addressed_message_write_flow()->alloc();
+                    b->data()->reset(nmsg()->mti, train_node->node_id(),
+                        NodeHandle(pending), nmsg()->payload);
+                    send_forward(b, pending_flags);
+                }
+                pending = dst;
+                pending_flags = flags;
             }
-            else
+            if (!pending)
             {
-                return allocate_and_call(
-                    iface()->addressed_message_write_flow(),
-                    STATE(forward_consist));
+                return release_and_exit();
             }
+            // last node: we can transfer the message.
+            auto *b = transfer_message();
+            b->data()->src = NodeHandle(train_node->node_id());
+            b->data()->dst = NodeHandle(pending);
+            b->data()->dstNode = nullptr;
+            send_forward(b, pending_flags);
+            return exit();
         }
 
-        Action forward_consist()
+        /// Marks a forwarded consist command as a listener message, flips the
+        /// direction for reversed members and sends it off.
+        /// @param b message with the destination and payload filled in.
+        /// @param flags consist link flags of the destination.
+        void send_forward(Buffer<GenMessage> *b, uint8_t flags)
         {
-            auto *b =
-                get_allocation_result(iface()->addressed_message_write_flow());
-            uint8_t flags;
-            NodeID dst = train_node()->query_consist(nextConsistIndex_, &flags);
-            if (!dst)
-            {
-                // Strange. The consist destination should exist and never be
-                // zero once we got here.
-                b->unref();
-                return release_and_exit();
-            }
-            b->data()->reset(message()->data()->mti, train_node()->node_id(),
-                             NodeHandle(dst), message()->data()->payload);
-            b->data()->payload[0] |= TractionDefs::REQ_LISTENER;
-            if (((payload()[0] & TractionDefs::REQ_MASK) ==
+            if (((b->data()->payload[0] & TractionDefs::REQ_MASK) ==
                     TractionDefs::REQ_SET_SPEED) &&
                 (flags & TractionDefs::CNSTFLAGS_REVERSE))
             {
                 b->data()->payload[1] ^= 0x80;
             }
+            b->data()->payload[0] |= TractionDefs::REQ_LISTENER;
             iface()->addressed_message_write_flow()->send(b);
-            ++nextConsistIndex_;
-            return call_immediately(STATE(maybe_forward_consist));
         }
 
         Action handle_traction_mgmt()
@@ -650,7 +625,6 @@ struct TrainService::Impl
     private:
         /// error code for reject_permanent().
         unsigned errorCode_ : 16;
-        unsigned nextConsistIndex_ : 8;
         /// 1 if the voluntary lock protocol has set this train to be reserved.
         unsigned reserved_ : 1;
         TrainService *trainService_;
@@ -53,6 +53,10 @@ DEFAULT_CONST(num_datagram_registry_entries, 2);
  * happen concurrently. */
 DEFAULT_CONST(num_datagram_clients, 2);
 
+/** If non-zero, the datagram clients of the CAN stack are proxies of a
+ * DatagramClientPool. */
+DEFAULT_CONST(datagram_client_pool, 0);
+
 /** Number of stream senders. This is how many stream send operations can
  * happen concurrently. */
 DEFAULT_CONST(num_stream_senders, 1);
@@ -78,3 +82,13 @@ DEFAULT_CONST(bulk_alias_num_can_frames, 20);
 /** Default number of bytes in maximum stream window size for { @ref
  * StreamReceiver }. */
 DEFAULT_CONST(stream_receiver_default_window_size, 2 * 1024);
+
+/** Percentage of the stream window that has to arrive before { @ref
+ * StreamReceiver } grants the next window with a Stream Proceed message. 100
+ * waits for the entire window to arrive (stop-and-wait). */
+DEFAULT_CONST(stream_receiver_early_proceed_percent, 50);
+
+/** Largest config file (in bytes) that { @ref ConfigFileSnapshot } copies to
+ * the heap on platforms where the file cannot be mapped into memory. 0
+ * disables the heap copy. */
+DEFAULT_CONST(snapshot_max_heap_size, 0);
@@ -33,6 +33,10 @@
 
 #include "os/OSSelectWakeup.hxx"
 #include "utils/logging.h"
+
+#include <algorithm>
+#include <atomic>
+#include <errno.h>
 #if defined(__MACH__)
 #define _DARWIN_C_SOURCE // pselect
 #endif
@@ -112,6 +116,58 @@ int OSSelectWakeup::select(int nfds, fd_set *readfds,
     return ret;
 }
 
+#if OPENMRN_HAVE_EPOLL
+int OSSelectWakeup::epoll_wait(int epfd, struct epoll_event *events,
+                               int maxevents, long long deadline_nsec)
+{
+    {
+        AtomicHolder l(this);
+        inSelect_ = true;
+        if (pendingWakeup_)
+        {
+            deadline_nsec = 0;
+        }
+    }
+    int ret = -1;
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 35)
+    // epoll_pwait2 has nanosecond resolution, which matters for the short
+    // timers (e.g. gridconnect output buffering). Kernels older than 5.11 do
+    // not have it, in which case we fall back to the millisecond version.
+    // Shared by all executor threads.
+    static std::atomic<bool> have_pwait2 {true};
+    if (have_pwait2.load(std::memory_order_relaxed))
+    {
+        struct timespec timeout;
+        timeout.tv_sec = deadline_nsec / 1000000000;
+        timeout.tv_nsec = deadline_nsec % 1000000000;
+        ret = ::epoll_pwait2(epfd, events, maxevents,
+                             deadline_nsec < 0 ? nullptr : &timeout,
+                             &origMask_);
+        if (ret < 0 && errno == ENOSYS)
+        {
+            have_pwait2.store(false, std::memory_order_relaxed);
+        }
+    }
+    if (!have_pwait2.load(std::memory_order_relaxed))
+#endif
+    {
+        // Rounds up so that we never wake up before the deadline.
+        int timeout_msec = deadline_nsec < 0
+            ? -1
+            : (int)std::min((deadline_nsec + 999999) / 1000000, 0x7fffffffLL);
+        ret =
+            ::epoll_pwait(epfd, events, maxevents, timeout_msec, &origMask_);
+    }
+    {
+        AtomicHolder l(this);
+        pendingWakeup_ = false;
+        inSelect_ = false;
+    }
+    return ret;
+}
+#endif // OPENMRN_HAVE_EPOLL
+
+
 #ifdef ESP_PLATFORM
 #include "freertos_includes.h"
 
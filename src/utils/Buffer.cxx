@@ -33,6 +33,7 @@
 
 #include "utils/Buffer.hxx"
 #include "utils/ByteBuffer.hxx"
+#include "nmranet_config.h"
 
 DynamicPool *mainBufferPool = nullptr;
 Pool *rawBufferPool = nullptr;
@@ -47,6 +48,13 @@ Pool* init_main_buffer_pool()
     {
         mainBufferPool =
             new DynamicPool(Bucket::init(32, 48, LARGEST_BUFFERPOOL_BUCKET, 0));
+#if OPENMRN_HAVE_BUFFER_THREAD_CACHE
+        if (config_buffer_thread_cache_size())
+        {
+            mainBufferPool->enable_thread_cache(
+                config_buffer_thread_cache_size());
+        }
+#endif
     }
     return mainBufferPool;
 }
@@ -110,6 +118,13 @@ BufferBase *DynamicPool::alloc_untyped(size_t size, Executable *flow)
     {
         if (size <= current->size())
         {
+#if OPENMRN_HAVE_BUFFER_THREAD_CACHE
+            if (magazineSize_)
+            {
+                result = cache_alloc(current - buckets);
+            }
+            else
+#endif
             result = static_cast<BufferBase*>(current->next().item);
             if (result == NULL)
             {
@@ -174,6 +189,13 @@ void DynamicPool::free(BufferBase *item)
     {
         if (item->size() <= current->size())
         {
+#if OPENMRN_HAVE_BUFFER_THREAD_CACHE
+            if (magazineSize_)
+            {
+                cache_free(current - buckets, item);
+                return;
+            }
+#endif
             current->insert(item);
             return;
         }
@@ -186,6 +208,264 @@ void DynamicPool::free(BufferBase *item)
     free_large(item);
 }
 
+#if OPENMRN_HAVE_BUFFER_THREAD_CACHE
+/// Private cache of free buffers of one thread for one DynamicPool.
+struct DynamicPool::ThreadCache
+{
+    /// Free buffers of one bucket size.
+    struct Magazine
+    {
+        /// Linked list of free buffers, most recently freed first.
+        BufferBase *head {nullptr};
+        /// Number of buffers in the list.
+        unsigned count {0};
+        /// Lowest count since the last scavenge.
+        unsigned lowWater {0};
+    };
+
+    /// Which pool this belongs to.
+    DynamicPool *pool_;
+    /// Next cache in the pool's registry.
+    ThreadCache *nextInPool_ {nullptr};
+    /// Next cache of the same thread (for a different pool).
+    ThreadCache *nextInThread_ {nullptr};
+    /// One magazine per bucket.
+    std::unique_ptr<Magazine[]> mags_;
+    /// Number of operations since the last scavenge.
+    unsigned ops_ {0};
+    /// Statistics. Only written by the owning thread.
+    std::atomic<uint64_t> hits_ {0};
+    /// Statistics. Only written by the owning thread.
+    std::atomic<uint64_t> misses_ {0};
+    /// Statistics. Only written by the owning thread.
+    std::atomic<uint64_t> returned_ {0};
+
+    /// Increments a statistics counter owned by this thread.
+    /// @param c the counter.
+    static void inc(std::atomic<uint64_t> *c, unsigned n = 1)
+    {
+        c->store(c->load(std::memory_order_relaxed) + n,
+            std::memory_order_relaxed);
+    }
+};
+
+/// Thread-local list of caches; returns the buffers to the pools when the
+/// thread exits.
+struct DynamicPool::ThreadCacheList
+{
+    ~ThreadCacheList()
+    {
+        while (head_)
+        {
+            ThreadCache *c = head_;
+            head_ = c->nextInThread_;
+            c->pool_->release_thread_cache(c);
+            delete c;
+        }
+    }
+
+    /// First cache of this thread.
+    ThreadCache *head_ {nullptr};
+};
+
+thread_local DynamicPool::ThreadCacheList DynamicPool::tlsCaches_;
+
+/// After this many operations on a thread cache, the buffers that were not
+/// needed since the last time are returned to the shared buckets.
+static constexpr unsigned THREAD_CACHE_SCAVENGE_PERIOD = 4096;
+
+void DynamicPool::enable_thread_cache(unsigned magazine_size)
+{
+    HASSERT(!threadCaches_);
+    numBuckets_ = 0;
+    while (buckets[numBuckets_].size() != 0)
+    {
+        ++numBuckets_;
+    }
+    magazineSize_ = magazine_size;
+}
+
+DynamicPool::ThreadCacheStats DynamicPool::thread_cache_stats()
+{
+    AtomicHolder h(this);
+    ThreadCacheStats ret = retiredStats_;
+    for (ThreadCache *c = threadCaches_; c; c = c->nextInPool_)
+    {
+        ret.hits += c->hits_.load(std::memory_order_relaxed);
+        ret.misses += c->misses_.load(std::memory_order_relaxed);
+        ret.returned += c->returned_.load(std::memory_order_relaxed);
+    }
+    return ret;
+}
+
+DynamicPool::ThreadCache *DynamicPool::thread_cache()
+{
+    for (ThreadCache *c = tlsCaches_.head_; c; c = c->nextInThread_)
+    {
+        if (c->pool_ == this)
+        {
+            return c;
+        }
+    }
+    ThreadCache *c = new ThreadCache;
+    c->pool_ = this;
+    c->mags_.reset(new ThreadCache::Magazine[numBuckets_]);
+    c->nextInThread_ = tlsCaches_.head_;
+    tlsCaches_.head_ = c;
+    AtomicHolder h(this);
+    c->nextInPool_ = threadCaches_;
+    threadCaches_ = c;
+    return c;
+}
+
+BufferBase *DynamicPool::cache_alloc(unsigned idx)
+{
+    ThreadCache *c = thread_cache();
+    ThreadCache::Magazine &m = c->mags_[idx];
+    if (m.head)
+    {
+        ThreadCache::inc(&c->hits_);
+    }
+    else
+    {
+        ThreadCache::inc(&c->misses_);
+        // Refills half of the magazine with one lock acquisition.
+        Bucket *b = buckets + idx;
+        unsigned want = (magazineSize_ + 1) / 2;
+        AtomicHolder h(b->lock());
+        while (m.count < want)
+        {
+            auto *item = static_cast<BufferBase *>(b->next_locked().item);
+            if (!item)
+            {
+                break;
+            }
+            item->next = m.head;
+            m.head = item;
+            ++m.count;
+        }
+        if (!m.head)
+        {
+            return nullptr;
+        }
+    }
+    BufferBase *result = m.head;
+    m.head = static_cast<BufferBase *>(result->next);
+    result->next = nullptr;
+    --m.count;
+    if (m.count < m.lowWater)
+    {
+        m.lowWater = m.count;
+    }
+    return result;
+}
+
+void DynamicPool::cache_free(unsigned idx, BufferBase *item)
+{
+    ThreadCache *c = thread_cache();
+    ThreadCache::Magazine &m = c->mags_[idx];
+    item->next = m.head;
+    m.head = item;
+    if (++m.count > magazineSize_)
+    {
+        // Keeps the hoard bounded.
+        return_buffers(c, idx, magazineSize_ / 2);
+    }
+    if (++c->ops_ >= THREAD_CACHE_SCAVENGE_PERIOD)
+    {
+        // Returns what was not needed during the last period.
+        c->ops_ = 0;
+        for (unsigned i = 0; i < numBuckets_; ++i)
+        {
+            ThreadCache::Magazine &mm = c->mags_[i];
+            if (mm.lowWater)
+            {
+                return_buffers(c, i, mm.count - mm.lowWater);
+            }
+            mm.lowWater = mm.count;
+        }
+    }
+}
+
+void DynamicPool::return_buffers(ThreadCache *c, unsigned idx, unsigned keep)
+{
+    ThreadCache::Magazine &m = c->mags_[idx];
+    if (m.count <= keep)
+    {
+        return;
+    }
+    BufferBase *rest;
+    if (keep == 0)
+    {
+        rest = m.head;
+        m.head = nullptr;
+    }
+    else
+    {
+        BufferBase *last = m.head;
+        for (unsigned i = 1; i < keep; ++i)
+        {
+            last = static_cast<BufferBase *>(last->next);
+        }
+        rest = static_cast<BufferBase *>(last->next);
+        last->next = nullptr;
+    }
+    unsigned n = m.count - keep;
+    m.count = keep;
+    if (m.lowWater > keep)
+    {
+        m.lowWater = keep;
+    }
+    ThreadCache::inc(&c->returned_, n);
+    Bucket *b = buckets + idx;
+    AtomicHolder h(b->lock());
+    while (rest)
+    {
+        BufferBase *item = rest;
+        rest = static_cast<BufferBase *>(item->next);
+        item->next = nullptr;
+        b->insert_locked(item);
+    }
+}
+
+void DynamicPool::release_thread_cache(ThreadCache *c)
+{
+    for (unsigned i = 0; i < numBuckets_; ++i)
+    {
+        return_buffers(c, i, 0);
+    }
+    AtomicHolder h(this);
+    retiredStats_.hits += c->hits_;
+    retiredStats_.misses += c->misses_;
+    retiredStats_.returned += c->returned_;
+    for (ThreadCache **link = &threadCaches_; *link;
+         link = &(*link)->nextInPool_)
+    {
+        if (*link == c)
+        {
+            *link = c->nextInPool_;
+            break;
+        }
+    }
+}
+
+void DynamicPool::release_current_thread_cache()
+{
+    for (ThreadCache **link = &tlsCaches_.head_; *link;
+         link = &(*link)->nextInThread_)
+    {
+        ThreadCache *c = *link;
+        if (c->pool_ == this)
+        {
+            *link = c->nextInThread_;
+            release_thread_cache(c);
+            delete c;
+            return;
+        }
+    }
+}
+#endif // OPENMRN_HAVE_BUFFER_THREAD_CACHE
+
 /** Get a free item out of the pool.
  * @param size how many payload bytes should he allocated buffer have. Usually
  * sizeof<T> for Buffer<T>.
@@ -44,6 +44,7 @@
 #include <cstdlib>
 #include <cstdarg>
 
+#include "openmrn_features.h"
 #include "executor/Executable.hxx"
 #include "executor/Notifiable.hxx"
 #include "os/OS.hxx"
@@ -502,6 +503,12 @@ public:
     /** default destructor */
     ~DynamicPool()
     {
+#if OPENMRN_HAVE_BUFFER_THREAD_CACHE
+        release_current_thread_cache();
+        // The magazines are used without a lock, so the caches of other
+        // threads cannot be drained from here.
+        HASSERT(!threadCaches_);
+#endif
 #ifdef GTEST
         for (unsigned i = 0; buckets[i].size() != 0; ++i)
         {
@@ -531,6 +538,45 @@ public:
      */
     size_t free_items(size_t size) override;
 
+#if OPENMRN_HAVE_BUFFER_THREAD_CACHE
+    /** Enables per-thread caches (magazines) of free buffers in front of the
+     * shared buckets. A thread allocates from and frees to its own magazine
+     * without taking a lock; the magazines are refilled from, and overflow
+     * into, the shared buckets in batches. Each magazine holds at most
+     * magazine_size buffers, and buffers that were not needed during a
+     * scavenge period are returned to the buckets. Buffers in the magazines
+     * are not counted in free_items().
+     *
+     * Must be called before the pool is used from multiple threads. A thread
+     * returns its cache when it exits or calls
+     * release_current_thread_cache(). Every thread other than the one
+     * destroying the pool must have done so before the pool is destroyed.
+     * @param magazine_size maximum number of free buffers per bucket and
+     * thread; 0 turns the caches off.
+     */
+    void enable_thread_cache(unsigned magazine_size);
+
+    /// Statistics of the per-thread caches.
+    struct ThreadCacheStats
+    {
+        /// Allocations served from a thread's magazine.
+        uint64_t hits;
+        /// Allocations that had to go to the shared buckets or the heap.
+        uint64_t misses;
+        /// Number of buffers returned from the magazines to the buckets.
+        uint64_t returned;
+    };
+
+    /** @return the statistics of the per-thread caches, summed over all
+     * threads. */
+    ThreadCacheStats thread_cache_stats();
+
+    /** Returns the buffers in the calling thread's cache to the shared
+     * buckets and detaches the cache from this pool. Threads that outlive the
+     * pool must call this before the pool is destroyed. */
+    void release_current_thread_cache();
+#endif
+
 protected:
     /** Free buffer queue */
     Bucket *buckets;
@@ -558,6 +604,46 @@ private:
      */
     void free(BufferBase *item) override;
 
+#if OPENMRN_HAVE_BUFFER_THREAD_CACHE
+    struct ThreadCache;
+    struct ThreadCacheList;
+
+    /// @return the cache of the current thread for this pool. Creates it if
+    /// needed.
+    ThreadCache *thread_cache();
+
+    /** Allocates from the current thread's magazine, refilling it from the
+     * bucket if needed.
+     * @param idx bucket index.
+     * @return the free buffer or nullptr if the bucket is empty as well. */
+    BufferBase *cache_alloc(unsigned idx);
+
+    /** Puts a free buffer into the current thread's magazine.
+     * @param idx bucket index @param item the buffer to release. */
+    void cache_free(unsigned idx, BufferBase *item);
+
+    /** Returns buffers from a magazine to the shared bucket.
+     * @param c thread cache @param idx bucket index @param keep how many
+     * buffers (the most recently freed ones) to keep in the magazine. */
+    void return_buffers(ThreadCache *c, unsigned idx, unsigned keep);
+
+    /** Returns all buffers in a thread cache to the buckets, and unregisters
+     * the cache. Must be called on the thread owning the cache.
+     * @param c thread cache. */
+    void release_thread_cache(ThreadCache *c);
+
+    /// Per-thread cache lists.
+    static thread_local ThreadCacheList tlsCaches_;
+    /// Registry of all thread caches for this pool. Protected by the lock.
+    ThreadCache *threadCaches_ {nullptr};
+    /// Maximum number of buffers in a magazine. 0 if caches are disabled.
+    unsigned magazineSize_ {0};
+    /// Number of buckets.
+    unsigned numBuckets_ {0};
+    /// Statistics of the thread caches that were already released.
+    ThreadCacheStats retiredStats_ {0, 0, 0};
+#endif
+
     /** Default constructor.
      */
     DynamicPool();
@@ -63,29 +63,52 @@ DataBufferPool g_direct_hub_kbyte_pool(1024);
 /// A single service class that is shared between all interconnected DirectHub
 /// instances. It is the responsibility of this Service to perform the locking
 /// of the individual flows.
-class DirectHubService : public Service
+///
+/// The service also implements the admission controller. Callers that cannot
+/// be served immediately are queued per source. The sources are served in a
+/// round robin manner, and each source's turn lasts until it used up its
+/// budget of bytes or packets, or it has nothing more to send. A source that
+/// keeps calling the hub inline and exceeds its budget is pushed back
+/// asynchronously: the next call is executed via the executor queue instead of
+/// inline, which gives the other flows on that executor a chance to reach the
+/// hub.
+class DirectHubService : public Service, private Atomic
 {
 public:
-    typedef Q QueueType;
-
     DirectHubService(ExecutorBase *e)
         : Service(e)
         , busy_(0)
     {
+        start_turn(nullptr);
+    }
+
+    ~DirectHubService()
+    {
+        for (SourceQueue *q : active_)
+        {
+            delete q;
+        }
+        for (SourceQueue *q : freeQueues_)
+        {
+            delete q;
+        }
     }
 
     /// @return lock object for the busy_ flag.
     Atomic *lock()
     {
-        return pendingSend_.lock();
+        return this;
     }
 
     /// Adds a caller to the waiting list of who wants to send traffic to the
-    /// hub. If there is no waiting list, the caller will be executed inline.
+    /// hub. If there is no waiting list, and the caller's source has budget
+    /// left, the caller will be executed inline.
     /// @param caller represents an entry point to the hub. It is required that
     /// caller finishes its run() by invoking on_done().
-    void enqueue_caller(Executable *caller)
+    /// @param source the port on whose behalf the caller is sending.
+    void enqueue_caller(Executable *caller, HubSource *source)
     {
+        bool caller_to_executor = false;
         {
             AtomicHolder h(lock());
             if (busy_)
@@ -104,10 +127,29 @@ public:
                 /// dumping them into the executor. We would also need to keep
                 /// track of how many went to the Executor already, such that
                 /// we know when busy_ gets back to false.
-                pendingSend_.insert_locked(caller);
+                find_or_add_queue(source)->callers_.insert_locked(caller);
                 return;
             }
+            // When we are not busy, there is nobody waiting.
             busy_ = 1;
+            if (source != turnSource_)
+            {
+                start_turn(source);
+            }
+            else if (!has_budget())
+            {
+                // Back-pressure: this source has been sending inline for too
+                // long. We start a new turn but yield first, such that any
+                // other flow that is already queued on the executor gets to
+                // run (and maybe enqueue itself here).
+                start_turn(source);
+                caller_to_executor = true;
+            }
+        }
+        if (caller_to_executor)
+        {
+            executor()->add(caller);
+            return;
         }
         caller->run();
     }
@@ -115,27 +157,124 @@ public:
     /// This function must be called at the end of the enqueued functions in
     /// order to properly clear the busy flag or take out the next enqueued
     /// executable.
-    void on_done()
+    /// @param packets how many packets the caller sent.
+    /// @param bytes how many bytes the caller sent.
+    void on_done(unsigned packets = 0, size_t bytes = 0)
     {
-        // De-queues the next entry.
-        Result deq;
+        Executable *next;
         {
             AtomicHolder h(lock());
-            if (pendingSend_.empty())
+            packetBudget_ -= packets;
+            byteBudget_ -= bytes;
+            if (active_.empty())
             {
                 busy_ = 0;
                 return;
             }
-            deq = pendingSend_.next();
+            next = next_caller();
         }
         // Schedules it on the executor.
-        executor()->add(static_cast<Executable *>(deq.item), deq.index);
+        executor()->add(next, 0);
+    }
+
+private:
+    /// Callers of a single source that are waiting for the hub.
+    struct SourceQueue
+    {
+        /// Which port these callers belong to.
+        HubSource *source_;
+        /// The waiting callers in FIFO order.
+        Q callers_;
+    };
+
+    /// @return true if the current turn's source has not used up its budget.
+    bool has_budget()
+    {
+        return (!config_directhub_source_packet_budget() ||
+                   packetBudget_ > 0) &&
+            (!config_directhub_source_byte_budget() || byteBudget_ > 0);
+    }
+
+    /// Gives the turn to a given source with a full budget.
+    /// @param source the port whose callers will be served next.
+    void start_turn(HubSource *source)
+    {
+        turnSource_ = source;
+        packetBudget_ = config_directhub_source_packet_budget();
+        byteBudget_ = config_directhub_source_byte_budget();
+    }
+
+    /// Looks up the waiting queue of a source, creating it at the end of the
+    /// round robin list if it does not exist. Must be called with the lock
+    /// held.
+    /// @param source the port for which to look up the queue.
+    /// @return the waiting list for the callers of source.
+    SourceQueue *find_or_add_queue(HubSource *source)
+    {
+        for (SourceQueue *q : active_)
+        {
+            if (q->source_ == source)
+            {
+                return q;
+            }
+        }
+        SourceQueue *q;
+        if (freeQueues_.empty())
+        {
+            q = new SourceQueue;
+        }
+        else
+        {
+            q = freeQueues_.back();
+            freeQueues_.pop_back();
+        }
+        q->source_ = source;
+        active_.push_back(q);
+        return q;
+    }
+
+    /// Performs the round robin selection of who shall send the next
+    /// message. Must be called with the lock held, and active_ being
+    /// non-empty.
+    /// @return the caller to execute next.
+    Executable *next_caller()
+    {
+        SourceQueue *q = active_.front();
+        if (q->source_ == turnSource_ && !has_budget() && active_.size() > 1)
+        {
+            // End of turn: goes to the back of the list.
+            active_.erase(active_.begin());
+            active_.push_back(q);
+            q = active_.front();
+        }
+        if (q->source_ != turnSource_ || !has_budget())
+        {
+            start_turn(q->source_);
+        }
+        auto *caller =
+            static_cast<Executable *>(q->callers_.next_locked().item);
+        if (q->callers_.empty())
+        {
+            // Source has no more to send, its turn ends.
+            active_.erase(active_.begin());
+            freeQueues_.push_back(q);
+        }
+        return caller;
     }
 
     /// 1 if there is any message being processed right now.
     unsigned busy_ : 1;
-    /// List of callers that are waiting for the busy_ lock.
-    QueueType pendingSend_;
+    /// Sources that have callers waiting for the busy_ lock, in round robin
+    /// order. The front is the source whose turn it is.
+    std::vector<SourceQueue *> active_;
+    /// Recycled SourceQueue objects that are currently unused.
+    std::vector<SourceQueue *> freeQueues_;
+    /// The source that was most recently served by the hub.
+    HubSource *turnSource_ = nullptr;
+    /// How many more packets turnSource_ may send in the current turn.
+    int packetBudget_ = 0;
+    /// How many more bytes turnSource_ may send in the current turn.
+    ssize_t byteBudget_ = 0;
 };
 
 template <class T>
@@ -188,12 +327,14 @@ public:
             }
             done->notify();
             service()->on_done();
-        }));
+        }), nullptr);
     }
 
-    void enqueue_send(Executable *caller) override
+    using DirectHubInterface<T>::enqueue_send;
+
+    void enqueue_send(Executable *caller, HubSource *source) override
     {
-        service()->enqueue_caller(caller);
+        service()->enqueue_caller(caller, source);
     }
 
     MessageAccessor<T> *mutable_message() override
@@ -222,8 +363,9 @@ public:
                 p->send(&msg_);
             }
         }
+        size_t bytes = message_bytes(&msg_);
         msg_.clear();
-        service()->on_done();
+        service()->on_done(1, bytes);
     }
 
     /// Filters a message going towards a specific output port.
@@ -240,6 +382,21 @@ private:
         return static_cast<DirectHubService *>(StateFlowBase::service());
     }
 
+    /// @param msg a message with byte stream payload.
+    /// @return the number of payload bytes, for the admission controller.
+    static size_t message_bytes(MessageAccessor<uint8_t[]> *msg)
+    {
+        return msg->buf_.size();
+    }
+
+    /// Typed messages are counted only in packets by the admission
+    /// controller.
+    /// @return 0.
+    template <class U> static size_t message_bytes(MessageAccessor<U> *msg)
+    {
+        return 0;
+    }
+
     /// Stores the registered output ports. Protected by Atomic *this.
     std::vector<DirectHubPort<T> *> ports_;
 
@@ -440,7 +597,7 @@ private:
             wait_and_call(STATE(send_callback));
             inlineCall_ = 1;
             sendComplete_ = 0;
-            parent_->hub_->enqueue_send(this); // causes the callback
+            parent_->hub_->enqueue_send(this, parent_); // causes the callback
             inlineCall_ = 0;
             if (sendComplete_)
             {
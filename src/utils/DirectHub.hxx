@@ -185,9 +185,28 @@ public:
     /// Signals that the caller wants to send a message to the hub. When the
     /// hub is ready for that, will execute *caller. This might happen inline
     /// within this function call, or on a different executor.
+    ///
+    /// The hub's admission controller serves the different sources in a
+    /// round robin fashion. A source that used up its byte or packet budget
+    /// will be called back asynchronously, after other sources had a chance
+    /// to send. The caller's thread is never blocked.
+    ///
     /// @param caller callback that actually sends the message. It is required
     /// to call do_send() inline.
-    virtual void enqueue_send(Executable *caller) = 0;
+    /// @param source identifies the port on whose behalf the message is
+    /// sent. This is the key for fair queueing. Should be the same as the
+    /// source_ that the caller will fill in the message.
+    virtual void enqueue_send(Executable *caller, HubSource *source) = 0;
+
+    /// Signals that the caller wants to send a message to the hub, when the
+    /// caller is not a port. All such callers share a single fair queueing
+    /// slot.
+    /// @param caller callback that actually sends the message. It is required
+    /// to call do_send() inline.
+    void enqueue_send(Executable *caller)
+    {
+        enqueue_send(caller, nullptr);
+    }
 
     /// Accessor to fill in the message payload. Must be called only from
     /// within the callback as invoked by enqueue_send.
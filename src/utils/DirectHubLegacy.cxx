@@ -80,7 +80,7 @@ public:
         wait_and_call(STATE(do_send));
         inlineRun_ = true;
         inlineComplete_ = false;
-        targetHub_->enqueue_send(this);
+        targetHub_->enqueue_send(this, (DirectHubPort<uint8_t[]> *)this);
         inlineRun_ = false;
         if (inlineComplete_)
         {
@@ -293,3 +293,78 @@ TEST_F(EepromTest, many_overflow) {
     EXPECT_AT(13, "abcd");
     EXPECT_EQ(s, e->activeSector_);
 }
+
+TEST_F(EepromTest, random_model) {
+    create();
+    string model(eeprom_size, '\xFF');
+    unsigned int seed = 42;
+    for (int i = 0; i < 2000; ++i) {
+        unsigned ofs = rand_r(&seed) % eeprom_size;
+        unsigned len = 1 + rand_r(&seed) % 16;
+        len = std::min(len, eeprom_size - ofs);
+        string payload;
+        for (unsigned j = 0; j < len; ++j) {
+            payload.push_back(rand_r(&seed) & 0xff);
+        }
+        write_to(ofs, payload);
+        model.replace(ofs, len, payload);
+        unsigned rofs = rand_r(&seed) % (eeprom_size - 20);
+        EXPECT_AT(rofs, model.substr(rofs, 20));
+        if (i % 500 == 499) {
+            // Reboot MCU
+            create(false);
+        }
+    }
+    EXPECT_AT(0, model);
+}
+
+TEST_F(EepromTest, benchmark_read_latency) {
+    create();
+    string payload(eeprom_size, 0);
+    for (unsigned i = 0; i < eeprom_size; ++i) {
+        payload[i] = i & 0xff;
+    }
+    write_to(0, payload);
+    for (int i = 0; i < 3; ++i) {
+        write_to(100, payload.substr(i, 200));
+    }
+    payload.replace(100, 200, payload.substr(2, 200));
+
+    static constexpr unsigned NUM_READS = 2000;
+    uint8_t buf[8];
+    long long start = os_get_time_monotonic();
+    for (unsigned i = 0; i < NUM_READS; ++i) {
+        ee()->read((i * 37) % (eeprom_size - 8), buf, 8);
+    }
+    long long elapsed = os_get_time_monotonic() - start;
+    LOG(INFO, "shadow %d index group %u: %.2f usec per 8-byte read",
+        EEPROMEmulation::SHADOW_IN_RAM, EEPROMEmulation::RAM_INDEX_GROUP_SIZE,
+        elapsed / 1000.0 / NUM_READS);
+    EXPECT_AT(0, payload);
+}
+
+TEST_F(EepromTest, benchmark_boot_scan) {
+    create();
+    string payload(eeprom_size, 0);
+    for (unsigned i = 0; i < eeprom_size; ++i) {
+        payload[i] = (i * 7) & 0xff;
+    }
+    write_to(0, payload);
+    write_to(500, "abcdefgh");
+    payload.replace(500, 8, "abcdefgh");
+
+    // Reboot MCU, then load the entire config in 8-byte entries.
+    long long start = os_get_time_monotonic();
+    create(false);
+    long long mounted = os_get_time_monotonic();
+    string loaded(eeprom_size, 0);
+    for (unsigned ofs = 0; ofs < eeprom_size; ofs += 8) {
+        ee()->read(ofs, &loaded[ofs], std::min(8u, eeprom_size - ofs));
+    }
+    long long end = os_get_time_monotonic();
+    LOG(INFO, "shadow %d index group %u: mount %.2f msec, config load %.2f "
+              "msec",
+        EEPROMEmulation::SHADOW_IN_RAM, EEPROMEmulation::RAM_INDEX_GROUP_SIZE,
+        (mounted - start) / 1e6, (end - mounted) / 1e6);
+    EXPECT_EQ(payload, loaded);
+}
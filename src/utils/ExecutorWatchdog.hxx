@@ -37,11 +37,13 @@
 
 #include "executor/StateFlow.hxx"
 #include "os/os.h"
+#include "utils/Stats.hxx"
 #include "utils/logging.h"
 
 /// This stateflow checks an executor every 50 msec. If the latency of a wakeup
 /// is more than 50 msec, then prints a warning of how long the executor was
-/// blocked.
+/// blocked. The distribution of the wakeup delays is kept in a histogram,
+/// and the percentiles are printed with the periodic heartbeat message.
 class ExecutorWatchdog : public StateFlowBase
 {
 public:
@@ -53,6 +55,16 @@ public:
         start_flow(STATE(take_stamp));
     }
 
+    /// Histogram of how late the watchdog was woken up (in msec). Values are
+    /// capped at 65 seconds.
+    using LatencyHistogram = Histogram<3, 16>;
+
+    /// @return the histogram of the wakeup latencies observed so far.
+    const LatencyHistogram &latency()
+    {
+        return latency_;
+    }
+
 private:
     Action take_stamp()
     {
@@ -64,6 +76,7 @@ private:
     {
         uint32_t new_time_msec = NSEC_TO_MSEC(os_get_time_monotonic());
         auto diff = new_time_msec - lastTimeMsec_;
+        latency_.add(diff > 50 ? diff - 50 : 0);
         if (diff > 100)
         {
             LOG(WARNING, "[WARN] Executor was blocked for %d msec",
@@ -72,7 +85,8 @@ private:
         if (++count_ > (5000 / 50))
         {
             count_ = 0;
-            LOG(INFO, "Watchdog alive.");
+            LOG(INFO, "Watchdog alive. Wakeup latency %s",
+                latency_.debug_string(" msec").c_str());
         }
         return call_immediately(STATE(take_stamp));
     }
@@ -82,6 +96,8 @@ private:
     uint32_t lastTimeMsec_ {0};
     /// Counter that controls printing a heartbeat message that we are fine.
     int count_ {0};
+    /// Distribution of the wakeup latencies.
+    LatencyHistogram latency_;
 };
 
 #endif // _UTILS_EXECUTORWATCHDOG_HXX_
@@ -32,9 +32,11 @@
  * @date 26 May 2016
  */
 
+#include <string.h>
 #include <string>
 
 #include "utils/GcStreamParser.hxx"
+#include "can_frame.h"
 #include "utils/gc_format.h"
 
 bool GcStreamParser::consume_byte(char c)
@@ -87,3 +89,66 @@ bool GcStreamParser::parse_frame_to_output(struct can_frame* output_frame) {
     int ret = gc_format_parse(cbuf_, output_frame);
     return (ret == 0);
 }
+
+unsigned GcStreamParser::parse_batch(const char *data, size_t len,
+    struct can_frame *frames, unsigned max_frames, size_t *consumed)
+{
+    const char *p = data;
+    const char *end = data + len;
+    unsigned num_frames = 0;
+    while (p < end && num_frames < max_frames)
+    {
+        if (offset_ >= 0)
+        {
+            // Finishes a frame that was started in an earlier call.
+            if (consume_byte(*p++) &&
+                parse_frame_to_output(frames + num_frames))
+            {
+                ++num_frames;
+            }
+            continue;
+        }
+        const char *start = (const char *)memchr(p, ':', end - p);
+        if (!start)
+        {
+            // Nothing but garbage.
+            p = end;
+            break;
+        }
+        // Finds the end of the frame with the same rules as consume_byte.
+        const char *limit = start + sizeof(cbuf_);
+        const char *q = start + 1;
+        while (q < end && *q != ';' && *q != ':' && q < limit)
+        {
+            ++q;
+        }
+        if (q == end)
+        {
+            // Partial frame. Saves the data for the next call.
+            offset_ = q - start - 1;
+            memcpy(cbuf_, start + 1, offset_);
+            p = end;
+        }
+        else if (*q == ':')
+        {
+            // Restarts the frame.
+            p = q;
+        }
+        else if (*q == ';')
+        {
+            // gc_format_parse stops at the ';' terminator.
+            if (gc_format_parse(start + 1, frames + num_frames) == 0)
+            {
+                ++num_frames;
+            }
+            p = q + 1;
+        }
+        else
+        {
+            // Frame too long; drops it.
+            p = q + 1;
+        }
+    }
+    *consumed = p - data;
+    return num_frames;
+}
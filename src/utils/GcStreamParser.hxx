@@ -35,8 +35,11 @@
 #ifndef _UTILS_GCSTREAMPARSER_HXX_
 #define _UTILS_GCSTREAMPARSER_HXX_
 
+#include <stddef.h>
 #include <string>
 
+struct can_frame;
+
 /**
    Parses a sequence of characters; finds GridConnect protocol packet
    boundaries in the sequence of packets. Contains an internal buffer holding
@@ -66,6 +69,24 @@ public:
      * the frame is set to an error frame. */
     bool parse_frame_to_output(struct can_frame *output_frame);
 
+    /** Parses a block of characters from the source stream into CAN frames.
+     * Equivalent to calling consume_byte for each character and
+     * parse_frame_to_output for each complete frame, but frames that are
+     * entirely contained in the input are parsed in place, without copying.
+     * Frames with parse errors are dropped. Partial frames at the end of the
+     * input are kept in the internal buffer for the next call.
+     *
+     * @param data the incoming characters.
+     * @param len number of bytes in data.
+     * @param frames output array of parsed frames.
+     * @param max_frames how many entries frames has. Parsing stops when this
+     * many frames were found.
+     * @param consumed will be set to the number of bytes of data that were
+     * processed. This is len unless max_frames was reached.
+     * @return number of frames written to frames. */
+    unsigned parse_batch(const char *data, size_t len,
+        struct can_frame *frames, unsigned max_frames, size_t *consumed);
+
     /** @param payload fills with the current contents of the frame buffer. */
     void frame_buffer(std::string *payload);
 
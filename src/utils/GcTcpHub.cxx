@@ -35,6 +35,7 @@
 
 #include <memory>
 
+#include "executor/ExecutorPool.hxx"
 #include "nmranet_config.h"
 #include "utils/GridConnectHub.hxx"
 #include "utils/FdUtils.hxx"
@@ -49,7 +50,8 @@ void GcTcpHub::on_new_connection(int fd)
     }
     // Applies kernel parameters like socket options.
     FdUtils::optimize_socket_fd(fd);
-    create_gc_port_for_can_hub(canHub_, fd, this, use_select);
+    create_gc_port_for_can_hub(canHub_, fd, this, use_select,
+        pool_ ? pool_->service_for(fd) : nullptr);
 }
 
 void GcTcpHub::notify()
@@ -61,8 +63,9 @@ void GcTcpHub::notify()
     }
 }
 
-GcTcpHub::GcTcpHub(CanHubFlow *can_hub, int port)
+GcTcpHub::GcTcpHub(CanHubFlow *can_hub, int port, ExecutorPool *pool)
     : canHub_(can_hub)
+    , pool_(pool)
     , tcpListener_(port,
           std::bind(&GcTcpHub::on_new_connection, this, std::placeholders::_1),
           "GcTcpHub")
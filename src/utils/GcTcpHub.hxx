@@ -38,6 +38,7 @@
 #include "utils/Hub.hxx"
 
 class ExecutorBase;
+class ExecutorPool;
 
 /** This class runs a CAN-bus HUB listening on TCP socket using the gridconnect
  * format. Any new incoming connection will be wired into the same virtual CAN
@@ -51,7 +52,11 @@ public:
     /// @param can_hub Which CAN-hub should we attach the TCP gridconnect hub
     /// onto.
     /// @param port TCp port number to listen on.
-    GcTcpHub(CanHubFlow *can_hub, int port);
+    /// @param pool if not null, the incoming connections will be distributed
+    /// among the threads of this pool. Each connection's gridconnect hub and
+    /// socket I/O runs on one of the pool's threads instead of the CAN hub's
+    /// executor.
+    GcTcpHub(CanHubFlow *can_hub, int port, ExecutorPool *pool = nullptr);
     ~GcTcpHub();
 
     /// @return true of the listener is ready to accept incoming connections.
@@ -80,6 +85,8 @@ private:
     /// @param can_hub Which CAN-hub should we attach the TCP gridconnect hub
     /// onto.
     CanHubFlow *canHub_;
+    /// If not null, the connections' ports run on this pool.
+    ExecutorPool *pool_;
     /// How many clients are connected right now.
     unsigned numClients_ {0};
     /// Helper object representing the listening on the socket.
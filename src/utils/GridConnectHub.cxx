@@ -62,7 +62,7 @@ public:
     /// @param double_bytes if true, upon rendering data each byte will be
     /// doubled. This is an anciant workaround.
     GCAdapter(HubFlow *gc_side, CanHubFlow *can_side, bool double_bytes)
-        : parser_(can_side->service(), can_side, &formatter_)
+        : parser_(gc_side->service(), can_side, &formatter_)
         , formatter_(can_side->service(), gc_side, &parser_, double_bytes)
     {
         gc_side->register_port(&parser_);
@@ -81,7 +81,7 @@ public:
     /// doubled. This is an anciant workaround.
     GCAdapter(HubFlow *gc_side_read, HubFlow *gc_side_write,
         CanHubFlow *can_side, bool double_bytes)
-        : parser_(can_side->service(), can_side, &formatter_)
+        : parser_(gc_side_read->service(), can_side, &formatter_)
         , formatter_(can_side->service(), gc_side_write, &parser_, double_bytes)
     {
         gc_side_read->register_port(&parser_);
@@ -284,6 +284,8 @@ public:
         {
             inBuf_ = message()->data()->data();
             inBufSize_ = message()->data()->size();
+            numFrames_ = 0;
+            nextFrame_ = 0;
             return call_immediately(STATE(parse_more_data));
         }
 
@@ -291,36 +293,52 @@ public:
         /// frames. @return next state.
         Action parse_more_data()
         {
-            while (inBufSize_--)
+            if (nextFrame_ < numFrames_)
             {
-                char c = *inBuf_++;
-                if (streamSegmenter_.consume_byte(c))
-                {
-                    // End of frame. Allocate an output buffer and parse the
-                    // frame.
-                    return allocate_and_call(destination_, STATE(parse_to_output_frame), frameAllocator_.get());
-                }
+                // Frames left over from the last batch that need a buffer
+                // from the limited pool.
+                return allocate_and_call(destination_,
+                    STATE(parse_to_output_frame), frameAllocator_.get());
             }
-            // Will notify the caller.
-            return release_and_exit();
+            size_t consumed;
+            numFrames_ = streamSegmenter_.parse_batch(
+                inBuf_, inBufSize_, frames_, MAX_BATCH, &consumed);
+            nextFrame_ = 0;
+            inBuf_ += consumed;
+            inBufSize_ -= consumed;
+            if (!numFrames_)
+            {
+                // Will notify the caller.
+                return release_and_exit();
+            }
+            if (frameAllocator_)
+            {
+                // The number of frames in flight is limited; allocates the
+                // output buffers one by one.
+                return allocate_and_call(destination_,
+                    STATE(parse_to_output_frame), frameAllocator_.get());
+            }
+            // Forwards the entire batch.
+            for (unsigned i = 0; i < numFrames_; ++i)
+            {
+                auto *b = destination_->alloc();
+                *b->data()->mutable_frame() = frames_[i];
+                b->data()->skipMember_ = skipMember_;
+                destination_->send(b);
+            }
+            numFrames_ = 0;
+            return again();
         }
 
-        /** Takes the completed frame in cbuf_, parses it into the allocation
-         * result (a can pipe buffer) and sends off frame. Then comes back to
-         * process buffer. @return next state. */
+        /** Copies the next parsed frame into the allocation result (a can
+         * pipe buffer) and sends off frame. Then comes back to process
+         * buffer. @return next state. */
         Action parse_to_output_frame()
         {
             auto* b = get_allocation_result(destination_);
-            if (streamSegmenter_.parse_frame_to_output(b->data()))
-            {
-                b->data()->skipMember_ = skipMember_;
-                destination_->send(b);
-            }
-            else
-            {
-                // Releases the buffer.
-                b->unref();
-            }
+            *b->data()->mutable_frame() = frames_[nextFrame_++];
+            b->data()->skipMember_ = skipMember_;
+            destination_->send(b);
             return call_immediately(STATE(parse_more_data));
         }
 
@@ -328,6 +346,14 @@ public:
         /// Holds the state of the incoming characters and the boundary.
         GcStreamParser streamSegmenter_;
         
+        /// How many frames to parse from the input in one go.
+        static constexpr unsigned MAX_BATCH = 8;
+        /// The frames parsed last, waiting for output buffers.
+        struct can_frame frames_[MAX_BATCH];
+        /// Number of entries in frames_.
+        uint8_t numFrames_;
+        /// Index of the next entry in frames_ to send.
+        uint8_t nextFrame_;
         /// The incoming characters.
         const char *inBuf_;
         /// The remaining number of characters in inBuf_.
@@ -448,11 +474,17 @@ struct GcHubPort : public Executable
     /// experiences an error (typically upon device closed or connection lost).
     /// @param use_select true if fd can be used with select, false if threads
     /// are needed.
-    GcHubPort(CanHubFlow *can_hub, int fd, Notifiable *on_exit, bool use_select)
-        : gcHub_(can_hub->service())
+    /// @param port_service if not null, the gridconnect hub, the device and
+    /// the parsing of the incoming data will run on this service instead of
+    /// the CAN hub's service. The formatting of the outgoing frames always
+    /// runs on the CAN hub's service.
+    GcHubPort(CanHubFlow *can_hub, int fd, Notifiable *on_exit, bool use_select,
+        Service *port_service)
+        : gcHub_(port_service ? port_service : can_hub->service())
         , bridge_(
               GCAdapterBase::CreateGridConnectAdapter(&gcHub_, can_hub, false))
         , onExit_(on_exit)
+        , canExecutor_(can_hub->service()->executor())
     {
         LOG(VERBOSE, "gchub port %p", (Executable *)this);
         if (use_select) {
@@ -489,6 +521,19 @@ struct GcHubPort : public Executable
     /** If not null, this notifiable will be called when the device is
      * closed. */
     Notifiable* onExit_;
+    /** Executor of the CAN hub; the bridge has to be shut down here. */
+    ExecutorBase *canExecutor_;
+    /** Where the shutdown sequence in run() is at. */
+    enum
+    {
+        /// Waiting for the bridge to unregister and drain (CAN executor).
+        SHUTDOWN_BRIDGE,
+        /// Waiting for the gridconnect hub to drain (gcHub_ executor).
+        DRAIN_HUB,
+        /// Checking that the bridge got no more data from the gridconnect hub
+        /// meanwhile (CAN executor).
+        CONFIRM_BRIDGE
+    } exitState_ {SHUTDOWN_BRIDGE};
 
     /** Callback in case the connection is closed due to error. */
     void notify() OVERRIDE
@@ -496,17 +541,58 @@ struct GcHubPort : public Executable
         /* We would like to delete *this but we cannot do that in this
          * callback, because we don't know what executor we are running
          * on. Deleting on the write executor would cause a deadlock for
-         * example. */
-        gcHub_.service()->executor()->add(this);
+         * example. The teardown starts on the CAN hub's executor, see
+         * run(). */
+        canExecutor_->add(this);
     }
 
+    /// Tears down the port. The gridconnect hub may be on a different
+    /// executor than the CAN hub (and thus the bridge). In that case this
+    /// alternates between the two executors: each object is only looked at
+    /// on the executor that it runs on.
     void run() OVERRIDE
     {
-        if (!bridge_->shutdown() || !gcHub_.is_waiting())
+        ExecutorBase *gc_executor = gcHub_.service()->executor();
+        switch (exitState_)
         {
-            // Yield.
-            gcHub_.service()->executor()->add(this);
-            return;
+            case SHUTDOWN_BRIDGE:
+                if (!bridge_->shutdown())
+                {
+                    // Yield.
+                    canExecutor_->add(this);
+                    return;
+                }
+                if (gc_executor != canExecutor_)
+                {
+                    exitState_ = DRAIN_HUB;
+                    gc_executor->add(this);
+                    return;
+                }
+                if (!gcHub_.is_waiting())
+                {
+                    canExecutor_->add(this);
+                    return;
+                }
+                break;
+            case DRAIN_HUB:
+                if (gcHub_.is_waiting())
+                {
+                    exitState_ = CONFIRM_BRIDGE;
+                    canExecutor_->add(this);
+                }
+                else
+                {
+                    gc_executor->add(this);
+                }
+                return;
+            case CONFIRM_BRIDGE:
+                if (!bridge_->shutdown())
+                {
+                    exitState_ = SHUTDOWN_BRIDGE;
+                    canExecutor_->add(this);
+                    return;
+                }
+                break;
         }
         LOG(INFO, "GCHubPort: Shutting down gridconnect port %d. (%p)",
             gcWrite_->fd(), bridge_.get());
@@ -522,8 +608,8 @@ struct GcHubPort : public Executable
     }
 };
 
-void create_gc_port_for_can_hub(
-    CanHubFlow *can_hub, int fd, Notifiable *on_exit, bool use_select)
+void create_gc_port_for_can_hub(CanHubFlow *can_hub, int fd,
+    Notifiable *on_exit, bool use_select, Service *port_service)
 {
-    new GcHubPort(can_hub, fd, on_exit, use_select);
+    new GcHubPort(can_hub, fd, on_exit, use_select, port_service);
 }
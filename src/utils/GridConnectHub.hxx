@@ -70,6 +70,10 @@ public:
        in GridConnect protocol, and the other carrying CAN frames in the binary
        protocol.
 
+       The parsing is performed on the executor of the gc_side hub, the
+       formatting on the executor of the CAN side hub. The two may be
+       different.
+
        @param gc_side is the Hub that has the ASCII GridConnect traffic.
 
        @param can_side is the Hub that has the binary CAN traffic.
@@ -86,6 +90,8 @@ public:
 
     /// Creates a gridconnect-CAN bridge with separate pipes for reading
     /// (parsing) from the GC side and writing (formatting) to the GC side. */
+    /// The parsing is performed on the executor of the gc_side_read hub, the
+    /// formatting on the executor of the CAN side hub.
     ///
     /// @param gc_side_read is the Hub that the GridConnect traffic is read
     /// from, to be converted and sent to binary.
@@ -135,8 +141,15 @@ private:
  * @param on_exit is a notifiable (may be null) which will be called in case
  * an error is encountered on this port and the port is subsequently closed.
  * @param use_select when true, the FD will be used with select, when false,
- * separate threads will be started with blocking read and write calls. */
+ * separate threads will be started with blocking read and write calls.
+ * @param port_service if not null, the gridconnect hub as well as the
+ * select-based fd reads and writes of this port will run on this service's
+ * executor instead of the CAN hub's. Used for spreading the ports of a hub
+ * over multiple threads (see ExecutorPool). The gridconnect parsing runs on
+ * this service too; the formatting stays on the CAN hub's executor, because
+ * it is a member of the CAN hub. */
 void create_gc_port_for_can_hub(CanHubFlow *can_hub, int fd,
-    Notifiable *on_exit = nullptr, bool use_select = false);
+    Notifiable *on_exit = nullptr, bool use_select = false,
+    Service *port_service = nullptr);
 
 #endif //_UTILS_GRIDCONNECTHUB_HXX_
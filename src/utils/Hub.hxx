@@ -237,6 +237,7 @@ namespace openlcb
 {
 class FdToTcpParser;
 }
+class SocketCanBatchReadFlow;
 
 /** Shared base class for thread-based and select-based hub devices. */
 class FdHubPortService : public FdHubPortInterface, public Service
@@ -252,6 +253,7 @@ protected:
     // For barrier_.
     template <class HFlow> friend class HubDeviceSelectReadFlow;
     friend class openlcb::FdToTcpParser;
+    friend class SocketCanBatchReadFlow;
 
     /// Constructor
     /// @param exec executor for the service.
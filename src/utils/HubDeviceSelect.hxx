@@ -283,6 +283,74 @@ private:
     typename HFlow::port_type *skipMember_;
 };
 
+/// State flow implementing select-aware fd writes.
+template <class HFlow>
+class HubDeviceSelectWriteFlow
+    : public StateFlow<typename HFlow::buffer_type, QList<1>>
+{
+public:
+    /// Base stateflow for the WriteFlow.
+    typedef StateFlow<typename HFlow::buffer_type, QList<1>> Base;
+
+    /// Constructor. @param dev is the parent object.
+    HubDeviceSelectWriteFlow(FdHubPortService *dev)
+        : Base(dev)
+    {
+    }
+
+    /// Destructor.
+    ~HubDeviceSelectWriteFlow()
+    {
+        HASSERT(this->is_waiting());
+    }
+
+    /// Unregisters this object from the flows.
+    void shutdown()
+    {
+        // The fd must be set to negative already to ensure the shutdown
+        // completes successfully.
+        HASSERT(device()->fd() < 0);
+        auto* e = this->service()->executor();
+        if (!selectHelper_.is_empty() && e->is_selected(&selectHelper_)) {
+            e->unselect(&selectHelper_);
+            // will make the internal_try_write exit immediately
+            selectHelper_.remaining_ = 0;
+            // actually wake up the flow
+            this->notify();
+        }
+    }
+
+    /// @return parent object.
+    FdHubPortService *device()
+    {
+        return static_cast<FdHubPortService *>(this->service());
+    }
+
+    StateFlowBase::Action entry() OVERRIDE
+    {
+        if (device()->fd() < 0) {
+            return this->release_and_exit();
+        }
+        return this->write_repeated(&selectHelper_, device()->fd(),
+            this->message()->data()->data(),
+            this->message()->data()->size(), STATE(write_done),
+            this->priority());
+    }
+
+    /// State flow call. @return next state.
+    StateFlowBase::Action write_done()
+    {
+        if (selectHelper_.hasError_) {
+            device()->report_write_error();
+        }
+        return this->release_and_exit();
+    }
+
+private:
+    /// Helper class for asynchronous writes.
+    StateFlowBase::StateFlowSelectHelper selectHelper_{this};
+};
+
 /// HubPort that connects a select-aware device to a strongly typed Hub.
 ///
 /// The device is given by either the path to the device or the fd to an opened
@@ -294,7 +362,12 @@ private:
 /// hub: for string-typed hubs in 64 bytes units; for hubs of specific
 /// structures (such as CAN frame, dcc Packets or dcc Feedback structures) in
 /// the units ofthe size of the structure.
-template <class HFlow, class ReadFlow = HubDeviceSelectReadFlow<HFlow>>
+///
+/// The ReadFlow and WriteFlow template arguments allow replacing the
+/// implementation of the I/O for specific device types, for example to
+/// transfer multiple packets per system call.
+template <class HFlow, class ReadFlow = HubDeviceSelectReadFlow<HFlow>,
+    class WriteFlow = HubDeviceSelectWriteFlow<HFlow>>
 class HubDeviceSelect : public FdHubPortService, private Atomic
 {
 public:
@@ -379,6 +452,18 @@ public:
         return &writeFlow_;
     }
 
+    /// @return the flow reading the device.
+    ReadFlow *read_flow()
+    {
+        return &readFlow_;
+    }
+
+    /// @return the flow writing to the device.
+    WriteFlow *write_flow()
+    {
+        return &writeFlow_;
+    }
+
     /// Removes the current write port from the registry of the source hub.
     void unregister_write_port()
     {
@@ -409,73 +494,6 @@ public:
     }
 
 protected:
-    /// Base stateflow for the WriteFlow.
-    typedef StateFlow<typename HFlow::buffer_type, QList<1>> WriteFlowBase;
-    /// State flow implementing select-aware fd writes.
-    class WriteFlow : public WriteFlowBase
-    {
-    public:
-        /// Constructor. @param dev is the parent object.
-        WriteFlow(HubDeviceSelect *dev)
-            : WriteFlowBase(dev)
-        {
-        }
-
-        /// Destructor.
-        ~WriteFlow()
-        {
-            HASSERT(this->is_waiting());
-        }
-
-        /// Unregisters this object from the flows.
-        void shutdown()
-        {
-            // The fd must be set to negative already to ensure the shutdown
-            // completes successfully.
-            HASSERT(device()->fd() < 0);
-            auto* e = this->service()->executor();
-            if (!selectHelper_.is_empty() && e->is_selected(&selectHelper_)) {
-                e->unselect(&selectHelper_);
-                // will make the internal_try_write exit immediately
-                selectHelper_.remaining_ = 0;
-                // actually wake up the flow
-                this->notify();
-            }
-        }
-
-        /// @return parent object.
-        HubDeviceSelect *device()
-        {
-            return static_cast<HubDeviceSelect *>(this->service());
-        }
-
-        StateFlowBase::Action entry() OVERRIDE
-        {
-            if (device()->fd() < 0) {
-                return this->release_and_exit();
-            }
-            return this->write_repeated(&selectHelper_, device()->fd(),
-                this->message()->data()->data(),
-                this->message()->data()->size(), STATE(write_done),
-                this->priority());
-        }
-
-        /// State flow call. @return next state.
-        StateFlowBase::Action write_done()
-        {
-            if (selectHelper_.hasError_) {
-                device()->report_write_error();
-            }
-            return this->release_and_exit();
-        }
-
-    private:
-        /// Helper class for asynchronous writes.
-        StateFlowBase::StateFlowSelectHelper selectHelper_{this};
-    };
-
-protected:
-
     /** The assumption here is that the write flow still has entries in its
      * queue that need to be removed. */
     void report_write_error() override
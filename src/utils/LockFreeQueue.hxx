@@ -0,0 +1,200 @@
+/** \copyright
+ * Copyright (c) 2026, Balazs Racz
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  - Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  - Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file LockFreeQueue.hxx
+ * Multiple producer single consumer priority queue without locks.
+ *
+ * @author Balazs Racz
+ * @date 17 Oct 2026
+ */
+
+#ifndef _UTILS_LOCKFREEQUEUE_HXX_
+#define _UTILS_LOCKFREEQUEUE_HXX_
+
+#include <atomic>
+
+#include "utils/Queue.hxx"
+
+/// A list of queues with the same API as QListProtected, but insert() does
+/// not take a lock. There may be any number of producer threads, but only one
+/// consumer thread (the one calling next()). Suitable as the run queue of an
+/// Executor, e.g. Executor<3, QListLockFree<3>>. Requires a native
+/// compare-and-swap instruction, so this is not usable on Cortex-M0.
+///
+/// Theory of operation: each priority band has an atomic LIFO stack (the
+/// inbox) where producers push entries using compare-and-swap. The consumer
+/// has a private FIFO per priority band. When the private FIFO of a band runs
+/// empty, the consumer takes over the entire inbox with a single atomic
+/// exchange, and appends its entries in reversed (i.e. arrival) order to the
+/// private FIFO. Since entries are never popped from the inbox one by one,
+/// there is no ABA problem.
+///
+/// Priority semantics are the same as QList: next() returns the oldest entry
+/// of the lowest numbered non-empty band. FIFO order within a band is kept
+/// for entries coming from the same producer thread.
+template <unsigned ITEMS> class QListLockFree
+{
+public:
+    QListLockFree()
+    {
+        for (unsigned i = 0; i < ITEMS; ++i)
+        {
+            inbox_[i].store(nullptr, std::memory_order_relaxed);
+            head_[i].store(nullptr, std::memory_order_relaxed);
+            tail_[i] = nullptr;
+        }
+    }
+
+    typedef ::Result Result;
+
+    /// Tells the Executor that insert() does not take a lock.
+    static constexpr bool LOCK_FREE_INSERT = true;
+
+    /** Add an item to the back of the queue. Can be called from any thread,
+     * and from interrupts.
+     * @param item to add to queue
+     * @param index in the list to operate on
+     */
+    void insert(QMember *item, unsigned index)
+    {
+        if (index >= ITEMS)
+        {
+            index = ITEMS - 1;
+        }
+        QMember *top = inbox_[index].load(std::memory_order_relaxed);
+        do
+        {
+            item->next = top;
+        } while (!inbox_[index].compare_exchange_weak(
+            top, item, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    /** Add an item to the back of the queue. Same as insert(), there is no
+     * lock to hold.
+     * @param item to add to queue
+     * @param index in the list to operate on
+     */
+    void insert_locked(QMember *item, unsigned index)
+    {
+        insert(item, index);
+    }
+
+    /** Get an item from the front of the queue queue in priority order. Must
+     * be called from the consumer thread.
+     * @return item retrieved from queue + index, NULL if no item available
+     */
+    Result next()
+    {
+        for (unsigned i = 0; i < ITEMS; ++i)
+        {
+            QMember *result = head_[i].load(std::memory_order_relaxed);
+            if (!result)
+            {
+                if (!drain(i))
+                {
+                    continue;
+                }
+                result = head_[i].load(std::memory_order_relaxed);
+            }
+            head_[i].store(result->next, std::memory_order_relaxed);
+            if (!result->next)
+            {
+                tail_[i] = nullptr;
+            }
+            result->next = nullptr;
+            return Result(result, i);
+        }
+        return Result();
+    }
+
+    /** Moves all entries that producers added to a given band into the
+     * consumer's private list in one atomic operation. Must be called from
+     * the consumer thread.
+     * @param index which band to drain.
+     * @return number of entries moved.
+     */
+    unsigned drain(unsigned index)
+    {
+        if (!inbox_[index].load(std::memory_order_relaxed))
+        {
+            return 0;
+        }
+        QMember *top =
+            inbox_[index].exchange(nullptr, std::memory_order_acquire);
+        // Reverses the stack into arrival order.
+        QMember *first = nullptr;
+        QMember *last = top;
+        unsigned count = 0;
+        while (top)
+        {
+            QMember *n = top->next;
+            top->next = first;
+            first = top;
+            top = n;
+            ++count;
+        }
+        if (tail_[index])
+        {
+            tail_[index]->next = first;
+        }
+        else
+        {
+            head_[index].store(first, std::memory_order_relaxed);
+        }
+        tail_[index] = last;
+        return count;
+    }
+
+    /** Test if all the queues are empty. The result is exact only when called
+     * from the consumer thread.
+     * @return true if empty (all lists), else false
+     */
+    bool empty()
+    {
+        for (unsigned i = 0; i < ITEMS; ++i)
+        {
+            if (head_[i].load(std::memory_order_relaxed) ||
+                inbox_[i].load(std::memory_order_acquire))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    /// Entries pushed by the producers, in LIFO order.
+    std::atomic<QMember *> inbox_[ITEMS];
+    /// First entry of the consumer's FIFO for each band. Atomic only so that
+    /// empty() may be called from other threads.
+    std::atomic<QMember *> head_[ITEMS];
+    /// Last entry of the consumer's FIFO for each band.
+    QMember *tail_[ITEMS];
+
+    DISALLOW_COPY_AND_ASSIGN(QListLockFree);
+};
+
+#endif // _UTILS_LOCKFREEQUEUE_HXX_
@@ -70,9 +70,13 @@ protected:
     friend class SimpleQueue;
     /** ActiveTimers needs to iterate through the queue. */
     friend class ActiveTimers;
+    /** TimerWheel links the timers into its slots. */
+    friend class TimerWheel;
     /** ActiveTimers needs to iterate through the queue. */
     friend class ExecutorBase;
     friend class TimerTest;
+    /** The lock-free queue links the entries itself. */
+    template <unsigned ITEMS> friend class QListLockFree;
 };
 
 #endif /* _UTILS_QMEMBER_HXX_ */
@@ -0,0 +1,237 @@
+/** \copyright
+ * Copyright (c) 2026, Balazs Racz
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are  permitted provided that the following conditions are met:
+ *
+ *  - Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  - Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file SocketCanBatch.cxx
+ *
+ * Hub port for SocketCan devices that transfers many CAN frames per system
+ * call.
+ *
+ * @author Balazs Racz
+ * @date 17 Oct 2026
+ */
+
+#include "utils/SocketCanBatch.hxx"
+
+#if defined(__linux__) && defined(OPENMRN_FEATURE_EXECUTOR_SELECT)
+
+#include <errno.h>
+#include <string.h>
+
+constexpr unsigned SocketCanBatchReadFlow::BATCH_SIZE;
+constexpr unsigned SocketCanBatchWriteFlow::BATCH_SIZE;
+
+SocketCanBatchReadFlow::SocketCanBatchReadFlow(FdHubPortService *device,
+    CanHubPortInterface *dst, CanHubPortInterface *skip_member)
+    : StateFlowBase(device)
+    , dst_(dst)
+    , skipMember_(skip_member)
+{
+    memset(msgs_, 0, sizeof(msgs_));
+    for (unsigned i = 0; i < BATCH_SIZE; ++i)
+    {
+        iov_[i].iov_base = &frames_[i];
+        iov_[i].iov_len = sizeof(frames_[i]);
+        msgs_[i].msg_hdr.msg_iov = &iov_[i];
+        msgs_[i].msg_hdr.msg_iovlen = 1;
+    }
+    start_flow(STATE(try_read));
+}
+
+void SocketCanBatchReadFlow::shutdown()
+{
+    auto *e = service()->executor();
+    if (!selectHelper_.is_empty() && e->is_selected(&selectHelper_))
+    {
+        e->unselect(&selectHelper_);
+    }
+    set_terminated();
+    notify_barrier();
+}
+
+StateFlowBase::Action SocketCanBatchReadFlow::try_read()
+{
+    int fd = device()->fd();
+    int ret = ::recvmmsg(fd, msgs_, BATCH_SIZE, MSG_DONTWAIT, nullptr);
+    if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+    {
+        selectHelper_.reset(Selectable::READ, fd, 0);
+        service()->executor()->select(&selectHelper_);
+        return wait();
+    }
+    if (ret <= 0)
+    {
+        return call_immediately(STATE(read_error));
+    }
+    ++numReads_;
+    // Sends the entire burst to the hub without yielding in between.
+    for (int i = 0; i < ret; ++i)
+    {
+        if (msgs_[i].msg_len != sizeof(struct can_frame))
+        {
+            // EOF or an unexpected (e.g. CAN-FD) frame.
+            return call_immediately(STATE(read_error));
+        }
+        auto *b = dst_->alloc();
+        b->data()->skipMember_ = skipMember_;
+        *b->data()->mutable_frame() = frames_[i];
+        dst_->send(b, 0);
+        ++numFrames_;
+    }
+    if (ret == (int)BATCH_SIZE)
+    {
+        // There might be more data. Lets the other flows run first.
+        return yield();
+    }
+    // The socket is most likely empty now. Saves a system call by going
+    // directly to select.
+    selectHelper_.reset(Selectable::READ, fd, 0);
+    service()->executor()->select(&selectHelper_);
+    return wait();
+}
+
+StateFlowBase::Action SocketCanBatchReadFlow::read_error()
+{
+    set_terminated();
+    device()->report_read_error();
+    notify_barrier();
+    return exit();
+}
+
+void SocketCanBatchReadFlow::notify_barrier()
+{
+    if (barrierOwned_)
+    {
+        barrierOwned_ = false;
+        device()->barrier_.notify();
+    }
+}
+
+SocketCanBatchWriteFlow::SocketCanBatchWriteFlow(FdHubPortService *dev)
+    : CanHubPort(dev)
+{
+    memset(msgs_, 0, sizeof(msgs_));
+    for (unsigned i = 0; i < BATCH_SIZE; ++i)
+    {
+        msgs_[i].msg_hdr.msg_iov = &iov_[i];
+        msgs_[i].msg_hdr.msg_iovlen = 1;
+    }
+}
+
+SocketCanBatchWriteFlow::~SocketCanBatchWriteFlow()
+{
+    HASSERT(is_waiting());
+}
+
+void SocketCanBatchWriteFlow::shutdown()
+{
+    // The fd must be set to negative already to ensure the shutdown
+    // completes successfully.
+    HASSERT(device()->fd() < 0);
+    auto *e = service()->executor();
+    if (!selectHelper_.is_empty() && e->is_selected(&selectHelper_))
+    {
+        e->unselect(&selectHelper_);
+        // The next try_write will see the closed fd and drop the batch.
+        notify();
+    }
+}
+
+void SocketCanBatchWriteFlow::add_frame(Buffer<CanHubData> *b)
+{
+    bufs_[numFrames_] = b;
+    iov_[numFrames_].iov_base = b->data()->mutable_frame();
+    iov_[numFrames_].iov_len = sizeof(struct can_frame);
+    ++numFrames_;
+}
+
+StateFlowBase::Action SocketCanBatchWriteFlow::entry()
+{
+    if (device()->fd() < 0)
+    {
+        return release_and_exit();
+    }
+    numFrames_ = 0;
+    numSent_ = 0;
+    add_frame(message());
+    {
+        // Takes the frames that queued up while we were busy.
+        AtomicHolder h(this);
+        unsigned prio;
+        while (numFrames_ < BATCH_SIZE)
+        {
+            QMember *m = queue_next(&prio);
+            if (!m)
+            {
+                break;
+            }
+            add_frame(static_cast<Buffer<CanHubData> *>(m));
+        }
+    }
+    return call_immediately(STATE(try_write));
+}
+
+StateFlowBase::Action SocketCanBatchWriteFlow::try_write()
+{
+    int fd = device()->fd();
+    if (fd < 0)
+    {
+        return call_immediately(STATE(write_done));
+    }
+    int ret =
+        ::sendmmsg(fd, msgs_ + numSent_, numFrames_ - numSent_, MSG_DONTWAIT);
+    if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+    {
+        selectHelper_.reset(Selectable::WRITE, fd, priority());
+        service()->executor()->select(&selectHelper_);
+        return wait();
+    }
+    if (ret < 0)
+    {
+        device()->report_write_error();
+        return call_immediately(STATE(write_done));
+    }
+    ++numWrites_;
+    numSent_ += ret;
+    numFramesWritten_ += ret;
+    if (numSent_ < numFrames_)
+    {
+        return again();
+    }
+    return call_immediately(STATE(write_done));
+}
+
+StateFlowBase::Action SocketCanBatchWriteFlow::write_done()
+{
+    // The first buffer is the current message, released by release().
+    for (unsigned i = 1; i < numFrames_; ++i)
+    {
+        bufs_[i]->unref();
+    }
+    numFrames_ = 0;
+    return release_and_exit();
+}
+
+#endif // __linux__ && OPENMRN_FEATURE_EXECUTOR_SELECT
@@ -0,0 +1,196 @@
+/** \copyright
+ * Copyright (c) 2026, Balazs Racz
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are  permitted provided that the following conditions are met:
+ *
+ *  - Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  - Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file SocketCanBatch.hxx
+ *
+ * Hub port for SocketCan devices that transfers many CAN frames per system
+ * call.
+ *
+ * @author Balazs Racz
+ * @date 17 Oct 2026
+ */
+
+#ifndef _UTILS_SOCKETCANBATCH_HXX_
+#define _UTILS_SOCKETCANBATCH_HXX_
+
+#include "utils/HubDeviceSelect.hxx"
+
+#if defined(__linux__) && defined(OPENMRN_FEATURE_EXECUTOR_SELECT)
+
+#include <sys/socket.h>
+
+/// Read flow for HubDeviceSelect on CAN-typed hubs. Uses recvmmsg to read all
+/// the frames that are pending in the socket (up to BATCH_SIZE) in one system
+/// call, then sends them to the hub in a burst. The fd has to be a datagram
+/// socket that returns one struct can_frame per message, such as a SocketCan
+/// raw socket.
+class SocketCanBatchReadFlow : public StateFlowBase
+{
+public:
+    /// How many frames we read with one system call.
+    static constexpr unsigned BATCH_SIZE = 32;
+
+    /// Constructor.
+    ///
+    /// @param device parent object.
+    /// @param dst where to send the incoming frames.
+    /// @param skip_member the incoming frames will not be sent back to this
+    /// port (the write flow of the device).
+    SocketCanBatchReadFlow(FdHubPortService *device, CanHubPortInterface *dst,
+        CanHubPortInterface *skip_member);
+
+    /// Unregisters the current flow from the hub. Must be called on the main
+    /// executor.
+    void shutdown();
+
+    /// @return the parent object.
+    FdHubPortService *device()
+    {
+        return static_cast<FdHubPortService *>(service());
+    }
+
+    /// @return how many system calls returned data. For statistics.
+    unsigned num_reads()
+    {
+        return numReads_;
+    }
+
+    /// @return how many frames were read.
+    unsigned num_frames()
+    {
+        return numFrames_;
+    }
+
+private:
+    /// Reads all the frames that the kernel has for us. @return next state.
+    Action try_read();
+
+    /// Stops the flow due to an error or EOF. @return next state.
+    Action read_error();
+
+    /** Calls into the parent flow's barrier notify, but makes sure to
+     * only do this once in the lifetime of *this. */
+    void notify_barrier();
+
+    /// true iff pending parent->barrier_.notify()
+    bool barrierOwned_ {true};
+    /// Helper object for waiting for the fd to become readable.
+    StateFlowSelectHelper selectHelper_ {this};
+    /// Where do we forward the frames we read.
+    CanHubPortInterface *dst_;
+    /// What should be the source port designation.
+    CanHubPortInterface *skipMember_;
+    /// Statistics: number of successful recvmmsg calls.
+    unsigned numReads_ {0};
+    /// Statistics: number of frames read.
+    unsigned numFrames_ {0};
+    /// Target memory for the frames.
+    struct can_frame frames_[BATCH_SIZE];
+    /// One buffer descriptor for each frame.
+    struct iovec iov_[BATCH_SIZE];
+    /// One message descriptor for each frame.
+    struct mmsghdr msgs_[BATCH_SIZE];
+};
+
+/// Write flow for HubDeviceSelect on CAN-typed hubs. When it gets a frame to
+/// write, takes all further frames that are waiting in the queue (up to
+/// BATCH_SIZE), and writes them with a single sendmmsg call.
+class SocketCanBatchWriteFlow : public CanHubPort
+{
+public:
+    /// How many frames we write with one system call.
+    static constexpr unsigned BATCH_SIZE = 32;
+
+    /// Constructor. @param dev is the parent object.
+    SocketCanBatchWriteFlow(FdHubPortService *dev);
+
+    /// Destructor.
+    ~SocketCanBatchWriteFlow();
+
+    /// Wakes up the flow if it is waiting for the fd. Must be called on the
+    /// main executor after the fd was closed.
+    void shutdown();
+
+    /// @return parent object.
+    FdHubPortService *device()
+    {
+        return static_cast<FdHubPortService *>(service());
+    }
+
+    /// @return how many system calls were made to write data. For
+    /// statistics.
+    unsigned num_writes()
+    {
+        return numWrites_;
+    }
+
+    /// @return how many frames were written.
+    unsigned num_frames()
+    {
+        return numFramesWritten_;
+    }
+
+private:
+    Action entry() override;
+
+    /// Sends the pending frames to the fd. @return next state.
+    Action try_write();
+
+    /// Releases all buffers of the batch. @return next state.
+    Action write_done();
+
+    /// Adds a buffer to the current batch.
+    /// @param b buffer with a frame to write. Ownership is transferred.
+    void add_frame(Buffer<CanHubData> *b);
+
+    /// Helper object for waiting for the fd to become writable.
+    StateFlowSelectHelper selectHelper_ {this};
+    /// How many frames are in the current batch.
+    unsigned numFrames_ {0};
+    /// How many frames of the current batch were written already.
+    unsigned numSent_ {0};
+    /// Statistics: number of sendmmsg calls.
+    unsigned numWrites_ {0};
+    /// Statistics: number of frames written.
+    unsigned numFramesWritten_ {0};
+    /// The buffers of the current batch. The first one is the current
+    /// message() of the flow, the others are owned by us.
+    Buffer<CanHubData> *bufs_[BATCH_SIZE];
+    /// One buffer descriptor for each frame.
+    struct iovec iov_[BATCH_SIZE];
+    /// One message descriptor for each frame.
+    struct mmsghdr msgs_[BATCH_SIZE];
+};
+
+/// Hub port for a SocketCan device that reads and writes multiple frames per
+/// system call. Usage is the same as HubDeviceSelect<CanHubFlow>.
+typedef HubDeviceSelect<CanHubFlow, SocketCanBatchReadFlow,
+    SocketCanBatchWriteFlow>
+    SocketCanBatchPort;
+
+#endif // __linux__ && OPENMRN_FEATURE_EXECUTOR_SELECT
+
+#endif // _UTILS_SOCKETCANBATCH_HXX_
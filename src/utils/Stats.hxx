@@ -35,11 +35,14 @@
 #ifndef _UTILS_STATS_HXX_
 #define _UTILS_STATS_HXX_
 
+#include <atomic>
 #include <math.h>
 #include <stdint.h>
 #include <string>
 #include <limits>
 
+#include "utils/StringPrintf.hxx"
+
 class Stats
 {
 public:
@@ -108,4 +111,246 @@ private:
     FloatType qsum_;
 };
 
+#if __GCC_ATOMIC_INT_LOCK_FREE == 2
+/// Counter type of the Histogram. Lock-free atomic where the target supports
+/// it.
+using HistogramCounter = std::atomic<uint32_t>;
+#else
+/// Counter type of the Histogram on targets without lock-free atomic
+/// read-modify-write instructions (e.g. Cortex-M0). Has the subset of the
+/// std::atomic API that the Histogram uses, but is not thread-safe.
+class HistogramCounter
+{
+public:
+    uint32_t load(std::memory_order) const
+    {
+        return v_;
+    }
+
+    void store(uint32_t v, std::memory_order)
+    {
+        v_ = v;
+    }
+
+    uint32_t fetch_add(uint32_t d, std::memory_order)
+    {
+        uint32_t old = v_;
+        v_ += d;
+        return old;
+    }
+
+    bool compare_exchange_weak(
+        uint32_t &expected, uint32_t desired, std::memory_order)
+    {
+        if (v_ != expected)
+        {
+            expected = v_;
+            return false;
+        }
+        v_ = desired;
+        return true;
+    }
+
+private:
+    uint32_t v_;
+};
+#endif
+
+/// Fixed-memory histogram with logarithmic buckets, for measuring latency
+/// distributions (percentiles). The bucket layout is log-linear (similar to
+/// HdrHistogram): values below 2^SUB_BITS each have their own bucket, and
+/// every further power of two range is split into 2^SUB_BITS equal
+/// buckets. This means the percentiles are reported with a relative error of
+/// at most 2^-SUB_BITS, independent of the magnitude of the value.
+///
+/// Recording a value is lock-free and can be done from multiple threads
+/// concurrently, if the target has lock-free atomics. On targets without
+/// those (e.g. Cortex-M0) the counters are plain integers, and add() must
+/// only be called from a single thread. Queries are not synchronized with concurrent recording;
+/// they may or may not see the values being added at that time.
+///
+/// Two histograms of the same type can be merged (e.g. per-thread histograms
+/// into one for reporting).
+///
+/// @param SUB_BITS defines the precision. Each power of two range is split
+/// into 2^SUB_BITS buckets.
+/// @param VALUE_BITS defines the range of values. Values at or above
+/// 2^VALUE_BITS are counted in the last bucket.
+template <unsigned SUB_BITS = 4, unsigned VALUE_BITS = 32> class Histogram
+{
+public:
+    using ValueType = uint32_t;
+    using FloatType = double;
+
+    static_assert(SUB_BITS >= 1 && SUB_BITS < VALUE_BITS, "invalid SUB_BITS");
+    static_assert(VALUE_BITS <= 32, "invalid VALUE_BITS");
+
+    /// Number of buckets in each power of two range.
+    static constexpr unsigned SUB_COUNT = 1u << SUB_BITS;
+    /// Total number of buckets.
+    static constexpr unsigned NUM_BUCKETS =
+        (VALUE_BITS - SUB_BITS + 1) * SUB_COUNT;
+
+    Histogram()
+    {
+        clear();
+    }
+
+    /// Clears all data points. Not atomic with respect to concurrent add()
+    /// calls.
+    void clear()
+    {
+        for (auto &b : buckets_)
+        {
+            b.store(0, std::memory_order_relaxed);
+        }
+        count_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    /// Appends a data point. Thread-safe and lock-free where the target has
+    /// lock-free atomics, see HistogramCounter.
+    /// @param value the data point.
+    void add(ValueType value)
+    {
+        buckets_[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        ValueType m = max_.load(std::memory_order_relaxed);
+        while (value > m &&
+            !max_.compare_exchange_weak(m, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /// Adds all data points of another histogram to this one.
+    /// @param other histogram to merge into this.
+    void merge(const Histogram &other)
+    {
+        for (unsigned i = 0; i < NUM_BUCKETS; ++i)
+        {
+            uint32_t c = other.buckets_[i].load(std::memory_order_relaxed);
+            if (c)
+            {
+                buckets_[i].fetch_add(c, std::memory_order_relaxed);
+            }
+        }
+        count_.fetch_add(
+            other.count_.load(std::memory_order_relaxed),
+            std::memory_order_relaxed);
+        ValueType om = other.max();
+        ValueType m = max_.load(std::memory_order_relaxed);
+        while (om > m &&
+            !max_.compare_exchange_weak(m, om, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /// @return the number of data points added.
+    uint32_t count() const
+    {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+    /// @return the largest data point added, 0 if empty.
+    ValueType max() const
+    {
+        return max_.load(std::memory_order_relaxed);
+    }
+
+    /// Computes a percentile.
+    /// @param p is the percentile in the range 0..100, e.g. 99.9.
+    /// @return the value below or at which p percent of the data points
+    /// are. The result is the highest value that falls into the same bucket
+    /// as the real percentile (but no more than max()). Returns 0 if the
+    /// histogram is empty.
+    ValueType percentile(FloatType p) const
+    {
+        uint32_t total = count();
+        if (!total)
+        {
+            return 0;
+        }
+        // Rank of the data point we are looking for (1-based). The epsilon
+        // avoids rounding up p99.9 of 1000 samples to the 1000th.
+        uint64_t rank = (uint64_t)ceil(p / 100 * total - 1e-6);
+        if (rank < 1)
+        {
+            rank = 1;
+        }
+        uint64_t seen = 0;
+        for (unsigned i = 0; i < NUM_BUCKETS; ++i)
+        {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen >= rank)
+            {
+                ValueType v = bucket_max(i);
+                return v < max() ? v : max();
+            }
+        }
+        return max();
+    }
+
+    /// Creates a single-line printout of this histogram for debug purposes.
+    /// @param unit is printed after the values.
+    std::string debug_string(const char *unit = "") const
+    {
+        return StringPrintf("p50 %u%s p90 %u%s p99 %u%s p99.9 %u%s max %u%s "
+                            "(%u samples)",
+            (unsigned)percentile(50), unit, (unsigned)percentile(90), unit,
+            (unsigned)percentile(99), unit, (unsigned)percentile(99.9), unit,
+            (unsigned)max(), unit, (unsigned)count());
+    }
+
+    /// @param value a data point.
+    /// @return the index of the bucket that counts this value.
+    static unsigned bucket_index(ValueType value)
+    {
+        if (value < SUB_COUNT)
+        {
+            return value;
+        }
+        // Position of the highest set bit, >= SUB_BITS.
+        unsigned msb = 31 - __builtin_clz(value);
+        if (msb >= VALUE_BITS)
+        {
+            return NUM_BUCKETS - 1;
+        }
+        unsigned group = msb - SUB_BITS + 1;
+        unsigned sub = (value >> (msb - SUB_BITS)) & (SUB_COUNT - 1);
+        return group * SUB_COUNT + sub;
+    }
+
+    /// @param index a bucket index.
+    /// @return the smallest value that is counted in this bucket.
+    static ValueType bucket_min(unsigned index)
+    {
+        unsigned group = index / SUB_COUNT;
+        unsigned sub = index % SUB_COUNT;
+        if (group == 0)
+        {
+            return sub;
+        }
+        return ((ValueType)(SUB_COUNT + sub)) << (group - 1);
+    }
+
+    /// @param index a bucket index.
+    /// @return the largest value that is counted in this bucket.
+    static ValueType bucket_max(unsigned index)
+    {
+        if (index >= NUM_BUCKETS - 1)
+        {
+            return std::numeric_limits<ValueType>::max();
+        }
+        return bucket_min(index + 1) - 1;
+    }
+
+private:
+    /// Number of data points in each bucket.
+    HistogramCounter buckets_[NUM_BUCKETS];
+    /// Total number of data points.
+    HistogramCounter count_;
+    /// Largest data point.
+    HistogramCounter max_;
+};
+
 #endif // _UTILS_STATS_HXX_
@@ -85,6 +85,30 @@
  * vs the overhead used by the framework.
  */
 
+/** @var _sym_executor_select_backend
+ *
+ * @brief Selects the kernel facility the executors use to wait for
+ * Selectables. 0 is the portable select() call, 1 is level-triggered epoll, 2
+ * is edge-triggered epoll (Linux only). epoll scales with the number of ready
+ * file descriptors instead of the number of watched ones, which matters for
+ * hubs with many TCP clients.
+ */
+
+/** @var _sym_executor_timer_wheel
+ *
+ * @brief If 1, the executors keep the scheduled timers in a hierarchical
+ * timing wheel (host platforms only). Scheduling, updating and cancelling a
+ * timer is then constant time instead of linear in the number of active
+ * timers.
+ */
+
+/** @var _sym_buffer_thread_cache_size
+ *
+ * @brief How many free buffers per size bucket each thread may keep in its
+ * private cache of the main buffer pool (Linux and Mac only). 0 disables the
+ * caches; all allocations then go to the shared buckets.
+ */
+
 /** @var _sym_can_tx_buffer_size
  * @brief default software buffer size for CAN transmission
  */
@@ -131,6 +155,10 @@ DEFAULT_CONST(main_thread_priority, 0xdefa01);
 DEFAULT_CONST(main_thread_stack_size, 2048);
 DEFAULT_CONST(executor_max_sleep_msec, 40);
 DEFAULT_CONST(executor_select_prescaler, 5);
+DEFAULT_CONST(executor_select_backend, 0);
+DEFAULT_CONST(executor_timer_wheel, 0);
+DEFAULT_CONST(executor_profile, 0);
+DEFAULT_CONST(buffer_thread_cache_size, 0);
 
 DEFAULT_CONST(can_tx_buffer_size, 16);
 DEFAULT_CONST(can_rx_buffer_size, 16);
@@ -164,6 +192,10 @@ DEFAULT_CONST(directhub_port_incoming_buffer_size, 1460);
 // how many 1460-byte packets per port we parse before waiting for output to
 // drain.
 DEFAULT_CONST(directhub_port_max_incoming_packets, 2);
+// How much data one source may push through the hub before it has to let the
+// other sources have their turn. About a third of an incoming buffer.
+DEFAULT_CONST(directhub_source_byte_budget, 512);
+DEFAULT_CONST(directhub_source_packet_budget, 16);
 
 #ifdef ESP_PLATFORM
 /// Use a stack size of 3kb for SocketListener tasks.
@@ -40,44 +40,82 @@
 
 extern "C" {
 
-/** Build an ASCII character representation of a nibble value (uppercase hex).
- * @param nibble to convert
- * @return converted value
- */
-static char nibble_to_ascii(int nibble)
-{
-    nibble &= 0xf;
+/// Value of each ASCII character as a hex digit, or -1 if the character is
+/// not a (lowercase or uppercase) hex digit.
+static const int8_t HEX_TO_NIBBLE[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+    -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
 
-    if (nibble < 10)
-    {
-        return ('0' + nibble);
-    }
-    
-    return ('A' + (nibble - 10));
-}
+/// Uppercase hex representation of every byte value. Each entry is two
+/// characters, there are no terminating zeros.
+static const char BYTE_TO_HEX[] =
+    "00""01""02""03""04""05""06""07"
+    "08""09""0A""0B""0C""0D""0E""0F"
+    "10""11""12""13""14""15""16""17"
+    "18""19""1A""1B""1C""1D""1E""1F"
+    "20""21""22""23""24""25""26""27"
+    "28""29""2A""2B""2C""2D""2E""2F"
+    "30""31""32""33""34""35""36""37"
+    "38""39""3A""3B""3C""3D""3E""3F"
+    "40""41""42""43""44""45""46""47"
+    "48""49""4A""4B""4C""4D""4E""4F"
+    "50""51""52""53""54""55""56""57"
+    "58""59""5A""5B""5C""5D""5E""5F"
+    "60""61""62""63""64""65""66""67"
+    "68""69""6A""6B""6C""6D""6E""6F"
+    "70""71""72""73""74""75""76""77"
+    "78""79""7A""7B""7C""7D""7E""7F"
+    "80""81""82""83""84""85""86""87"
+    "88""89""8A""8B""8C""8D""8E""8F"
+    "90""91""92""93""94""95""96""97"
+    "98""99""9A""9B""9C""9D""9E""9F"
+    "A0""A1""A2""A3""A4""A5""A6""A7"
+    "A8""A9""AA""AB""AC""AD""AE""AF"
+    "B0""B1""B2""B3""B4""B5""B6""B7"
+    "B8""B9""BA""BB""BC""BD""BE""BF"
+    "C0""C1""C2""C3""C4""C5""C6""C7"
+    "C8""C9""CA""CB""CC""CD""CE""CF"
+    "D0""D1""D2""D3""D4""D5""D6""D7"
+    "D8""D9""DA""DB""DC""DD""DE""DF"
+    "E0""E1""E2""E3""E4""E5""E6""E7"
+    "E8""E9""EA""EB""EC""ED""EE""EF"
+    "F0""F1""F2""F3""F4""F5""F6""F7"
+    "F8""F9""FA""FB""FC""FD""FE""FF";
 
 /** Tries to parse a hex character to a nibble. Understands both upper and
     lowercase hex.
     @param c is the character to convert.
     @return a converted value, or -1 if an invalid character was encountered.
 */
-static int ascii_to_nibble(const char c)
+static inline int ascii_to_nibble(const char c)
 {
-    if ('0' <= c && '9' >= c)
-    {
-        return c - '0';
-    }
-    else if ('A' <= c && 'F' >= c)
-    {
-        return c - 'A' + 10;
-    }
-    else if ('a' <= c && 'f' >= c)
-    {
-        return c - 'a' + 10;
-    }
-    return -1;
+    return HEX_TO_NIBBLE[(uint8_t)c];
 }
 
+/// Appends the two hex characters of a byte to a buffer.
+/// @param dst buffer to append data to; will be advanced by two.
+/// @param value byte to format.
+static inline void output_hex_byte(char *&dst, uint8_t value)
+{
+    const char *hex = BYTE_TO_HEX + 2 * value;
+    *dst++ = hex[0];
+    *dst++ = hex[1];
+}
 
 int gc_format_parse(const char* buf, struct can_frame* can_frame)
 {
@@ -102,36 +140,31 @@ int gc_format_parse(const char* buf, struct can_frame* can_frame)
     }
     buf++;
     uint32_t id = 0;
-    while (1)
+    int nibble;
+    while ((nibble = ascii_to_nibble(*buf)) >= 0)
     {
-        int nibble = ascii_to_nibble(*buf);
-        if (nibble >= 0)
-        {
-            id <<= 4;
-            id |= nibble;
-            ++buf;
-        }
-        else if (*buf == 'N')
-        {
-            // end of ID, frame is coming.
-            CLR_CAN_FRAME_RTR(*can_frame);
-            ++buf;
-            break;
-        }
-        else if (*buf == 'R')
-        {
-            // end of ID, remote frame is coming.
-            SET_CAN_FRAME_RTR(*can_frame);
-            ++buf;
-            break;
-        }
-        else
-        {
-            // This character should not happen here.
-            SET_CAN_FRAME_ERR(*can_frame);
-            return -1;
-        }
-    } // while parsing ID
+        id <<= 4;
+        id |= nibble;
+        ++buf;
+    }
+    if (*buf == 'N')
+    {
+        // end of ID, frame is coming.
+        CLR_CAN_FRAME_RTR(*can_frame);
+        ++buf;
+    }
+    else if (*buf == 'R')
+    {
+        // end of ID, remote frame is coming.
+        SET_CAN_FRAME_RTR(*can_frame);
+        ++buf;
+    }
+    else
+    {
+        // This character should not happen here.
+        SET_CAN_FRAME_ERR(*can_frame);
+        return -1;
+    }
     if (IS_CAN_FRAME_EFF(*can_frame))
     {
         SET_CAN_FRAME_ID_EFF(*can_frame, id);
@@ -143,40 +176,71 @@ int gc_format_parse(const char* buf, struct can_frame* can_frame)
     int index = 0;
     while ((*buf != 0) && (*buf != ';'))
     {
-        int nh = ascii_to_nibble(*buf++);
-        int nl = ascii_to_nibble(*buf++);
-        if (nh < 0 || nl < 0)
+        int nh = ascii_to_nibble(buf[0]);
+        if (nh < 0)
+        {
+            SET_CAN_FRAME_ERR(*can_frame);
+            return -1;
+        }
+        // If buf[0] is a hex digit, then buf[1] is still within the string.
+        int nl = ascii_to_nibble(buf[1]);
+        if (nl < 0 || index >= 8)
         {
             SET_CAN_FRAME_ERR(*can_frame);
             return -1;
         }
         can_frame->data[index++] = (nh << 4) | nl;
+        buf += 2;
     } // while parsing data
     can_frame->can_dlc = index;
     CLR_CAN_FRAME_ERR(*can_frame);
     return 0;
 }
 
-/// Helper function for appending to a buffer ONCE.
-///
-/// @param dst buffer to append data to
-/// @param value one character to append to.
-///
-static void output_single(char*& dst, char value)
-{
-    *dst++ = value;
-}
+/** Formats a can frame in the single-byte GridConnect protocol. Does not
+    check for error frames.
 
-/// Helper function for appending to a buffer TWICE. Used in the implementation
-/// of the double-byte gridconnect output protocol.
-///
-/// @param dst buffer to append data to
-/// @param value one character to append to.
-///
-static void output_double(char*& dst, char value)
+    @param can_frame is the input frame.
+    @param buf is the output buffer, must have at least GC_FORMAT_MAX_LENGTH
+    bytes.
+    @param newline if true, a newline character is appended.
+    @return the pointer to the buffer character after the formatted can frame.
+*/
+static char *gc_format_generate_single(
+    const struct can_frame *can_frame, char *buf, bool newline)
 {
-    *dst++ = value;
-    *dst++ = value;
+    *buf++ = ':';
+    if (IS_CAN_FRAME_EFF(*can_frame))
+    {
+        uint32_t id = GET_CAN_FRAME_ID_EFF(*can_frame);
+        *buf++ = 'X';
+        output_hex_byte(buf, id >> 24);
+        output_hex_byte(buf, id >> 16);
+        output_hex_byte(buf, id >> 8);
+        output_hex_byte(buf, id);
+    }
+    else
+    {
+        uint32_t id = GET_CAN_FRAME_ID(*can_frame);
+        *buf++ = 'S';
+        // Standard frames have 11 bit IDs, which are printed as 3 digits.
+        *buf++ = BYTE_TO_HEX[2 * ((id >> 8) & 0xf) + 1];
+        output_hex_byte(buf, id);
+    }
+    /* handle remote or normal */
+    *buf++ = IS_CAN_FRAME_RTR(*can_frame) ? 'R' : 'N';
+    // A malformed length must not overrun the output buffer.
+    int dlc = can_frame->can_dlc > 8 ? 8 : can_frame->can_dlc;
+    for (int i = 0; i < dlc; ++i)
+    {
+        output_hex_byte(buf, can_frame->data[i]);
+    }
+    *buf++ = ';';
+    if (newline)
+    {
+        *buf++ = '\n';
+    }
+    return buf;
 }
 
 /** Formats a can frame in the GridConnect protocol.
@@ -203,55 +267,39 @@ char* gc_format_generate(const struct can_frame* can_frame, char* buf, int doubl
         LOG(VERBOSE, "GC generate: incoming frame ERR.");
         return buf;
     }
-    void (*output)(char*& dst, char value);
-    if (double_format)
-    {
-        output = output_double;
-        output(buf, '!');
-    }
-    else
-    {
-        output = output_single;
-        output(buf, ':');
-    }
-    uint32_t id;
-    int offset;
-    if (IS_CAN_FRAME_EFF(*can_frame))
-    {
-        id = GET_CAN_FRAME_ID_EFF(*can_frame);
-        output(buf, 'X');
-        offset = 28;
-    }
-    else
-    {
-        id = GET_CAN_FRAME_ID(*can_frame);
-        output(buf, 'S');
-        offset = 8;
-    }
-    for (;offset >= 0; offset -= 4)
-    {
-        output(buf, nibble_to_ascii((id >> offset) & 0xf));
-    }
-    /* handle remote or normal */
-    if (IS_CAN_FRAME_RTR(*can_frame))
-    {
-        output(buf, 'R');
-    }
-    else
+    bool newline = config_gc_generate_newlines() == CONSTANT_TRUE;
+    if (!double_format)
     {
-        output(buf, 'N');
+        return gc_format_generate_single(can_frame, buf, newline);
     }
-    for (offset = 0; offset < can_frame->can_dlc; ++offset)
+    char single[GC_FORMAT_MAX_LENGTH];
+    char *end = gc_format_generate_single(can_frame, single, newline);
+    single[0] = '!';
+    for (char *p = single; p < end; ++p)
     {
-        output(buf, nibble_to_ascii(can_frame->data[offset] >> 4));
-        output(buf, nibble_to_ascii(can_frame->data[offset] & 0xf));
+        *buf++ = *p;
+        *buf++ = *p;
     }
-    output(buf, ';');
-    if (config_gc_generate_newlines() == CONSTANT_TRUE)
+    return buf;
+}
+
+unsigned gc_format_generate_batch(const struct can_frame *frames,
+    unsigned num_frames, char *buf, size_t buf_size, size_t *out_len)
+{
+    bool newline = config_gc_generate_newlines() == CONSTANT_TRUE;
+    char *p = buf;
+    char *end = buf + buf_size;
+    unsigned i;
+    for (i = 0; i < num_frames && end - p >= GC_FORMAT_MAX_LENGTH; ++i)
     {
-        output(buf, '\n');
+        if (IS_CAN_FRAME_ERR(frames[i]))
+        {
+            continue;
+        }
+        p = gc_format_generate_single(frames + i, p, newline);
     }
-    return buf;
+    *out_len = p - buf;
+    return i;
 }
 
 }
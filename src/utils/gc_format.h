@@ -34,6 +34,8 @@
 #ifndef _UTILS_GC_FORMAT_H_
 #define _UTILS_GC_FORMAT_H_
 
+#include <stddef.h>
+
 #include "utils/constants.hxx"
 
 #ifdef __cplusplus
@@ -42,6 +44,10 @@ extern "C" {
 
 struct can_frame;
 
+/// Maximum number of characters that a single (not doubled) gridconnect
+/// packet takes, including the trailing newline.
+#define GC_FORMAT_MAX_LENGTH 29
+
 /// Whether gridconnect format should create newline characters at the end of
 /// packets.
 DECLARE_CONST(gc_generate_newlines);
@@ -79,6 +85,26 @@ int gc_format_parse(const char* buf, struct can_frame* can_frame);
 */
 char* gc_format_generate(const struct can_frame* can_frame, char* buf, int double_format);
 
+/** Formats a sequence of can frames in the (single byte) GridConnect protocol
+    into a contiguous buffer. Error frames are skipped.
+
+    @param frames is the array of input frames.
+
+    @param num_frames is how many entries frames has.
+
+    @param buf is the output buffer.
+
+    @param buf_size is the number of bytes available in buf. Formatting stops
+    when there is less than GC_FORMAT_MAX_LENGTH space left.
+
+    @param out_len will be set to the number of bytes written to buf.
+
+    @return the number of frames that were consumed from the input. This is
+    less than num_frames if the output buffer became full.
+*/
+unsigned gc_format_generate_batch(const struct can_frame *frames,
+    unsigned num_frames, char *buf, size_t buf_size, size_t *out_len);
+
 #ifdef __cplusplus
 }
 #endif